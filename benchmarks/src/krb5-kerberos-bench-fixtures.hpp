@@ -0,0 +1,138 @@
+/**
+ * @file krb5-kerberos-bench-fixtures.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_BENCH_FIXTURES_HPP_
+#define KRB5_KERBEROS_BENCH_FIXTURES_HPP_
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-serializer.hpp"
+#include <krb5/krb5.h>
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr const auto BENCH_TICKET_SIZE = 1536;
+constexpr const auto BENCH_PAC_SIZE = 1024;
+constexpr const auto BENCH_AES256_KEY_SIZE = 32;
+constexpr const auto BENCH_AES256_ENCTYPE = 18;
+constexpr const auto BENCH_AD_IF_RELEVANT = 1;
+} // namespace
+
+namespace octo::kerberos::krb5::bench
+{
+// All synthetic creds are allocated with malloc so they can be released with krb5_free_cred_contents
+inline void fill_random(void* buffer, std::size_t size, std::uint32_t seed)
+{
+    std::mt19937 generator(seed);
+    auto bytes = static_cast<unsigned char*>(buffer);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        bytes[i] = static_cast<unsigned char>(generator());
+    }
+}
+
+inline krb5_data make_data(const std::string& str)
+{
+    krb5_data data{};
+    data.magic = KV5M_DATA;
+    data.length = str.size();
+    data.data = static_cast<char*>(malloc(str.size() + 1));
+    std::memcpy(data.data, str.c_str(), str.size() + 1);
+    return data;
+}
+
+inline krb5_data make_random_data(std::size_t size, std::uint32_t seed)
+{
+    krb5_data data{};
+    data.magic = KV5M_DATA;
+    data.length = size;
+    data.data = static_cast<char*>(malloc(size > 0 ? size : 1));
+    fill_random(data.data, size, seed);
+    return data;
+}
+
+inline krb5_principal make_principal(const std::vector<std::string>& components, const std::string& realm)
+{
+    auto principal = static_cast<krb5_principal>(calloc(1, sizeof(krb5_principal_data)));
+    principal->magic = KV5M_PRINCIPAL;
+    principal->realm = make_data(realm);
+    principal->length = components.size();
+    principal->data = static_cast<krb5_data*>(calloc(components.size(), sizeof(krb5_data)));
+    for (std::size_t i = 0; i < components.size(); ++i)
+    {
+        principal->data[i] = make_data(components[i]);
+    }
+    principal->type = components.size() > 1 ? 2 : 1;
+    return principal;
+}
+
+inline krb5_creds make_creds(const std::vector<std::string>& server_components,
+                             std::size_t ticket_size = BENCH_TICKET_SIZE,
+                             std::size_t pac_size = BENCH_PAC_SIZE)
+{
+    const std::string realm("EXAMPLE.COM");
+    const auto now = static_cast<krb5_timestamp>(
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    krb5_creds creds{};
+    creds.magic = KV5M_CREDS;
+    creds.client = make_principal({"bench-user"}, realm);
+    creds.server = make_principal(server_components, realm);
+    creds.keyblock.magic = KV5M_KEYBLOCK;
+    creds.keyblock.enctype = BENCH_AES256_ENCTYPE;
+    creds.keyblock.length = BENCH_AES256_KEY_SIZE;
+    creds.keyblock.contents = static_cast<krb5_octet*>(malloc(BENCH_AES256_KEY_SIZE));
+    fill_random(creds.keyblock.contents, BENCH_AES256_KEY_SIZE, 1);
+    creds.times.authtime = now;
+    creds.times.starttime = now;
+    creds.times.endtime = now + 10 * 60 * 60;
+    creds.times.renew_till = now + 7 * 24 * 60 * 60;
+    creds.ticket_flags = 0x40e10000;
+    creds.ticket = make_random_data(ticket_size, 2);
+    creds.second_ticket.magic = KV5M_DATA;
+    if (pac_size > 0)
+    {
+        creds.authdata = static_cast<krb5_authdata**>(calloc(2, sizeof(krb5_authdata*)));
+        creds.authdata[0] = static_cast<krb5_authdata*>(calloc(1, sizeof(krb5_authdata)));
+        creds.authdata[0]->magic = KV5M_AUTHDATA;
+        creds.authdata[0]->ad_type = BENCH_AD_IF_RELEVANT;
+        creds.authdata[0]->length = pac_size;
+        creds.authdata[0]->contents = static_cast<krb5_octet*>(malloc(pac_size));
+        fill_random(creds.authdata[0]->contents, pac_size, 3);
+    }
+    return creds;
+}
+
+inline krb5_creds make_tgt_creds()
+{
+    return make_creds({"krbtgt", "EXAMPLE.COM"});
+}
+
+inline krb5_creds make_service_creds()
+{
+    return make_creds({"HTTP", "web01.example.com"});
+}
+
+inline nlohmann::json make_tgt_json(const krb5_creds& creds)
+{
+    nlohmann::json j;
+    j["tgt_user"] = "bench-user@EXAMPLE.COM";
+    j["tgt_ticket"] = KRB5KerberosSerializer::serialize_creds(creds);
+    j["tgt_expiration"] = creds.times.endtime;
+    return j;
+}
+} // namespace octo::kerberos::krb5::bench
+
+#endif
@@ -0,0 +1,678 @@
+/**
+ * @file krb5-kerberos-load-harness.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-authenticator.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-ticket-prefetcher.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-trace.hpp"
+#include <nlohmann/json.hpp>
+#include <fmt/format.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+constexpr const auto LOAD_DEFAULT_REALM = "OCTO.LOAD";
+constexpr const auto LOAD_DEFAULT_PORT = 18888;
+constexpr const auto LOAD_DEFAULT_USERS = 16;
+constexpr const auto LOAD_DEFAULT_SERVICES = 4;
+constexpr const auto LOAD_DEFAULT_CONCURRENCY = 4;
+constexpr const auto LOAD_DEFAULT_ITERATIONS = 200;
+constexpr const auto LOAD_KDC_READY_TIMEOUT_MS = 10000;
+constexpr const auto LOAD_MASTER_PASSWORD = "octo-load-master";
+constexpr const auto LOAD_VERIFY_PREFETCH_LIFETIME_SECONDS = 10;
+constexpr const auto LOAD_VERIFY_PREFETCH_MARGIN_SECONDS = 8;
+
+using octo::kerberos::KerberosUserCredentials;
+using octo::kerberos::krb5::KRB5KerberosAuthenticator;
+using octo::kerberos::krb5::KRB5KerberosReplayKdcTransport;
+using octo::kerberos::krb5::KRB5KerberosTcpKdcTransport;
+using octo::kerberos::krb5::KRB5KerberosTicketPrefetcher;
+using octo::kerberos::krb5::KRB5KerberosTraceEvent;
+using octo::kerberos::krb5::KRB5KerberosTracer;
+using Clock = std::chrono::steady_clock;
+
+struct LoadOptions
+{
+    std::string realm = LOAD_DEFAULT_REALM;
+    std::uint32_t port = LOAD_DEFAULT_PORT;
+    std::size_t users = LOAD_DEFAULT_USERS;
+    std::size_t services = LOAD_DEFAULT_SERVICES;
+    std::size_t concurrency = LOAD_DEFAULT_CONCURRENCY;
+    std::size_t iterations = LOAD_DEFAULT_ITERATIONS;
+    std::string mode = "both";
+    std::string bin_dir;
+    std::string json_output;
+    std::string capture_dir;
+    bool keep_realm = false;
+    bool verify = false;
+};
+
+struct ExchangeSnapshot
+{
+    std::string tgt_ticket;
+    std::string tgt_key;
+    std::string service_ticket;
+    std::string service_key;
+    krb5_timestamp service_endtime = 0;
+
+    // The replayer clamps the reply end times to the replayed request, so a replay may only end earlier
+    bool replays(const ExchangeSnapshot& recorded) const
+    {
+        return tgt_ticket == recorded.tgt_ticket && tgt_key == recorded.tgt_key
+               && service_ticket == recorded.service_ticket && service_key == recorded.service_key
+               && service_endtime <= recorded.service_endtime;
+    }
+};
+
+struct LatencyReport
+{
+    std::size_t operations = 0;
+    std::size_t failures = 0;
+    double throughput = 0;
+    double p50_us = 0, p90_us = 0, p99_us = 0, p999_us = 0, max_us = 0;
+};
+
+std::string user_name(std::size_t index)
+{
+    return fmt::format("load-user-{}", index);
+}
+
+std::string user_password(std::size_t index)
+{
+    return fmt::format("load-password-{}", index);
+}
+
+std::string service_name(std::size_t index, const std::string& realm)
+{
+    return fmt::format("load-svc-{}/localhost@{}", index, realm);
+}
+
+std::string tool_path(const LoadOptions& options, const std::string& tool)
+{
+    return options.bin_dir.empty() ? tool : (std::filesystem::path(options.bin_dir) / tool).string();
+}
+
+bool parse_options(int argc, char** argv, LoadOptions* options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+        if (arg == "--realm")
+        {
+            options->realm = next();
+        }
+        else if (arg == "--port")
+        {
+            options->port = std::stoul(next());
+        }
+        else if (arg == "--users")
+        {
+            options->users = std::stoul(next());
+        }
+        else if (arg == "--services")
+        {
+            options->services = std::stoul(next());
+        }
+        else if (arg == "--concurrency")
+        {
+            options->concurrency = std::stoul(next());
+        }
+        else if (arg == "--iterations")
+        {
+            options->iterations = std::stoul(next());
+        }
+        else if (arg == "--mode")
+        {
+            options->mode = next();
+        }
+        else if (arg == "--bin-dir")
+        {
+            options->bin_dir = next();
+        }
+        else if (arg == "--json")
+        {
+            options->json_output = next();
+        }
+        else if (arg == "--capture")
+        {
+            options->capture_dir = next();
+        }
+        else if (arg == "--keep-realm")
+        {
+            options->keep_realm = true;
+        }
+        else if (arg == "--verify")
+        {
+            options->verify = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return options->users > 0 && options->services > 0 && options->concurrency > 0
+           && (options->mode == "direct" || options->mode == "streamlined" || options->mode == "both");
+}
+
+void write_realm_configuration(const LoadOptions& options, const std::filesystem::path& realm_dir)
+{
+    const auto listen = fmt::format("127.0.0.1:{}", options.port);
+    std::ofstream kdc_conf(realm_dir / "kdc.conf");
+    kdc_conf << "[kdcdefaults]\n"
+             << " kdc_listen = " << listen << "\n"
+             << " kdc_tcp_listen = " << listen << "\n"
+             << "[realms]\n"
+             << " " << options.realm << " = {\n"
+             << "  database_name = " << (realm_dir / "principal").string() << "\n"
+             << "  key_stash_file = " << (realm_dir / "stash").string() << "\n"
+             << "  acl_file = " << (realm_dir / "kadm5.acl").string() << "\n"
+             << "  kdc_listen = " << listen << "\n"
+             << "  kdc_tcp_listen = " << listen << "\n"
+             << "  max_life = 10h 0m 0s\n"
+             << "  supported_enctypes = aes256-cts-hmac-sha1-96:normal\n"
+             << " }\n"
+             << "[logging]\n"
+             << " kdc = FILE:" << (realm_dir / "kdc.log").string() << "\n";
+    std::ofstream krb5_conf(realm_dir / "krb5.conf");
+    krb5_conf << "[libdefaults]\n"
+              << " default_realm = " << options.realm << "\n"
+              << " dns_lookup_kdc = false\n"
+              << " dns_lookup_realm = false\n"
+              << "[realms]\n"
+              << " " << options.realm << " = {\n"
+              << "  kdc = " << listen << "\n"
+              << " }\n";
+    std::ofstream acl(realm_dir / "kadm5.acl");
+    acl << "*/admin@" << options.realm << " *\n";
+}
+
+void export_realm_environment(const std::filesystem::path& realm_dir)
+{
+    setenv("KRB5_CONFIG", (realm_dir / "krb5.conf").c_str(), 1);
+    setenv("KRB5_KDC_PROFILE", (realm_dir / "kdc.conf").c_str(), 1);
+}
+
+bool provision_realm(const LoadOptions& options)
+{
+    const auto create_cmd = fmt::format("{} create -s -r {} -P {} > /dev/null 2>&1",
+                                        tool_path(options, "kdb5_util"),
+                                        options.realm,
+                                        LOAD_MASTER_PASSWORD);
+    if (std::system(create_cmd.c_str()) != 0)
+    {
+        std::cerr << "Failed creating realm database using kdb5_util" << std::endl;
+        return false;
+    }
+    // A single kadmin.local session reading commands from stdin, one process per principal does not scale
+    const auto kadmin_cmd = fmt::format("{} -r {} > /dev/null 2>&1", tool_path(options, "kadmin.local"), options.realm);
+    auto kadmin = popen(kadmin_cmd.c_str(), "w");
+    if (!kadmin)
+    {
+        std::cerr << "Failed starting kadmin.local" << std::endl;
+        return false;
+    }
+    for (std::size_t i = 0; i < options.users; ++i)
+    {
+        fmt::print(kadmin, "addprinc -pw {} {}\n", user_password(i), user_name(i));
+    }
+    for (std::size_t i = 0; i < options.services; ++i)
+    {
+        fmt::print(kadmin, "addprinc -randkey {}\n", service_name(i, options.realm));
+    }
+    fmt::print(kadmin, "quit\n");
+    if (pclose(kadmin) != 0)
+    {
+        std::cerr << "Failed provisioning principals using kadmin.local" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool wait_for_kdc(std::uint32_t port)
+{
+    const auto deadline = Clock::now() + std::chrono::milliseconds(LOAD_KDC_READY_TIMEOUT_MS);
+    while (Clock::now() < deadline)
+    {
+        auto fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        const auto connected = connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        close(fd);
+        if (connected)
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return false;
+}
+
+pid_t start_kdc(const LoadOptions& options)
+{
+    const auto kdc_path = tool_path(options, "krb5kdc");
+    auto pid = fork();
+    if (pid == 0)
+    {
+        execlp(kdc_path.c_str(), kdc_path.c_str(), "-n", "-r", options.realm.c_str(), nullptr);
+        _exit(127);
+    }
+    return pid;
+}
+
+void stop_kdc(pid_t pid)
+{
+    if (pid > 0)
+    {
+        kill(pid, SIGTERM);
+        waitpid(pid, nullptr, 0);
+    }
+}
+
+LatencyReport summarize(std::vector<double>& latencies_us, std::size_t failures, double elapsed_seconds)
+{
+    LatencyReport report;
+    report.operations = latencies_us.size();
+    report.failures = failures;
+    report.throughput = elapsed_seconds > 0 ? latencies_us.size() / elapsed_seconds : 0;
+    if (latencies_us.empty())
+    {
+        return report;
+    }
+    std::sort(latencies_us.begin(), latencies_us.end());
+    auto percentile = [&](double p) {
+        const auto index = std::min(latencies_us.size() - 1, static_cast<std::size_t>(p * latencies_us.size()));
+        return latencies_us[index];
+    };
+    report.p50_us = percentile(0.5);
+    report.p90_us = percentile(0.9);
+    report.p99_us = percentile(0.99);
+    report.p999_us = percentile(0.999);
+    report.max_us = latencies_us.back();
+    return report;
+}
+
+nlohmann::json report_to_json(const LatencyReport& report)
+{
+    nlohmann::json j;
+    j["operations"] = report.operations;
+    j["failures"] = report.failures;
+    j["throughput"] = report.throughput;
+    j["p50_us"] = report.p50_us;
+    j["p90_us"] = report.p90_us;
+    j["p99_us"] = report.p99_us;
+    j["p999_us"] = report.p999_us;
+    j["max_us"] = report.max_us;
+    return j;
+}
+
+void print_report(const std::string& title, const LatencyReport& report)
+{
+    std::cout << fmt::format("{:<18} ops={:<8} failed={:<6} throughput={:>10.1f}/s p50={:>9.1f}us p90={:>9.1f}us "
+                             "p99={:>9.1f}us p99.9={:>9.1f}us max={:>9.1f}us",
+                             title,
+                             report.operations,
+                             report.failures,
+                             report.throughput,
+                             report.p50_us,
+                             report.p90_us,
+                             report.p99_us,
+                             report.p999_us,
+                             report.max_us)
+              << std::endl;
+}
+
+nlohmann::json run_load(const LoadOptions& options, bool streamlined)
+{
+    const auto mode_name = streamlined ? "streamlined" : "direct";
+    std::vector<std::vector<double>> as_latencies(options.concurrency), tgs_latencies(options.concurrency);
+    std::atomic<std::size_t> as_failures(0), tgs_failures(0);
+    std::vector<std::thread> workers;
+    const auto start = Clock::now();
+    for (std::size_t worker = 0; worker < options.concurrency; ++worker)
+    {
+        workers.emplace_back([&, worker]() {
+            // krb5 contexts are not thread safe, every worker owns its authenticator
+            KRB5KerberosAuthenticator::Settings settings{
+                options.realm, "127.0.0.1", options.port, fmt::format("load-{}-{}", mode_name, worker), streamlined};
+            if (streamlined && !options.capture_dir.empty())
+            {
+                settings.kdc_capture_path =
+                    (std::filesystem::path(options.capture_dir) / fmt::format("load-{}.okkr", worker)).string();
+            }
+            KRB5KerberosAuthenticator authenticator(settings);
+            if (!authenticator.initialize_authenticator())
+            {
+                as_failures += options.iterations;
+                return;
+            }
+            for (std::size_t i = 0; i < options.iterations; ++i)
+            {
+                const auto user_index = (worker * options.iterations + i) % options.users;
+                KerberosUserCredentials creds(
+                    user_name(user_index),
+                    std::make_unique<octo::encryption::SecureString>(user_password(user_index)));
+                auto as_start = Clock::now();
+                auto tgt = authenticator.generate_krb5_tgt(&creds);
+                auto as_end = Clock::now();
+                if (!tgt)
+                {
+                    ++as_failures;
+                    continue;
+                }
+                as_latencies[worker].push_back(std::chrono::duration<double, std::micro>(as_end - as_start).count());
+
+                auto tgs_start = Clock::now();
+                auto service_ticket = authenticator.generate_service_ticket(
+                    tgt.get(), service_name(i % options.services, options.realm));
+                auto tgs_end = Clock::now();
+                if (!service_ticket)
+                {
+                    ++tgs_failures;
+                    continue;
+                }
+                tgs_latencies[worker].push_back(std::chrono::duration<double, std::micro>(tgs_end - tgs_start).count());
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    const auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> as_all, tgs_all;
+    for (std::size_t worker = 0; worker < options.concurrency; ++worker)
+    {
+        as_all.insert(as_all.end(), as_latencies[worker].begin(), as_latencies[worker].end());
+        tgs_all.insert(tgs_all.end(), tgs_latencies[worker].begin(), tgs_latencies[worker].end());
+    }
+    const auto as_report = summarize(as_all, as_failures, elapsed);
+    const auto tgs_report = summarize(tgs_all, tgs_failures, elapsed);
+    print_report(fmt::format("{} AS", mode_name), as_report);
+    print_report(fmt::format("{} TGS", mode_name), tgs_report);
+
+    nlohmann::json j;
+    j["elapsed_seconds"] = elapsed;
+    j["as"] = report_to_json(as_report);
+    j["tgs"] = report_to_json(tgs_report);
+    return j;
+}
+
+std::string data_to_string(const krb5_data& data)
+{
+    return std::string(data.data, data.length);
+}
+
+std::string keyblock_to_string(const krb5_keyblock& keyblock)
+{
+    return std::string(reinterpret_cast<const char*>(keyblock.contents), keyblock.length);
+}
+
+// A single streamlined AS and TGS exchange, recorded from the kdc or replayed from the recording
+bool run_verify_exchange(const LoadOptions& options,
+                         const std::string& recording,
+                         bool replay,
+                         ExchangeSnapshot* snapshot)
+{
+    KRB5KerberosAuthenticator::Settings settings{
+        options.realm, "127.0.0.1", options.port, replay ? "verify-replay" : "verify-record", true};
+    if (replay)
+    {
+        // The replayer binds the recorded replies to the nonces and subkeys of the replayed requests
+        settings.kdc_transport_factory = [&recording]() {
+            return std::make_shared<KRB5KerberosReplayKdcTransport>(
+                recording,
+                std::chrono::microseconds(0),
+                std::make_unique<octo::encryption::SecureString>(user_password(0)));
+        };
+    }
+    else
+    {
+        settings.kdc_capture_path = recording;
+    }
+    KRB5KerberosAuthenticator authenticator(settings);
+    if (!authenticator.initialize_authenticator())
+    {
+        return false;
+    }
+    KerberosUserCredentials creds(user_name(0), std::make_unique<octo::encryption::SecureString>(user_password(0)));
+
+    auto tgt = authenticator.generate_krb5_tgt(&creds);
+    auto service_ticket =
+        tgt ? authenticator.generate_service_ticket(tgt.get(), service_name(0, options.realm)) : nullptr;
+    if (!service_ticket)
+    {
+        return false;
+    }
+
+    snapshot->tgt_ticket = data_to_string(tgt->krb_creds().ticket);
+    snapshot->tgt_key = keyblock_to_string(tgt->krb_creds().keyblock);
+    snapshot->service_ticket = data_to_string(service_ticket->krb_creds().ticket);
+    snapshot->service_key = keyblock_to_string(service_ticket->krb_creds().keyblock);
+    snapshot->service_endtime = service_ticket->krb_creds().times.endtime;
+    return true;
+}
+
+// Records an AS and TGS exchange against the kdc, replays it and expects the very same tickets and session keys
+bool verify_replay(const LoadOptions& options, const std::filesystem::path& realm_dir)
+{
+    const auto recording = (realm_dir / "verify.okkr").string();
+    ExchangeSnapshot recorded, replayed;
+    if (!run_verify_exchange(options, recording, false, &recorded))
+    {
+        std::cerr << "Failed recording the verification exchanges" << std::endl;
+        return false;
+    }
+    if (!run_verify_exchange(options, recording, true, &replayed))
+    {
+        std::cerr << "Failed authenticating from the replayed exchanges of " << recording << std::endl;
+        return false;
+    }
+    if (!replayed.replays(recorded))
+    {
+        std::cerr << "Replayed tickets differ from the recorded ones" << std::endl;
+        return false;
+    }
+    std::cout << "Replayed AS and TGS exchanges yield the recorded tickets" << std::endl;
+    return true;
+}
+
+// Makes a service ticket hot in a prefetcher and expects its refresh thread, whose authenticator never saw the tgt, to
+// replace it ahead of its expiry
+bool verify_prefetch(const LoadOptions& options)
+{
+    KRB5KerberosAuthenticator::Settings settings{options.realm, "127.0.0.1", options.port, "verify-prefetch", true};
+    KRB5KerberosAuthenticator authenticator(settings);
+    KerberosUserCredentials creds(user_name(0), std::make_unique<octo::encryption::SecureString>(user_password(0)));
+    auto tgt = authenticator.initialize_authenticator() ? authenticator.generate_krb5_tgt(&creds) : nullptr;
+    if (!tgt)
+    {
+        std::cerr << "Failed generating the tgt of the prefetcher" << std::endl;
+        return false;
+    }
+
+    KRB5KerberosTicketPrefetcher::Settings prefetch_settings;
+    prefetch_settings.authenticator = settings;
+    prefetch_settings.authenticator.session_id = "verify-prefetch-refresh";
+    // The refresh thread talks to the kdc on a connection of its own, never the one of the requesting authenticator
+    prefetch_settings.authenticator.kdc_transport_factory = [&options]() {
+        return std::make_shared<KRB5KerberosTcpKdcTransport>("127.0.0.1", options.port, "verify-prefetch-refresh");
+    };
+    prefetch_settings.service_ticket_lifetime = std::chrono::seconds(LOAD_VERIFY_PREFETCH_LIFETIME_SECONDS);
+    prefetch_settings.refresh_margin = std::chrono::seconds(LOAD_VERIFY_PREFETCH_MARGIN_SECONDS);
+    prefetch_settings.hot_threshold = 1;
+    KRB5KerberosTicketPrefetcher prefetcher(prefetch_settings, *tgt);
+    if (!prefetcher.start())
+    {
+        std::cerr << "Failed starting the prefetcher" << std::endl;
+        return false;
+    }
+    const auto service = service_name(0, options.realm);
+    auto fetched = prefetcher.get(&authenticator, service);
+    if (!fetched || !prefetcher.get(&authenticator, service))
+    {
+        std::cerr << "Failed fetching a service ticket through the prefetcher" << std::endl;
+        return false;
+    }
+
+    const auto deadline = Clock::now() + std::chrono::seconds(LOAD_VERIFY_PREFETCH_LIFETIME_SECONDS);
+    while (Clock::now() < deadline && prefetcher.statistics().refreshes == 0
+           && prefetcher.statistics().refresh_failures == 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    auto refreshed = prefetcher.get(nullptr, service);
+    if (prefetcher.statistics().refreshes == 0 || !refreshed || refreshed->ticket_view() == fetched->ticket_view()
+        || refreshed->ticket_expiration_time() <= fetched->ticket_expiration_time())
+    {
+        std::cerr << "The prefetcher did not replace its hot service ticket" << std::endl;
+        return false;
+    }
+    std::cout << "Prefetcher replaced its hot service ticket ahead of its expiry" << std::endl;
+    return true;
+}
+
+// Feeds a trace line as libkrb5 formats it, then expects the lines of a real AS exchange to parse the same way
+bool verify_trace(const LoadOptions& options)
+{
+    using Type = KRB5KerberosTraceEvent::Type;
+    constexpr std::string_view message = "Sending request (183 bytes) to OCTO.LOAD";
+    const auto line = KRB5KerberosTracer::parse_trace_message(fmt::format("[4242] 1760000000.123456: {}\n", message));
+    if (line.type != Type::KdcRequest || line.value != 183 || line.message_view() != message
+        || line.timestamp.time_since_epoch() != std::chrono::seconds(1760000000) + std::chrono::microseconds(123456))
+    {
+        std::cerr << "Failed parsing a prefixed trace line" << std::endl;
+        return false;
+    }
+
+    std::mutex events_mutex;
+    std::vector<KRB5KerberosTraceEvent> events;
+    KRB5KerberosAuthenticator::Settings settings{options.realm, "127.0.0.1", options.port, "verify-trace", false};
+    settings.tracer = std::make_shared<KRB5KerberosTracer>([&](const KRB5KerberosTraceEvent& event) {
+        std::lock_guard<std::mutex> lock(events_mutex);
+        events.push_back(event);
+    });
+    {
+        KRB5KerberosAuthenticator authenticator(settings);
+        KerberosUserCredentials creds(user_name(0),
+                                      std::make_unique<octo::encryption::SecureString>(user_password(0)));
+        if (!authenticator.initialize_authenticator() || !authenticator.generate_krb5_tgt(&creds))
+        {
+            std::cerr << "Failed generating the traced tgt" << std::endl;
+            return false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(events_mutex);
+    const auto has = [&](Type type) {
+        return std::any_of(events.begin(), events.end(), [type](const KRB5KerberosTraceEvent& event) {
+            return event.type == type && event.message_view().substr(0, 1) != "[";
+        });
+    };
+    if (!has(Type::KdcRequest) || !has(Type::KdcResponse) || !has(Type::EnctypeSelection))
+    {
+        std::cerr << "The libkrb5 trace of an AS exchange lacks its requests, responses or enctypes" << std::endl;
+        return false;
+    }
+    std::cout << "Parsed the libkrb5 trace of an AS exchange" << std::endl;
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    LoadOptions options;
+    if (!parse_options(argc, argv, &options))
+    {
+        std::cout << "Example usage: ./octo-kerberos-load [--users N] [--services N] [--concurrency N] "
+                     "[--iterations N] [--mode direct|streamlined|both] [--port PORT] [--realm REALM] "
+                     "[--bin-dir MIT_SBIN_DIR] [--json OUTPUT] [--capture RECORDING_DIR] [--keep-realm] [--verify]"
+                  << std::endl;
+        return 1;
+    }
+
+    char realm_template[] = "/tmp/octo-kerberos-load-XXXXXX";
+    if (!mkdtemp(realm_template))
+    {
+        std::cerr << "Failed creating realm directory" << std::endl;
+        return 1;
+    }
+    const std::filesystem::path realm_dir(realm_template);
+    write_realm_configuration(options, realm_dir);
+    export_realm_environment(realm_dir);
+
+    int rc = 1;
+    pid_t kdc_pid = -1;
+    if (provision_realm(options))
+    {
+        kdc_pid = start_kdc(options);
+        if (kdc_pid > 0 && wait_for_kdc(options.port))
+        {
+            std::cout << fmt::format("KDC for realm [{}] listening on 127.0.0.1:{} with {} users and {} services",
+                                     options.realm,
+                                     options.port,
+                                     options.users,
+                                     options.services)
+                      << std::endl;
+            if (options.verify)
+            {
+                rc = verify_trace(options) && verify_replay(options, realm_dir) && verify_prefetch(options) ? 0 : 1;
+            }
+            else
+            {
+                nlohmann::json results;
+                results["concurrency"] = options.concurrency;
+                results["iterations"] = options.iterations;
+                if (options.mode == "direct" || options.mode == "both")
+                {
+                    results["direct"] = run_load(options, false);
+                }
+                if (options.mode == "streamlined" || options.mode == "both")
+                {
+                    results["streamlined"] = run_load(options, true);
+                }
+                if (!options.json_output.empty())
+                {
+                    std::ofstream(options.json_output) << results.dump(4) << std::endl;
+                }
+                rc = 0;
+            }
+        }
+        else
+        {
+            std::cerr << "Failed starting krb5kdc, see " << (realm_dir / "kdc.log").string() << std::endl;
+        }
+    }
+    stop_kdc(kdc_pid);
+    if (!options.keep_realm)
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(realm_dir, ec);
+    }
+    return rc;
+}
@@ -0,0 +1,655 @@
+/**
+ * @file krb5-kerberos-serializer-bench.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "krb5-kerberos-bench-fixtures.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-authenticator.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-base64.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-serializer.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-tgt-ticket.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-ticket-registry.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-ticket-store.hpp"
+#include "octo-kerberos-cpp/krb5/python/krb5-kerberos-py-serializer.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+
+namespace
+{
+using octo::kerberos::KerberosUserCredentials;
+using octo::kerberos::krb5::KRB5KerberosAuthenticator;
+using octo::kerberos::krb5::KRB5KerberosBase64;
+using octo::kerberos::krb5::KRB5KerberosCpu;
+using octo::kerberos::krb5::KRB5KerberosJsonWriter;
+using octo::kerberos::krb5::KRB5KerberosReplayKdcTransport;
+using octo::kerberos::krb5::KRB5KerberosSerializer;
+using octo::kerberos::krb5::KRB5KerberosTGTTicket;
+using octo::kerberos::krb5::KRB5KerberosTicketRegistry;
+using octo::kerberos::krb5::KRB5KerberosTicketStore;
+namespace bench = octo::kerberos::krb5::bench;
+
+typedef KRB5KerberosCpu::Implementation Implementation;
+
+std::int64_t implementation_arg(Implementation implementation)
+{
+    return static_cast<std::int64_t>(implementation);
+}
+
+// The implementations built for each, the ones the cpu does not support are skipped
+const std::vector<std::int64_t> BASE64_IMPLEMENTATIONS{implementation_arg(Implementation::Scalar),
+                                                       implementation_arg(Implementation::SSSE3),
+                                                       implementation_arg(Implementation::AVX2),
+                                                       implementation_arg(Implementation::NEON)};
+const std::vector<std::int64_t> REGISTRY_IMPLEMENTATIONS{implementation_arg(Implementation::Scalar),
+                                                         implementation_arg(Implementation::SSE2),
+                                                         implementation_arg(Implementation::AVX2),
+                                                         implementation_arg(Implementation::NEON)};
+
+// First argument is the implementation, second the input size
+void BM_Base64Encode(benchmark::State& state)
+{
+    const auto implementation = KRB5KerberosBase64::implementation();
+    if (!KRB5KerberosBase64::set_implementation(static_cast<KRB5KerberosBase64::Implementation>(state.range(0))))
+    {
+        state.SkipWithError("Implementation not supported");
+        return;
+    }
+    state.SetLabel(KRB5KerberosBase64::implementation_name(KRB5KerberosBase64::implementation()));
+    auto data = bench::make_random_data(state.range(1), 1);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(KRB5KerberosBase64::encode(data.data, data.length));
+    }
+    state.SetBytesProcessed(state.iterations() * data.length);
+    krb5_free_data_contents(nullptr, &data);
+    (void)KRB5KerberosBase64::set_implementation(implementation);
+}
+BENCHMARK(BM_Base64Encode)->ArgsProduct({BASE64_IMPLEMENTATIONS, {32, 1536, 8192}});
+
+void BM_Base64Decode(benchmark::State& state)
+{
+    const auto implementation = KRB5KerberosBase64::implementation();
+    if (!KRB5KerberosBase64::set_implementation(static_cast<KRB5KerberosBase64::Implementation>(state.range(0))))
+    {
+        state.SkipWithError("Implementation not supported");
+        return;
+    }
+    state.SetLabel(KRB5KerberosBase64::implementation_name(KRB5KerberosBase64::implementation()));
+    auto data = bench::make_random_data(state.range(1), 1);
+    const auto encoded = KRB5KerberosBase64::encode(data.data, data.length);
+    std::string decoded;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(KRB5KerberosBase64::decode(encoded, &decoded));
+    }
+    state.SetBytesProcessed(state.iterations() * data.length);
+    krb5_free_data_contents(nullptr, &data);
+    (void)KRB5KerberosBase64::set_implementation(implementation);
+}
+BENCHMARK(BM_Base64Decode)->ArgsProduct({BASE64_IMPLEMENTATIONS, {32, 1536, 8192}});
+
+void BM_SerializeCreds(benchmark::State& state)
+{
+    auto creds = bench::make_creds({"HTTP", "web01.example.com"}, state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(KRB5KerberosSerializer::serialize_creds(creds));
+    }
+    state.SetBytesProcessed(state.iterations() * creds.ticket.length);
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_SerializeCreds)->Arg(512)->Arg(1536)->Arg(8192);
+
+void BM_SerializeCredsDump(benchmark::State& state)
+{
+    auto creds = bench::make_creds({"HTTP", "web01.example.com"}, state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(KRB5KerberosSerializer::serialize_creds(creds).dump());
+    }
+    state.SetBytesProcessed(state.iterations() * creds.ticket.length);
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_SerializeCredsDump)->Arg(512)->Arg(1536)->Arg(8192);
+
+void BM_SerializeCredsStream(benchmark::State& state)
+{
+    auto creds = bench::make_creds({"HTTP", "web01.example.com"}, state.range(0));
+    std::string out;
+    for (auto _ : state)
+    {
+        out.clear();
+        KRB5KerberosJsonWriter writer(&out);
+        KRB5KerberosSerializer::serialize_creds(creds, &writer);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * creds.ticket.length);
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_SerializeCredsStream)->Arg(512)->Arg(1536)->Arg(8192);
+
+void BM_DeserializeCreds(benchmark::State& state)
+{
+    auto creds = bench::make_creds({"HTTP", "web01.example.com"}, state.range(0));
+    const auto j = KRB5KerberosSerializer::serialize_creds(creds);
+    for (auto _ : state)
+    {
+        krb5_creds out{};
+        benchmark::DoNotOptimize(KRB5KerberosSerializer::deserialize_creds(j, &out, nullptr));
+        krb5_free_cred_contents(nullptr, &out);
+    }
+    state.SetBytesProcessed(state.iterations() * creds.ticket.length);
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_DeserializeCreds)->Arg(512)->Arg(1536)->Arg(8192);
+
+void BM_DeserializeCredsParse(benchmark::State& state)
+{
+    auto creds = bench::make_creds({"HTTP", "web01.example.com"}, state.range(0));
+    const auto text = KRB5KerberosSerializer::serialize_creds(creds).dump();
+    for (auto _ : state)
+    {
+        krb5_creds out{};
+        benchmark::DoNotOptimize(KRB5KerberosSerializer::deserialize_creds(nlohmann::json::parse(text), &out, nullptr));
+        krb5_free_cred_contents(nullptr, &out);
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_DeserializeCredsParse)->Arg(512)->Arg(1536)->Arg(8192);
+
+void BM_DeserializeCredsText(benchmark::State& state)
+{
+    auto creds = bench::make_creds({"HTTP", "web01.example.com"}, state.range(0));
+    const auto text = KRB5KerberosSerializer::serialize_creds(creds).dump();
+    for (auto _ : state)
+    {
+        krb5_creds out{};
+        benchmark::DoNotOptimize(KRB5KerberosSerializer::deserialize_creds_text(text, &out, nullptr));
+        krb5_free_cred_contents(nullptr, &out);
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_DeserializeCredsText)->Arg(512)->Arg(1536)->Arg(8192);
+
+void BM_DeserializeCredsContiguous(benchmark::State& state)
+{
+    auto creds = bench::make_creds({"HTTP", "web01.example.com"}, state.range(0));
+    const auto j = KRB5KerberosSerializer::serialize_creds(creds);
+    for (auto _ : state)
+    {
+        auto out = KRB5KerberosSerializer::deserialize_creds_contiguous(j);
+        benchmark::DoNotOptimize(out);
+        KRB5KerberosSerializer::free_creds_contiguous(out);
+    }
+    state.SetBytesProcessed(state.iterations() * creds.ticket.length);
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_DeserializeCredsContiguous)->Arg(512)->Arg(1536)->Arg(8192);
+
+void BM_DeserializeCredsBinary(benchmark::State& state)
+{
+    auto creds = bench::make_creds({"HTTP", "web01.example.com"}, state.range(0));
+    const auto data = KRB5KerberosSerializer::serialize_creds_binary(creds);
+    for (auto _ : state)
+    {
+        krb5_creds out{};
+        benchmark::DoNotOptimize(KRB5KerberosSerializer::deserialize_creds_binary(data, &out, nullptr));
+        krb5_free_cred_contents(nullptr, &out);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_DeserializeCredsBinary)->Arg(512)->Arg(1536)->Arg(8192);
+
+void BM_DeserializeCredsBinaryContiguous(benchmark::State& state)
+{
+    auto creds = bench::make_creds({"HTTP", "web01.example.com"}, state.range(0));
+    const auto data = KRB5KerberosSerializer::serialize_creds_binary(creds);
+    for (auto _ : state)
+    {
+        auto out = KRB5KerberosSerializer::deserialize_creds_binary_contiguous(data);
+        benchmark::DoNotOptimize(out);
+        KRB5KerberosSerializer::free_creds_contiguous(out);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_DeserializeCredsBinaryContiguous)->Arg(512)->Arg(1536)->Arg(8192);
+
+void BM_TGTSerialize(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    KRB5KerberosTGTTicket tgt;
+    if (!tgt.deserialize(bench::make_tgt_json(creds)))
+    {
+        state.SkipWithError("Failed preparing tgt");
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tgt.serialize());
+    }
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTSerialize);
+
+void BM_TGTSerializeTo(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    KRB5KerberosTGTTicket tgt;
+    if (!tgt.deserialize(bench::make_tgt_json(creds)))
+    {
+        state.SkipWithError("Failed preparing tgt");
+    }
+    std::string out;
+    for (auto _ : state)
+    {
+        out.clear();
+        tgt.serialize_to(&out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTSerializeTo);
+
+// The tickets own the creds they deserialize, the ticket of each iteration releases them when it goes out of scope
+// so the TGT deserialize benchmarks measure a full allocate / release cycle rather than a growing heap
+void BM_TGTDeserialize(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    const auto j = bench::make_tgt_json(creds);
+    for (auto _ : state)
+    {
+        KRB5KerberosTGTTicket tgt;
+        benchmark::DoNotOptimize(tgt.deserialize(j));
+    }
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTDeserialize);
+
+void BM_TGTDeserializeParse(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    const auto text = bench::make_tgt_json(creds).dump();
+    for (auto _ : state)
+    {
+        KRB5KerberosTGTTicket tgt;
+        benchmark::DoNotOptimize(tgt.deserialize(nlohmann::json::parse(text)));
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTDeserializeParse);
+
+void BM_TGTDeserializeText(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    const auto text = bench::make_tgt_json(creds).dump();
+    for (auto _ : state)
+    {
+        KRB5KerberosTGTTicket tgt;
+        benchmark::DoNotOptimize(tgt.deserialize_text(text));
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTDeserializeText);
+
+void BM_TGTSerializeBinary(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    KRB5KerberosTGTTicket tgt;
+    if (!tgt.deserialize(bench::make_tgt_json(creds)))
+    {
+        state.SkipWithError("Failed preparing tgt");
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tgt.serialize_binary());
+    }
+    state.counters["bytes"] = tgt.serialize_binary().size();
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTSerializeBinary);
+
+void BM_TGTDeserializeBinary(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    KRB5KerberosTGTTicket source;
+    if (!source.deserialize(bench::make_tgt_json(creds)))
+    {
+        state.SkipWithError("Failed preparing tgt");
+    }
+    const auto data = source.serialize_binary();
+    for (auto _ : state)
+    {
+        KRB5KerberosTGTTicket tgt;
+        benchmark::DoNotOptimize(tgt.deserialize_binary(data));
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTDeserializeBinary);
+
+void BM_TGTPeekText(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    const auto text = bench::make_tgt_json(creds).dump();
+    for (auto _ : state)
+    {
+        octo::kerberos::krb5::KRB5KerberosTicketHeader header;
+        benchmark::DoNotOptimize(KRB5KerberosSerializer::peek_ticket_text(
+            text, octo::kerberos::KerberosTicket::Type::TicketGrantingTicket, &header));
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTPeekText);
+
+void BM_TGTPeekBinary(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    KRB5KerberosTGTTicket source;
+    if (!source.deserialize(bench::make_tgt_json(creds)))
+    {
+        state.SkipWithError("Failed preparing tgt");
+    }
+    const auto data = source.serialize_binary();
+    for (auto _ : state)
+    {
+        octo::kerberos::krb5::KRB5KerberosTicketHeader header;
+        benchmark::DoNotOptimize(KRB5KerberosSerializer::peek_ticket_binary(
+            data, octo::kerberos::KerberosTicket::Type::TicketGrantingTicket, &header));
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTPeekBinary);
+
+// Argument is the number of bulk worker threads, 10k distinct tgts per iteration
+void BM_BulkDeserializeTGTs(benchmark::State& state)
+{
+    KRB5KerberosAuthenticator::Settings settings{"OCTO.BENCH", "127.0.0.1"};
+    settings.streamlined = false;
+    settings.bulk_threads = state.range(0);
+    KRB5KerberosAuthenticator authenticator(settings);
+    if (!authenticator.initialize_authenticator())
+    {
+        state.SkipWithError("Failed initializing authenticator");
+        return;
+    }
+    auto creds = bench::make_tgt_creds();
+    auto j = bench::make_tgt_json(creds);
+    std::vector<std::string> texts;
+    for (auto i = 0; i < 10000; ++i)
+    {
+        j["tgt_user"] = "user" + std::to_string(i);
+        texts.push_back(j.dump());
+    }
+    const std::vector<std::string_view> views(texts.begin(), texts.end());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            authenticator.deserialize_tgts(views, KRB5KerberosAuthenticator::BulkFormat::Json));
+    }
+    state.SetItemsProcessed(state.iterations() * views.size());
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_BulkDeserializeTGTs)->Arg(1)->Arg(4)->Arg(0)->UseRealTime();
+
+// Fills a throwaway store with range(0) tgts, the store is shared by the open / find benchmarks of that size
+std::string prepare_ticket_store(std::int64_t tickets)
+{
+    const auto path = "/tmp/octo-kerberos-bench-store-" + std::to_string(tickets);
+    KRB5KerberosTicketStore store;
+    if (store.open(path) && store.size() != static_cast<std::size_t>(tickets))
+    {
+        auto creds = bench::make_tgt_creds();
+        KRB5KerberosTGTTicket tgt;
+        if (tgt.deserialize(bench::make_tgt_json(creds)))
+        {
+            const auto data = tgt.serialize_binary();
+            for (std::int64_t i = 0; i < tickets; ++i)
+            {
+                (void)store.put("bench-user-" + std::to_string(i),
+                                "krbtgt/EXAMPLE.COM",
+                                tgt.ticket_expiration_time(),
+                                data);
+            }
+        }
+        krb5_free_cred_contents(nullptr, &creds);
+    }
+    return path;
+}
+
+void BM_TicketStoreOpen(benchmark::State& state)
+{
+    const auto path = prepare_ticket_store(state.range(0));
+    for (auto _ : state)
+    {
+        KRB5KerberosTicketStore store;
+        benchmark::DoNotOptimize(store.open(path));
+    }
+}
+BENCHMARK(BM_TicketStoreOpen)->Arg(1000)->Arg(100000);
+
+void BM_TicketStoreFind(benchmark::State& state)
+{
+    KRB5KerberosTicketStore store;
+    if (!store.open(prepare_ticket_store(state.range(0))))
+    {
+        state.SkipWithError("Failed opening ticket store");
+        return;
+    }
+    KRB5KerberosTicketStore::View view;
+    std::int64_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            store.find("bench-user-" + std::to_string(i++ % state.range(0)), "krbtgt/EXAMPLE.COM", &view));
+    }
+}
+BENCHMARK(BM_TicketStoreFind)->Arg(1000)->Arg(100000);
+
+// First argument is the implementation, second the number of tickets, about 1% of which expire within the window
+void BM_TicketRegistryExpiring(benchmark::State& state)
+{
+    const auto implementation = KRB5KerberosTicketRegistry::implementation();
+    if (!KRB5KerberosTicketRegistry::set_implementation(
+            static_cast<KRB5KerberosTicketRegistry::Implementation>(state.range(0))))
+    {
+        state.SkipWithError("Implementation not supported");
+        return;
+    }
+    state.SetLabel(KRB5KerberosTicketRegistry::implementation_name(KRB5KerberosTicketRegistry::implementation()));
+    const auto now = std::chrono::system_clock::now();
+    KRB5KerberosTicketRegistry registry;
+    registry.reserve(state.range(1));
+    for (std::int64_t i = 0; i < state.range(1); ++i)
+    {
+        (void)registry.add(now + std::chrono::seconds(i % 36000), now + std::chrono::hours(24), TKT_FLG_RENEWABLE);
+    }
+    std::vector<KRB5KerberosTicketRegistry::Handle> handles;
+    for (auto _ : state)
+    {
+        handles.clear();
+        registry.expiring(now + std::chrono::seconds(360), &handles);
+        benchmark::DoNotOptimize(handles.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+    (void)KRB5KerberosTicketRegistry::set_implementation(implementation);
+}
+BENCHMARK(BM_TicketRegistryExpiring)->ArgsProduct({REGISTRY_IMPLEMENTATIONS, {10000, 1000000}});
+
+void BM_TGTTicket(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    KRB5KerberosTGTTicket tgt;
+    if (!tgt.deserialize(bench::make_tgt_json(creds)))
+    {
+        state.SkipWithError("Failed preparing tgt");
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tgt.ticket());
+    }
+    state.SetBytesProcessed(state.iterations() * creds.ticket.length);
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTTicket);
+
+void BM_TGTEncodedTicket(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    KRB5KerberosTGTTicket tgt;
+    if (!tgt.deserialize(bench::make_tgt_json(creds)))
+    {
+        state.SkipWithError("Failed preparing tgt");
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tgt.encoded_ticket());
+    }
+    state.SetBytesProcessed(state.iterations() * creds.ticket.length);
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTEncodedTicket);
+
+void BM_TGTTicketView(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    KRB5KerberosTGTTicket tgt;
+    if (!tgt.deserialize(bench::make_tgt_json(creds)))
+    {
+        state.SkipWithError("Failed preparing tgt");
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tgt.ticket_view());
+    }
+    state.SetBytesProcessed(state.iterations() * creds.ticket.length);
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTTicketView);
+
+void BM_TGTEncodedTicketView(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    KRB5KerberosTGTTicket tgt;
+    if (!tgt.deserialize(bench::make_tgt_json(creds)))
+    {
+        state.SkipWithError("Failed preparing tgt");
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tgt.encoded_ticket_view());
+    }
+    state.SetBytesProcessed(state.iterations() * creds.ticket.length);
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTEncodedTicketView);
+
+void BM_TGTClone(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    KRB5KerberosTGTTicket tgt;
+    if (!tgt.deserialize(bench::make_tgt_json(creds)))
+    {
+        state.SkipWithError("Failed preparing tgt");
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tgt.clone());
+    }
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_TGTClone);
+
+void BM_SerializePyJson(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    const auto j = bench::make_tgt_json(creds);
+    for (auto _ : state)
+    {
+        auto py_object = octo::kerberos::krb5::python::serialize_py_json(j);
+        benchmark::DoNotOptimize(py_object);
+        Py_XDECREF(py_object);
+    }
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_SerializePyJson);
+
+void BM_DeserializePyJson(benchmark::State& state)
+{
+    auto creds = bench::make_tgt_creds();
+    auto py_object = octo::kerberos::krb5::python::serialize_py_json(bench::make_tgt_json(creds));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(octo::kerberos::krb5::python::deserialize_py_json(py_object));
+    }
+    Py_XDECREF(py_object);
+    krb5_free_cred_contents(nullptr, &creds);
+}
+BENCHMARK(BM_DeserializePyJson);
+
+// Replays a recording captured with octo-kerberos-load --capture, the replies are bound to the replayed requests so
+// every iteration yields a tgt, only load-user-0 exchanges of the recording are matched
+void BM_ReplayTGTStreamlined(benchmark::State& state)
+{
+    const auto recording = std::getenv("OCTO_KRB5_BENCH_RECORDING");
+    if (!recording)
+    {
+        state.SkipWithError("OCTO_KRB5_BENCH_RECORDING is not set");
+        return;
+    }
+    const auto realm = std::getenv("OCTO_KRB5_BENCH_REALM");
+    KRB5KerberosAuthenticator::Settings settings{realm ? realm : "OCTO.LOAD", "127.0.0.1"};
+    settings.kdc_transport_factory = [recording]() {
+        return std::make_shared<KRB5KerberosReplayKdcTransport>(
+            recording,
+            std::chrono::microseconds(0),
+            std::make_unique<octo::encryption::SecureString>("load-password-0"));
+    };
+    KRB5KerberosAuthenticator authenticator(settings);
+    if (!authenticator.initialize_authenticator())
+    {
+        state.SkipWithError("Failed initializing replay authenticator");
+        return;
+    }
+    KerberosUserCredentials creds("load-user-0",
+                                  std::make_unique<octo::encryption::SecureString>("load-password-0"));
+    for (auto _ : state)
+    {
+        auto tgt = authenticator.generate_tgt(&creds);
+        if (!tgt)
+        {
+            state.SkipWithError("Failed replaying the tgt exchange");
+            break;
+        }
+        benchmark::DoNotOptimize(tgt);
+    }
+}
+BENCHMARK(BM_ReplayTGTStreamlined);
+} // namespace
+
+int main(int argc, char** argv)
+{
+    // The python json bridge requires a live interpreter
+    Py_Initialize();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    Py_Finalize();
+    return 0;
+}
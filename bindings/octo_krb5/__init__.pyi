@@ -1,4 +1,4 @@
-from typing import Final, Optional, Dict, Any
+from typing import Final, Optional, Dict, Any, List, Union
 
 DEFAULT_KERBEROS_PORT: Final[int]
 DEFAULT_TGT_LIFETIME_SECONDS: Final[int]
@@ -35,6 +35,12 @@ class KRB5TGTTicket(object):
 
     def deserialize(self, data: Dict[str, Any]) -> bool: ...
 
+    def serialize_binary(self) -> bytes: ...
+
+    def deserialize_binary(self, data: bytes) -> bool: ...
+
+    def __copy__(self) -> "KRB5TGTTicket": ...
+
 
 class KRB5ServiceTicket(object):
     def __init__(self, service: str): ...
@@ -55,6 +61,12 @@ class KRB5ServiceTicket(object):
 
     def deserialize(self, data: Dict[str, Any]) -> bool: ...
 
+    def serialize_binary(self) -> bytes: ...
+
+    def deserialize_binary(self, data: bytes) -> bool: ...
+
+    def __copy__(self) -> "KRB5ServiceTicket": ...
+
 
 class KRB5Authenticator(object):
     def __init__(self, realm: str, kdc_host: Optional[str] = ...,
@@ -75,7 +87,19 @@ class KRB5Authenticator(object):
 
     def deserialize_tgt(self, data: Dict[str, Any]) -> KRB5TGTTicket: ...
 
+    def deserialize_tgt_binary(self, data: bytes) -> KRB5TGTTicket: ...
+
+    def deserialize_tgt_text(self, text: str) -> KRB5TGTTicket: ...
+
     def generate_service_ticket(self, tgt: KRB5TGTTicket, service: str,
                                 lifetime_seconds: Optional[int] = ...) -> KRB5ServiceTicket: ...
 
     def deserialize_service_ticket(self, data: Dict[str, Any]) -> KRB5ServiceTicket: ...
+
+    def deserialize_service_ticket_binary(self, data: bytes) -> KRB5ServiceTicket: ...
+
+    def deserialize_service_ticket_text(self, text: str) -> KRB5ServiceTicket: ...
+
+    def import_ccache(self, data: bytes) -> List[Union[KRB5TGTTicket, KRB5ServiceTicket]]: ...
+
+    def export_ccache(self, tickets: List[Union[KRB5TGTTicket, KRB5ServiceTicket]]) -> bytes: ...
@@ -1 +1,3 @@
 OPTION(DISABLE_EXAMPLES "Disable Compile examples" OFF)
+OPTION(ENABLE_BENCHMARKS "Enable Compile benchmarks" OFF)
+OPTION(DISABLE_SLAB_POOL "Allocate tickets from the heap instead of the slab pool" OFF)
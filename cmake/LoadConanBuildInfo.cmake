@@ -19,6 +19,7 @@ FUNCTION(LOAD_CONAN_BUILD_INFO)
     SET(KRB5_ROOT ${CONAN_KRB5_ROOT} PARENT_SCOPE)
     SET(OPENSSL_ROOT ${CONAN_OPENSSL_ROOT} PARENT_SCOPE)
     SET(NLOHMANN_JSON_ROOT ${CONAN_NLOHMANN-JSON_ROOT} PARENT_SCOPE)
+    SET(SIMDJSON_ROOT ${CONAN_SIMDJSON_ROOT} PARENT_SCOPE)
     SET(OCTO_LOGGER_CPP_ROOT ${CONAN_OCTO-LOGGER-CPP_ROOT} PARENT_SCOPE)
     SET(OCTO_ENCRYPTION_CPP_ROOT ${CONAN_OCTO-ENCRYPTION-CPP_ROOT} PARENT_SCOPE)
 ENDFUNCTION()
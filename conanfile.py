@@ -17,6 +17,7 @@ class OctoKerberosCPPConan(ConanFile):
         self.requires("fmt@9.0.0")
         self.requires("krb5@1.18.3")
         self.requires("openssl/3.0.5")
+        self.requires("simdjson/3.1.0")
 
     def build(self):
         if self.settings.os == "Linux":
@@ -16,6 +16,7 @@
 #include "kerberos-user-credentials.hpp"
 #include <nlohmann/json.hpp>
 #include <string>
+#include <string_view>
 #include <chrono>
 
 namespace
@@ -47,11 +48,19 @@ class KerberosAuthenticator
         const KerberosUserCredentials* const creds,
         std::chrono::seconds lifetime = std::chrono::seconds(DEFAULT_TGT_LIFETIME_SECONDS)) = 0;
     [[nodiscard]] virtual KerberosTicketUniquePtr deserialize_tgt(const nlohmann::json& json) = 0;
+    // Defaults to deserializing the CBOR encoding of the json form, see KerberosTicket::serialize_binary
+    [[nodiscard]] virtual KerberosTicketUniquePtr deserialize_tgt_binary(std::string_view data);
+    // Defaults to deserializing the parsed document, see KerberosTicket::deserialize_text
+    [[nodiscard]] virtual KerberosTicketUniquePtr deserialize_tgt_text(std::string_view text);
     [[nodiscard]] virtual KerberosTicketUniquePtr generate_service_ticket(
-        KerberosTicket* const tgt,
+        const KerberosTicket* const tgt,
         const std::string& service,
         std::chrono::seconds lifetime = std::chrono::seconds(DEFAULT_SERVICE_TICKET_LIFETIME_SECONDS)) = 0;
     [[nodiscard]] virtual KerberosTicketUniquePtr deserialize_service_ticket(const nlohmann::json& json) = 0;
+    // Defaults to deserializing the CBOR encoding of the json form, see KerberosTicket::serialize_binary
+    [[nodiscard]] virtual KerberosTicketUniquePtr deserialize_service_ticket_binary(std::string_view data);
+    // Defaults to deserializing the parsed document, see KerberosTicket::deserialize_text
+    [[nodiscard]] virtual KerberosTicketUniquePtr deserialize_service_ticket_text(std::string_view text);
 };
 } // namespace octo::kerberos
 
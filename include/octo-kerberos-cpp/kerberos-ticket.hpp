@@ -15,7 +15,9 @@
 #include <octo-encryption-cpp/encryptors/encrypted-string.hpp>
 #include <memory>
 #include <chrono>
+#include <ostream>
 #include <string>
+#include <string_view>
 #include <nlohmann/json.hpp>
 
 namespace octo::kerberos
@@ -35,12 +37,29 @@ class KerberosTicket
 
     [[nodiscard]] virtual encryption::SecureString ticket() const = 0;
     [[nodiscard]] virtual encryption::SecureString encoded_ticket() const = 0;
+    // Same bytes as ticket() and encoded_ticket() without copying them, valid until the ticket is deserialized into
+    // again or destroyed. The encoded form is computed on first use and kept with the ticket
+    [[nodiscard]] virtual std::string_view ticket_view() const = 0;
+    [[nodiscard]] virtual std::string_view encoded_ticket_view() const = 0;
     [[nodiscard]] virtual std::string ticket_purpose() const = 0;
     [[nodiscard]] virtual Type ticket_type() const = 0;
     [[nodiscard]] virtual const std::chrono::time_point<std::chrono::system_clock>& ticket_expiration_time() const = 0;
 
+    // Copy sharing the underlying creds, as cheap for a large ticket as for a small one
+    [[nodiscard]] virtual std::unique_ptr<KerberosTicket> clone() const = 0;
+
     [[nodiscard]] virtual nlohmann::json serialize() const = 0;
     [[nodiscard]] virtual bool deserialize(const nlohmann::json& json) = 0;
+    // Same text as serialize().dump(), appended to out. Defaults to exactly that, implementations override it to
+    // write the text without building the json document first
+    virtual void serialize_to(std::string* out) const;
+    virtual void serialize_to(std::ostream& out) const;
+    // Parses the text of serialize().dump() into the ticket. Defaults to deserialize() of the parsed document,
+    // implementations override it to parse straight into the ticket
+    [[nodiscard]] virtual bool deserialize_text(std::string_view text);
+    // Defaults to the CBOR encoding of serialize(), implementations override it with a compact format of their own
+    [[nodiscard]] virtual std::string serialize_binary() const;
+    [[nodiscard]] virtual bool deserialize_binary(std::string_view data);
 };
 typedef std::unique_ptr<KerberosTicket> KerberosTicketUniquePtr;
 typedef std::shared_ptr<KerberosTicket> KerberosTicketPtr;
@@ -15,11 +15,20 @@
 #include "octo-kerberos-cpp/kerberos-authenticator.hpp"
 #include "octo-kerberos-cpp/kerberos-ticket.hpp"
 #include "octo-kerberos-cpp/kerberos-user-credentials.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-kdc-transport.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-principal-table.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-request-coalescer.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-service-ticket.hpp"
 #include "octo-kerberos-cpp/krb5/krb5-kerberos-tgt-ticket.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-thread-pool.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-trace.hpp"
 #include <octo-logger-cpp/logger.hpp>
 #include <nlohmann/json.hpp>
 #include <krb5/krb5.h>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <profile.h>
 
 namespace
@@ -40,6 +49,43 @@ class KRB5KerberosAuthenticator : public KerberosAuthenticator
         std::uint32_t kdc_port = DEFAULT_KERBEROS_PORT;
         std::string session_id;
         bool streamlined = DEFAULT_KERBEROS_STREAMLINED;
+        // Optional, when set the libkrb5 trace events are parsed and delivered to the tracer sink
+        KRB5KerberosTracerPtr tracer;
+        // Optional, streamlined only, creates the transport of each authenticator instead of the default tcp one
+        KRB5KerberosKdcTransportFactory kdc_transport_factory;
+        // Optional, streamlined only, records every kdc request / response pair to the given file
+        std::string kdc_capture_path;
+        // Optional, streamlined only, answers kdc requests from a recording instead of the network
+        std::string kdc_replay_path;
+        std::chrono::microseconds kdc_replay_latency = std::chrono::microseconds(0);
+        // Deserialized service tickets keep their creds in a single allocation instead of one per field
+        bool contiguous_service_tickets = false;
+        // Worker threads used by the bulk apis, zero means one per hardware thread
+        std::size_t bulk_threads = 0;
+        // Optional, shares parsed principals between authenticators of this realm, each has its own otherwise
+        KRB5KerberosPrincipalTablePtr principals;
+        // Optional, shares identical tgt and service ticket exchanges in flight between authenticators of this realm
+        KRB5KerberosRequestCoalescerPtr coalescer;
+    };
+
+    enum class BulkFormat : std::uint8_t
+    {
+        // serialize().dump() text
+        Json,
+        Binary
+    };
+
+    // A failed item has no ticket (or no data) and the reason in error
+    struct BulkDeserializeResult
+    {
+        KerberosTicketUniquePtr ticket;
+        std::string error;
+    };
+
+    struct BulkSerializeResult
+    {
+        std::string data;
+        std::string error;
     };
 
   private:
@@ -48,40 +94,71 @@ class KRB5KerberosAuthenticator : public KerberosAuthenticator
     profile_t profile_;
     krb5_context ctx_;
     krb5_ccache cache_;
+    // Ticket of the tgt cache_ holds, libkrb5 fetches service tickets with the tgt of the cache
+    std::string cache_tgt_;
     krb5_principal server_;
     bool is_initialized_;
+    // Attached to settings_.tracer, detached on cleanup
+    bool is_tracing_;
     logger::Logger logger_;
-    int kdc_fd_;
+    KRB5KerberosKdcTransportPtr kdc_transport_;
+    KRB5KerberosThreadPoolUniquePtr bulk_pool_;
+    std::mutex bulk_pool_mutex_;
+    KRB5KerberosPrincipalTablePtr principals_;
+    // Error the last kdc exchange failed with, 0 when it did not, reported to the coalescer
+    krb5_error_code kdc_error_;
+
+  private:
+    // Creds matching a service ticket to fetch, holding on to the interned principals they point to
+    struct MatchCreds
+    {
+        krb5_creds creds;
+        KRB5KerberosPrincipalTable::EntryPtr client;
+        KRB5KerberosPrincipalTable::EntryPtr server;
+    };
 
   private:
     [[nodiscard]] bool create_streamlined_kdc_connection();
     void close_streamlined_kdc_connection();
-    [[nodiscard]] int kdc_net_read(char* buf, int len);
-    [[nodiscard]] int kdc_net_write(char* buf, int len);
     [[nodiscard]] krb5_error_code kdc_read(krb5_data* inbuf);
     [[nodiscard]] krb5_error_code kdc_write(krb5_data* outbuf);
     [[nodiscard]] bool convert_to_krb_address(const std::string& host, int port, krb5_address** outaddr);
 
     [[nodiscard]] krb5_get_init_creds_opt* allocate_init_creds_options(std::chrono::seconds lifetime);
-    [[nodiscard]] KerberosTicketUniquePtr generate_tgt_direct(
+    [[nodiscard]] KRB5KerberosTGTTicketUniquePtr generate_tgt_direct(
         const KerberosUserCredentials* const creds,
         std::chrono::seconds lifetime = std::chrono::seconds(DEFAULT_TGT_LIFETIME_SECONDS));
-    [[nodiscard]] KerberosTicketUniquePtr generate_tgt_streamlined(
+    [[nodiscard]] KRB5KerberosTGTTicketUniquePtr generate_tgt_streamlined(
         const KerberosUserCredentials* const creds,
         std::chrono::seconds lifetime = std::chrono::seconds(DEFAULT_TGT_LIFETIME_SECONDS));
 
-    [[nodiscard]] bool prepare_tgt_for_st_generation(KRB5KerberosTGTTicket* const krb5_tgt,
-                                                     const std::string& service,
-                                                     std::chrono::seconds lifetime);
-    [[nodiscard]] KerberosTicketUniquePtr generate_service_ticket_direct(
-        KRB5KerberosTGTTicket* const krb5_tgt,
+    // Replaces creds allocated by the context of another authenticator with a copy allocated by ctx_
+    [[nodiscard]] bool take_over_creds(KRB5KerberosCredsPtr* creds);
+    // Makes the tgt the one of cache_, unless it already is
+    [[nodiscard]] bool store_tgt(const KRB5KerberosTGTTicket* const krb5_tgt);
+    // Per request creds matching the service ticket to fetch, released with release_match_creds
+    [[nodiscard]] bool prepare_match_creds(const KRB5KerberosTGTTicket* const krb5_tgt,
+                                           const std::string& service,
+                                           std::chrono::seconds lifetime,
+                                           MatchCreds* match_creds);
+    void release_match_creds(MatchCreds* match_creds);
+    [[nodiscard]] KRB5KerberosServiceTicketUniquePtr generate_service_ticket_direct(
+        const KRB5KerberosTGTTicket* const krb5_tgt,
         const std::string& service,
         std::chrono::seconds lifetime = std::chrono::seconds(DEFAULT_SERVICE_TICKET_LIFETIME_SECONDS));
-    [[nodiscard]] KerberosTicketUniquePtr generate_service_ticket_streamlined(
-        KRB5KerberosTGTTicket* const krb5_tgt,
+    [[nodiscard]] KRB5KerberosServiceTicketUniquePtr generate_service_ticket_streamlined(
+        const KRB5KerberosTGTTicket* const krb5_tgt,
         const std::string& service,
         std::chrono::seconds lifetime = std::chrono::seconds(DEFAULT_SERVICE_TICKET_LIFETIME_SECONDS));
 
+    [[nodiscard]] KRB5KerberosThreadPool& bulk_pool();
+    [[nodiscard]] std::vector<BulkDeserializeResult> deserialize_bulk(const std::vector<std::string_view>& data,
+                                                                      BulkFormat format,
+                                                                      KerberosTicket::Type type);
+    [[nodiscard]] BulkDeserializeResult deserialize_bulk_item(std::string_view data,
+                                                              BulkFormat format,
+                                                              KerberosTicket::Type type) const;
+
   public:
     explicit KRB5KerberosAuthenticator(Settings settings);
     ~KRB5KerberosAuthenticator() override;
@@ -93,17 +170,52 @@ class KRB5KerberosAuthenticator : public KerberosAuthenticator
         const KerberosUserCredentials* const creds,
         std::chrono::seconds lifetime = std::chrono::seconds(DEFAULT_TGT_LIFETIME_SECONDS)) override;
     [[nodiscard]] KerberosTicketUniquePtr deserialize_tgt(const nlohmann::json& json) override;
+    [[nodiscard]] KerberosTicketUniquePtr deserialize_tgt_binary(std::string_view data) override;
+    [[nodiscard]] KerberosTicketUniquePtr deserialize_tgt_text(std::string_view text) override;
     [[nodiscard]] KerberosTicketUniquePtr generate_service_ticket(
-        KerberosTicket* const tgt,
+        const KerberosTicket* const tgt,
         const std::string& service,
         std::chrono::seconds lifetime = std::chrono::seconds(DEFAULT_SERVICE_TICKET_LIFETIME_SECONDS)) override;
     [[nodiscard]] KerberosTicketUniquePtr deserialize_service_ticket(const nlohmann::json& json) override;
+    [[nodiscard]] KerberosTicketUniquePtr deserialize_service_ticket_binary(std::string_view data) override;
+    [[nodiscard]] KerberosTicketUniquePtr deserialize_service_ticket_text(std::string_view text) override;
+
+    // Statically typed counterparts of the above, for callers holding krb5 tickets, without the ticket type check and
+    // dynamic_cast the polymorphic apis go through
+    [[nodiscard]] KRB5KerberosTGTTicketUniquePtr generate_krb5_tgt(
+        const KerberosUserCredentials* const creds,
+        std::chrono::seconds lifetime = std::chrono::seconds(DEFAULT_TGT_LIFETIME_SECONDS));
+    [[nodiscard]] KRB5KerberosTGTTicketUniquePtr deserialize_krb5_tgt(const nlohmann::json& json);
+    [[nodiscard]] KRB5KerberosTGTTicketUniquePtr deserialize_krb5_tgt_binary(std::string_view data);
+    [[nodiscard]] KRB5KerberosTGTTicketUniquePtr deserialize_krb5_tgt_text(std::string_view text);
+    [[nodiscard]] KRB5KerberosServiceTicketUniquePtr generate_service_ticket(
+        const KRB5KerberosTGTTicket* const tgt,
+        const std::string& service,
+        std::chrono::seconds lifetime = std::chrono::seconds(DEFAULT_SERVICE_TICKET_LIFETIME_SECONDS));
+    [[nodiscard]] KRB5KerberosServiceTicketUniquePtr deserialize_krb5_service_ticket(const nlohmann::json& json);
+    [[nodiscard]] KRB5KerberosServiceTicketUniquePtr deserialize_krb5_service_ticket_binary(std::string_view data);
+    [[nodiscard]] KRB5KerberosServiceTicketUniquePtr deserialize_krb5_service_ticket_text(std::string_view text);
+
+    // MIT ccache (FILE:) import / export, tgts are recognized by their krbtgt server principal. Imported tickets are
+    // always KRB5KerberosTGTTicket or KRB5KerberosServiceTicket, as their ticket_type() tells
+    [[nodiscard]] bool import_ccache(std::string_view data, std::vector<KerberosTicketUniquePtr>* tickets);
+    [[nodiscard]] bool export_ccache(const std::vector<const KerberosTicket*>& tickets, std::string* data);
+
+    // Bulk, the items are spread over a pool of worker threads and the results are returned in input order
+    [[nodiscard]] std::vector<BulkDeserializeResult> deserialize_tgts(const std::vector<std::string_view>& data,
+                                                                      BulkFormat format);
+    [[nodiscard]] std::vector<BulkDeserializeResult> deserialize_service_tickets(
+        const std::vector<std::string_view>& data, BulkFormat format);
+    [[nodiscard]] std::vector<BulkSerializeResult> serialize_all(const std::vector<const KerberosTicket*>& tickets,
+                                                                 BulkFormat format);
 
     long get_profile_values(const char* const* names, char*** ret_values);
     void free_profile_values(char** values);
     void cleanup_profile();
 
     bool is_streamlined() const;
+    // Principals parsed by this authenticator, their ids can key caches in place of the principal names
+    [[nodiscard]] const KRB5KerberosPrincipalTablePtr& principals() const;
 };
 } // namespace octo::kerberos::krb5
 
@@ -0,0 +1,55 @@
+/**
+ * @file krb5-kerberos-base64.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_BASE64_HPP_
+#define KRB5_KERBEROS_BASE64_HPP_
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-cpu-dispatch.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace octo::kerberos::krb5
+{
+/**
+ * Standard alphabet base64 (RFC 4648, padded), the same encoding produced by encryption::Base64.
+ * Bulk blocks go through the widest vector unit the cpu supports (AVX2, SSSE3 or NEON), picked once at runtime,
+ * the tail and any input with invalid characters go through the scalar codec.
+ * Decoding accepts padded and unpadded input and rejects anything outside the alphabet.
+ */
+class KRB5KerberosBase64
+{
+  public:
+    typedef KRB5KerberosCpu::Implementation Implementation;
+
+  public:
+    KRB5KerberosBase64() = delete;
+
+    [[nodiscard]] static Implementation implementation();
+    [[nodiscard]] static const char* implementation_name(Implementation implementation);
+    // Switches every later call to the given implementation, fails if the cpu does not support it
+    [[nodiscard]] static bool set_implementation(Implementation implementation);
+
+    [[nodiscard]] static std::size_t encoded_size(std::size_t size);
+    // Exact decoded size, fails when the length cannot be a valid encoding
+    [[nodiscard]] static bool decoded_size(std::string_view encoded, std::size_t* size);
+
+    // Writes exactly encoded_size(size) characters to out
+    static void encode(const void* data, std::size_t size, char* out);
+    [[nodiscard]] static std::string encode(const void* data, std::size_t size);
+    // Writes exactly decoded_size(encoded) bytes to out, on failure out holds partial garbage
+    [[nodiscard]] static bool decode(std::string_view encoded, void* out);
+    [[nodiscard]] static bool decode(std::string_view encoded, std::string* out);
+};
+} // namespace octo::kerberos::krb5
+
+#endif
@@ -0,0 +1,181 @@
+/**
+ * @file krb5-kerberos-byte-buffer.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_BYTE_BUFFER_HPP_
+#define KRB5_KERBEROS_BYTE_BUFFER_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace octo::kerberos::krb5
+{
+// Big endian (network order) primitives shared by the binary formats
+class KRB5KerberosByteWriter
+{
+  private:
+    std::string* out_;
+
+  public:
+    explicit KRB5KerberosByteWriter(std::string* out) : out_(out)
+    {
+    }
+
+    void write_u8(std::uint8_t value)
+    {
+        out_->push_back(static_cast<char>(value));
+    }
+
+    void write_u16(std::uint16_t value)
+    {
+        const char bytes[] = {static_cast<char>(value >> 8), static_cast<char>(value)};
+        out_->append(bytes, sizeof(bytes));
+    }
+
+    void write_u32(std::uint32_t value)
+    {
+        const char bytes[] = {static_cast<char>(value >> 24),
+                              static_cast<char>(value >> 16),
+                              static_cast<char>(value >> 8),
+                              static_cast<char>(value)};
+        out_->append(bytes, sizeof(bytes));
+    }
+
+    void write_u64(std::uint64_t value)
+    {
+        write_u32(static_cast<std::uint32_t>(value >> 32));
+        write_u32(static_cast<std::uint32_t>(value));
+    }
+
+    void write_bytes(const void* data, std::size_t length)
+    {
+        if (length > 0)
+        {
+            out_->append(static_cast<const char*>(data), length);
+        }
+    }
+
+    void write_counted(const void* data, std::uint32_t length)
+    {
+        write_u32(length);
+        write_bytes(data, length);
+    }
+
+    void write_counted(std::string_view data)
+    {
+        write_counted(data.data(), static_cast<std::uint32_t>(data.size()));
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return out_->size();
+    }
+};
+
+class KRB5KerberosByteReader
+{
+  private:
+    const unsigned char* data_;
+    std::size_t size_;
+    std::size_t pos_;
+
+  public:
+    explicit KRB5KerberosByteReader(std::string_view data)
+        : data_(reinterpret_cast<const unsigned char*>(data.data())), size_(data.size()), pos_(0)
+    {
+    }
+
+    [[nodiscard]] bool read_u8(std::uint8_t* value)
+    {
+        if (remaining() < 1)
+        {
+            return false;
+        }
+        *value = data_[pos_++];
+        return true;
+    }
+
+    [[nodiscard]] bool read_u16(std::uint16_t* value)
+    {
+        if (remaining() < 2)
+        {
+            return false;
+        }
+        *value = static_cast<std::uint16_t>((data_[pos_] << 8) | data_[pos_ + 1]);
+        pos_ += 2;
+        return true;
+    }
+
+    [[nodiscard]] bool read_u32(std::uint32_t* value)
+    {
+        if (remaining() < 4)
+        {
+            return false;
+        }
+        *value = (static_cast<std::uint32_t>(data_[pos_]) << 24) | (static_cast<std::uint32_t>(data_[pos_ + 1]) << 16)
+                 | (static_cast<std::uint32_t>(data_[pos_ + 2]) << 8) | static_cast<std::uint32_t>(data_[pos_ + 3]);
+        pos_ += 4;
+        return true;
+    }
+
+    [[nodiscard]] bool read_u64(std::uint64_t* value)
+    {
+        std::uint32_t high, low;
+        if (!read_u32(&high) || !read_u32(&low))
+        {
+            return false;
+        }
+        *value = (static_cast<std::uint64_t>(high) << 32) | low;
+        return true;
+    }
+
+    // Returns a view into the underlying buffer, valid for as long as the buffer itself
+    [[nodiscard]] bool read_bytes(std::size_t length, std::string_view* bytes)
+    {
+        if (remaining() < length)
+        {
+            return false;
+        }
+        *bytes = std::string_view(reinterpret_cast<const char*>(data_ + pos_), length);
+        pos_ += length;
+        return true;
+    }
+
+    [[nodiscard]] bool read_counted(std::string_view* bytes)
+    {
+        std::uint32_t length;
+        return read_u32(&length) && read_bytes(length, bytes);
+    }
+
+    [[nodiscard]] bool skip(std::size_t length)
+    {
+        if (remaining() < length)
+        {
+            return false;
+        }
+        pos_ += length;
+        return true;
+    }
+
+    [[nodiscard]] std::size_t remaining() const
+    {
+        return size_ - pos_;
+    }
+
+    [[nodiscard]] std::size_t position() const
+    {
+        return pos_;
+    }
+};
+} // namespace octo::kerberos::krb5
+
+#endif
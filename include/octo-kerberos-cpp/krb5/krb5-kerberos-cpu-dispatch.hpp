@@ -0,0 +1,156 @@
+/**
+ * @file krb5-kerberos-cpu-dispatch.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_CPU_DISPATCH_HPP_
+#define KRB5_KERBEROS_CPU_DISPATCH_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define KRB5_KERBEROS_CPU_X86
+#elif defined(__aarch64__)
+#define KRB5_KERBEROS_CPU_NEON
+#endif
+
+namespace octo::kerberos::krb5
+{
+// Vector units the kernels picked at runtime are built for
+class KRB5KerberosCpu
+{
+  public:
+    enum class Implementation : std::uint8_t
+    {
+        Scalar,
+        SSE2,
+        SSSE3,
+        AVX2,
+        NEON
+    };
+
+  public:
+    KRB5KerberosCpu() = delete;
+
+    [[nodiscard]] static bool supports(Implementation implementation)
+    {
+        switch (implementation)
+        {
+            case Implementation::Scalar:
+                return true;
+#if defined(KRB5_KERBEROS_CPU_X86)
+            case Implementation::SSE2:
+                return __builtin_cpu_supports("sse2");
+            case Implementation::SSSE3:
+                return __builtin_cpu_supports("ssse3");
+            case Implementation::AVX2:
+                return __builtin_cpu_supports("avx2");
+#elif defined(KRB5_KERBEROS_CPU_NEON)
+            case Implementation::NEON:
+                return true;
+#endif
+            default:
+                return false;
+        }
+    }
+
+    [[nodiscard]] static const char* implementation_name(Implementation implementation)
+    {
+        switch (implementation)
+        {
+            case Implementation::Scalar:
+                return "scalar";
+            case Implementation::SSE2:
+                return "sse2";
+            case Implementation::SSSE3:
+                return "ssse3";
+            case Implementation::AVX2:
+                return "avx2";
+            case Implementation::NEON:
+                return "neon";
+        }
+        return "unknown";
+    }
+};
+
+/**
+ * Holds the kernels in use out of every set built into the binary. Kernels is a struct of function pointers with an
+ * implementation member, the sets are given in order of preference with the scalar one last, and the first one the
+ * cpu supports is picked. Switching is atomic, calls in flight keep the kernels they already loaded.
+ */
+template <typename Kernels>
+class KRB5KerberosCpuDispatch
+{
+  private:
+    const Kernels* const* kernels_;
+    std::size_t count_;
+    std::atomic<const Kernels*> active_;
+
+  private:
+    [[nodiscard]] const Kernels* find(KRB5KerberosCpu::Implementation implementation) const
+    {
+        for (std::size_t i = 0; i < count_; ++i)
+        {
+            if (kernels_[i]->implementation == implementation)
+            {
+                return KRB5KerberosCpu::supports(implementation) ? kernels_[i] : nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] const Kernels* detect() const
+    {
+        for (std::size_t i = 0; i + 1 < count_; ++i)
+        {
+            if (KRB5KerberosCpu::supports(kernels_[i]->implementation))
+            {
+                return kernels_[i];
+            }
+        }
+        return kernels_[count_ - 1];
+    }
+
+  public:
+    template <std::size_t N>
+    explicit KRB5KerberosCpuDispatch(const Kernels* const (&kernels)[N])
+        : kernels_(kernels), count_(N), active_(detect())
+    {
+    }
+
+    KRB5KerberosCpuDispatch(const KRB5KerberosCpuDispatch&) = delete;
+    KRB5KerberosCpuDispatch& operator=(const KRB5KerberosCpuDispatch&) = delete;
+
+    [[nodiscard]] const Kernels& kernels() const
+    {
+        return *active_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] KRB5KerberosCpu::Implementation implementation() const
+    {
+        return kernels().implementation;
+    }
+
+    // Fails if the given implementation is not built in or the cpu does not support it
+    [[nodiscard]] bool set_implementation(KRB5KerberosCpu::Implementation implementation)
+    {
+        const auto kernels = find(implementation);
+        if (!kernels)
+        {
+            return false;
+        }
+        active_.store(kernels, std::memory_order_relaxed);
+        return true;
+    }
+};
+} // namespace octo::kerberos::krb5
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file krb5-kerberos-creds.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_CREDS_HPP_
+#define KRB5_KERBEROS_CREDS_HPP_
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-encoded-ticket.hpp"
+#include <krb5/krb5.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string_view>
+
+namespace octo::kerberos::krb5
+{
+class KRB5KerberosCredsPtr;
+
+/**
+ * One krb5_creds shared by every ticket copy holding it, together with the base64 of its ticket blob. A block is
+ * never modified while shared, writers go through KRB5KerberosCredsPtr which copies it first. The last reference
+ * zeroizes the ticket blobs and releases the creds the way they were allocated.
+ */
+class KRB5KerberosCreds
+{
+  public:
+    enum class Allocation : std::uint8_t
+    {
+        // libkrb5, released with krb5_free_creds
+        Heap,
+        // KRB5KerberosSlabPool, the contents are released with krb5_free_cred_contents
+        Pooled,
+        // KRB5KerberosSerializer::deserialize_creds_*contiguous, released with free_creds_contiguous
+        Contiguous
+    };
+
+  private:
+    krb5_creds* creds_;
+    krb5_context ctx_;
+    Allocation allocation_;
+    std::atomic<std::size_t> references_;
+    KRB5KerberosEncodedTicket encoded_ticket_;
+
+  private:
+    KRB5KerberosCreds(krb5_creds* creds, krb5_context ctx, Allocation allocation);
+    ~KRB5KerberosCreds();
+
+    friend class KRB5KerberosCredsPtr;
+
+  public:
+    KRB5KerberosCreds(const KRB5KerberosCreds&) = delete;
+    KRB5KerberosCreds& operator=(const KRB5KerberosCreds&) = delete;
+
+    // Blocks come from KRB5KerberosSlabPool
+    static void* operator new(std::size_t size);
+    static void* operator new(std::size_t size, const std::nothrow_t&) noexcept;
+    static void operator delete(void* ptr) noexcept;
+};
+
+/**
+ * Intrusive reference to a KRB5KerberosCreds, copying it shares the block. An empty reference reads as zeroed creds.
+ * Like std::shared_ptr, one reference must not be used from several threads at once while different references to
+ * the same block may.
+ */
+class KRB5KerberosCredsPtr
+{
+  private:
+    KRB5KerberosCreds* block_;
+
+  private:
+    explicit KRB5KerberosCredsPtr(KRB5KerberosCreds* block);
+
+    void release();
+
+  public:
+    KRB5KerberosCredsPtr();
+    ~KRB5KerberosCredsPtr();
+
+    KRB5KerberosCredsPtr(const KRB5KerberosCredsPtr& other);
+    KRB5KerberosCredsPtr(KRB5KerberosCredsPtr&& other) noexcept;
+    KRB5KerberosCredsPtr& operator=(const KRB5KerberosCredsPtr& other);
+    KRB5KerberosCredsPtr& operator=(KRB5KerberosCredsPtr&& other) noexcept;
+
+    // Takes ownership of creds allocated as given, on allocation failure they are released and the result is empty
+    [[nodiscard]] static KRB5KerberosCredsPtr adopt(krb5_creds* creds,
+                                                    krb5_context ctx,
+                                                    KRB5KerberosCreds::Allocation allocation);
+
+    [[nodiscard]] explicit operator bool() const;
+    // Null when empty
+    [[nodiscard]] const krb5_creds* get() const;
+    [[nodiscard]] const krb5_creds& operator*() const;
+    [[nodiscard]] const krb5_creds* operator->() const;
+    [[nodiscard]] std::size_t use_count() const;
+    // Base64 of the ticket blob, encoded once per block
+    [[nodiscard]] std::string_view encoded_ticket() const;
+
+    // Creds this reference alone owns, copied from the shared or contiguous block first, null when out of memory
+    [[nodiscard]] krb5_creds* mutate(krb5_context ctx);
+    // Same, for callers about to overwrite every field, a shared or contiguous block is dropped instead of copied
+    [[nodiscard]] krb5_creds* replace(krb5_context ctx);
+    void reset();
+};
+} // namespace octo::kerberos::krb5
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * @file krb5-kerberos-encoded-ticket.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_ENCODED_TICKET_HPP_
+#define KRB5_KERBEROS_ENCODED_TICKET_HPP_
+
+#include <krb5/krb5.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace octo::kerberos::krb5
+{
+/**
+ * Base64 of a ticket blob, encoded on the first view and kept until reset. The encoding is zeroized whenever it is
+ * dropped. Views may be taken from several threads at once, reset must not race with readers of an earlier view.
+ */
+class KRB5KerberosEncodedTicket
+{
+  private:
+    mutable std::mutex mutex_;
+    mutable std::atomic<bool> is_encoded_;
+    mutable std::string encoded_;
+
+  public:
+    KRB5KerberosEncodedTicket();
+    ~KRB5KerberosEncodedTicket();
+
+    KRB5KerberosEncodedTicket(const KRB5KerberosEncodedTicket&) = delete;
+    KRB5KerberosEncodedTicket& operator=(const KRB5KerberosEncodedTicket&) = delete;
+
+    // Valid until the next reset
+    [[nodiscard]] std::string_view view(const krb5_data& ticket) const;
+    // Drops the encoding, the ticket blob it was taken from changed
+    void reset();
+};
+} // namespace octo::kerberos::krb5
+
+#endif
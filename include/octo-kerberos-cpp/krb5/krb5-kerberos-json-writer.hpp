@@ -0,0 +1,66 @@
+/**
+ * @file krb5-kerberos-json-writer.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_JSON_WRITER_HPP_
+#define KRB5_KERBEROS_JSON_WRITER_HPP_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace octo::kerberos::krb5
+{
+/**
+ * Forward only json writer, emits the same text nlohmann::json::dump() does for the same document (compact, strings
+ * escaped the same way) without building the document first.
+ * dump() orders object keys alphabetically, callers write the keys in that order to keep the output identical.
+ * Strings are written as given, invalid utf-8 is not rejected like dump() would.
+ * When writing to a stream the text is buffered and flushed in chunks, and at the latest on destruction.
+ */
+class KRB5KerberosJsonWriter
+{
+  private:
+    std::string* out_;
+    std::ostream* stream_;
+    std::string buffer_;
+    bool needs_separator_;
+
+  private:
+    void separate();
+    void write_escaped(std::string_view value);
+    void flush_if_full();
+
+  public:
+    // Appends to out
+    explicit KRB5KerberosJsonWriter(std::string* out);
+    explicit KRB5KerberosJsonWriter(std::ostream& stream);
+    ~KRB5KerberosJsonWriter();
+    KRB5KerberosJsonWriter(const KRB5KerberosJsonWriter&) = delete;
+    KRB5KerberosJsonWriter& operator=(const KRB5KerberosJsonWriter&) = delete;
+
+    void begin_object();
+    void end_object();
+    void begin_array();
+    void end_array();
+    void key(std::string_view name);
+
+    void value_int(std::int64_t value);
+    void value_uint(std::uint64_t value);
+    void value_string(std::string_view value);
+    // Base64 encoded straight from the given bytes
+    void value_base64(const void* data, std::size_t size);
+
+    void flush();
+};
+} // namespace octo::kerberos::krb5
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file krb5-kerberos-kdc-recording.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_KDC_RECORDING_HPP_
+#define KRB5_KERBEROS_KDC_RECORDING_HPP_
+
+#include <octo-encryption-cpp/encryptors/encrypted-string.hpp>
+#include <krb5/krb5.h>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace octo::kerberos::krb5
+{
+/**
+ * Recording file layout, all integers are big endian:
+ *   header: "OKKR" magic, u16 version
+ *   frame:  u8 direction, u64 nanoseconds since recording start, u32 length, payload
+ * The payload is the kdc message without the 4 byte tcp length prefix.
+ */
+struct KRB5KerberosKdcFrame
+{
+    enum class Direction : std::uint8_t
+    {
+        Request,
+        Response
+    };
+
+    Direction direction;
+    std::chrono::nanoseconds offset;
+    std::string payload;
+};
+
+class KRB5KerberosKdcRecorder
+{
+  private:
+    std::ofstream file_;
+    std::chrono::steady_clock::time_point start_;
+
+  public:
+    KRB5KerberosKdcRecorder() = default;
+    ~KRB5KerberosKdcRecorder() = default;
+
+    [[nodiscard]] bool open(const std::string& path);
+    void close();
+    [[nodiscard]] bool is_open() const;
+    [[nodiscard]] bool record(KRB5KerberosKdcFrame::Direction direction, const krb5_data& data);
+};
+typedef std::unique_ptr<KRB5KerberosKdcRecorder> KRB5KerberosKdcRecorderUniquePtr;
+
+/**
+ * Answers kdc requests from a recording. Every request is matched by message type, realm and client / server
+ * principal against the recorded requests, searching forward from the previous match and rewinding once at the end,
+ * and answered with the response recorded right after it. A request without a recorded counterpart fails with
+ * KRB5_PRINC_NOMATCH, one that is not an AS / TGS request with KRB5KRB_AP_ERR_MSG_TYPE.
+ * libkrb5 binds every reply to the nonce of its request. Given the client password, AS replies are decrypted with
+ * the client key, TGS replies with the subkey of the recorded request, bound to the nonce, requested end times and
+ * request checksum of the live request and encrypted again for it, so replayed exchanges yield the recorded tickets
+ * and session keys. Without it replies are returned as recorded and libkrb5 fails them with KRB5_KDCREP_MODIFIED
+ * after the full client side processing, which still profiles the client side cost.
+ */
+class KRB5KerberosKdcReplayer
+{
+  private:
+    struct Key
+    {
+        krb5_enctype enctype = 0;
+        std::string contents;
+    };
+
+    struct Salt
+    {
+        std::string salt;
+        std::string params;
+        bool has_salt = false;
+    };
+
+  private:
+    std::vector<KRB5KerberosKdcFrame> frames_;
+    // Message type, realm and principals of every recorded request, empty for responses
+    std::vector<std::string> identities_;
+    std::size_t cursor_;
+    std::chrono::microseconds latency_;
+    // The live request and the recorded exchange it matched, until its response is replayed
+    std::string pending_request_;
+    std::size_t pending_match_;
+    encryption::SecureStringUniquePtr client_password_;
+    krb5_context ctx_;
+    // Client keys by enctype, salt and params
+    std::unordered_map<std::string, Key> client_keys_;
+    // Learned from the replies replayed so far, the session keys by ticket and the string to key salts by enctype
+    std::unordered_map<std::string, Key> session_keys_;
+    std::unordered_map<krb5_enctype, Salt> salts_;
+
+  private:
+    [[nodiscard]] krb5_error_code rebind_response(std::string_view recorded_request, std::string* response);
+    [[nodiscard]] krb5_error_code as_reply_key(std::string_view default_salt, krb5_enctype enctype, Key* key);
+    void learn_salts(std::string_view method_data);
+
+  public:
+    explicit KRB5KerberosKdcReplayer(std::chrono::microseconds latency = std::chrono::microseconds(0),
+                                     encryption::SecureStringUniquePtr client_password = nullptr);
+    ~KRB5KerberosKdcReplayer();
+    KRB5KerberosKdcReplayer(const KRB5KerberosKdcReplayer&) = delete;
+    KRB5KerberosKdcReplayer& operator=(const KRB5KerberosKdcReplayer&) = delete;
+
+    [[nodiscard]] bool load(const std::string& path);
+    [[nodiscard]] bool parse(const std::string& recording);
+    [[nodiscard]] krb5_error_code replay_request(const krb5_data& data);
+    [[nodiscard]] krb5_error_code replay_response(krb5_data* data);
+    [[nodiscard]] const std::vector<KRB5KerberosKdcFrame>& frames() const;
+    void rewind();
+};
+typedef std::unique_ptr<KRB5KerberosKdcReplayer> KRB5KerberosKdcReplayerUniquePtr;
+} // namespace octo::kerberos::krb5
+
+#endif
@@ -0,0 +1,173 @@
+/**
+ * @file krb5-kerberos-kdc-transport.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_KDC_TRANSPORT_HPP_
+#define KRB5_KERBEROS_KDC_TRANSPORT_HPP_
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-kdc-recording.hpp"
+#include <octo-logger-cpp/logger.hpp>
+#include <krb5/krb5.h>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace octo::kerberos::krb5
+{
+/**
+ * Message level transport used by the streamlined exchanges.
+ * send() receives a complete kdc request, receive() returns the matching complete kdc response allocated with
+ * malloc, the caller releases it with krb5_free_data_contents. Any framing is the transport's own business.
+ * A transport is used by a single authenticator at a time and does not need to be thread safe, authenticators
+ * therefore get theirs from a factory instead of sharing one instance.
+ */
+class KRB5KerberosKdcTransport
+{
+  public:
+    KRB5KerberosKdcTransport() = default;
+    virtual ~KRB5KerberosKdcTransport() = default;
+
+    [[nodiscard]] virtual bool connect() = 0;
+    virtual void disconnect() = 0;
+    [[nodiscard]] virtual bool is_connected() const = 0;
+    [[nodiscard]] virtual krb5_error_code send(const krb5_data& request) = 0;
+    [[nodiscard]] virtual krb5_error_code receive(krb5_data* response) = 0;
+};
+typedef std::shared_ptr<KRB5KerberosKdcTransport> KRB5KerberosKdcTransportPtr;
+// Called once per authenticator, every call returns a new transport
+typedef std::function<KRB5KerberosKdcTransportPtr()> KRB5KerberosKdcTransportFactory;
+
+// Kerberos over tcp, every message is prefixed with its 4 byte big endian length
+class KRB5KerberosTcpKdcTransport : public KRB5KerberosKdcTransport
+{
+  private:
+    std::string host_;
+    std::uint32_t port_;
+    std::string session_id_;
+    int fd_;
+    logger::Logger logger_;
+
+  private:
+    [[nodiscard]] int net_read(char* buf, int len);
+    [[nodiscard]] int net_write(const char* buf, int len);
+
+  public:
+    KRB5KerberosTcpKdcTransport(std::string host, std::uint32_t port, std::string session_id = "");
+    ~KRB5KerberosTcpKdcTransport() override;
+
+    [[nodiscard]] bool connect() override;
+    void disconnect() override;
+    [[nodiscard]] bool is_connected() const override;
+    [[nodiscard]] krb5_error_code send(const krb5_data& request) override;
+    [[nodiscard]] krb5_error_code receive(krb5_data* response) override;
+};
+
+// In process transport, every request is answered synchronously by the handler
+class KRB5KerberosLoopbackKdcTransport : public KRB5KerberosKdcTransport
+{
+  public:
+    typedef std::function<krb5_error_code(std::string_view request, std::string* response)> Handler;
+
+  private:
+    Handler handler_;
+    std::deque<std::string> responses_;
+    bool is_connected_;
+
+  public:
+    explicit KRB5KerberosLoopbackKdcTransport(Handler handler);
+    ~KRB5KerberosLoopbackKdcTransport() override = default;
+
+    [[nodiscard]] bool connect() override;
+    void disconnect() override;
+    [[nodiscard]] bool is_connected() const override;
+    [[nodiscard]] krb5_error_code send(const krb5_data& request) override;
+    [[nodiscard]] krb5_error_code receive(krb5_data* response) override;
+};
+
+// Wraps another transport and injects failures, corruption and latency
+class KRB5KerberosFaultInjectingKdcTransport : public KRB5KerberosKdcTransport
+{
+  public:
+    struct Faults
+    {
+        double send_failure_probability = 0;
+        double receive_failure_probability = 0;
+        double corruption_probability = 0;
+        std::chrono::microseconds latency = std::chrono::microseconds(0);
+        std::chrono::microseconds jitter = std::chrono::microseconds(0);
+        std::uint32_t seed = 0;
+    };
+
+  private:
+    KRB5KerberosKdcTransportPtr inner_;
+    Faults faults_;
+    std::mt19937 generator_;
+
+  private:
+    [[nodiscard]] bool roll(double probability);
+
+  public:
+    KRB5KerberosFaultInjectingKdcTransport(KRB5KerberosKdcTransportPtr inner, Faults faults);
+    ~KRB5KerberosFaultInjectingKdcTransport() override = default;
+
+    [[nodiscard]] bool connect() override;
+    void disconnect() override;
+    [[nodiscard]] bool is_connected() const override;
+    [[nodiscard]] krb5_error_code send(const krb5_data& request) override;
+    [[nodiscard]] krb5_error_code receive(krb5_data* response) override;
+};
+
+// Wraps another transport and records every request / response to a file
+class KRB5KerberosRecordingKdcTransport : public KRB5KerberosKdcTransport
+{
+  private:
+    KRB5KerberosKdcTransportPtr inner_;
+    std::string path_;
+    KRB5KerberosKdcRecorder recorder_;
+
+  public:
+    KRB5KerberosRecordingKdcTransport(KRB5KerberosKdcTransportPtr inner, std::string path);
+    ~KRB5KerberosRecordingKdcTransport() override = default;
+
+    [[nodiscard]] bool connect() override;
+    void disconnect() override;
+    [[nodiscard]] bool is_connected() const override;
+    [[nodiscard]] krb5_error_code send(const krb5_data& request) override;
+    [[nodiscard]] krb5_error_code receive(krb5_data* response) override;
+};
+
+// Answers from a recording, see KRB5KerberosKdcReplayer for the replay semantics
+class KRB5KerberosReplayKdcTransport : public KRB5KerberosKdcTransport
+{
+  private:
+    std::string path_;
+    KRB5KerberosKdcReplayer replayer_;
+    bool is_connected_;
+
+  public:
+    // Given the client password the replies are bound to the live requests, see KRB5KerberosKdcReplayer
+    explicit KRB5KerberosReplayKdcTransport(std::string path,
+                                            std::chrono::microseconds latency = std::chrono::microseconds(0),
+                                            encryption::SecureStringUniquePtr client_password = nullptr);
+    ~KRB5KerberosReplayKdcTransport() override = default;
+
+    [[nodiscard]] bool connect() override;
+    void disconnect() override;
+    [[nodiscard]] bool is_connected() const override;
+    [[nodiscard]] krb5_error_code send(const krb5_data& request) override;
+    [[nodiscard]] krb5_error_code receive(krb5_data* response) override;
+};
+} // namespace octo::kerberos::krb5
+
+#endif
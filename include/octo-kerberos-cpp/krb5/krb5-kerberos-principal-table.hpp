@@ -0,0 +1,93 @@
+/**
+ * @file krb5-kerberos-principal-table.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_PRINCIPAL_TABLE_HPP_
+#define KRB5_KERBEROS_PRINCIPAL_TABLE_HPP_
+
+#include <krb5/krb5.h>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+constexpr const auto DEFAULT_KERBEROS_PRINCIPAL_TABLE_CAPACITY = 4096;
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+/**
+ * Intern table of parsed principals. Each principal name is parsed once and kept with a small id, the entries are
+ * immutable and ids are never reused, so ids and principals can be used as cache keys freely.
+ * The table keeps up to capacity principals. Interning past it evicts one that was not looked up since the last
+ * eviction pass over it (second chance), an evicted name is parsed again with a new id on its next use. Entries are
+ * shared, an entry in use stays valid after its eviction until the last reference to it is gone.
+ * Names are parsed as given, unqualified names take the default realm of the context interning them first, a table
+ * is therefore only shared between contexts of the same realm.
+ * The table is thread safe.
+ */
+class KRB5KerberosPrincipalTable
+{
+  public:
+    typedef std::uint32_t Id;
+
+    struct Entry
+    {
+        Id id;
+        std::string name;
+        // Read only, released with the entry
+        krb5_principal principal;
+    };
+    typedef std::shared_ptr<const Entry> EntryPtr;
+
+  private:
+    struct Slot
+    {
+        EntryPtr entry;
+        // Set by lookups, cleared when the eviction pass spares the entry
+        mutable std::atomic<bool> is_referenced{false};
+    };
+
+  private:
+    const std::size_t capacity_;
+    mutable std::shared_mutex mutex_;
+    Id next_id_ = 0;
+    // Keys view the names of their entries
+    std::unordered_map<std::string_view, Slot> index_;
+    std::unordered_map<Id, std::string_view> ids_;
+    // Eviction order, oldest first
+    std::deque<std::string_view> order_;
+
+  private:
+    void evict();
+
+  public:
+    explicit KRB5KerberosPrincipalTable(std::size_t capacity = DEFAULT_KERBEROS_PRINCIPAL_TABLE_CAPACITY);
+    KRB5KerberosPrincipalTable(const KRB5KerberosPrincipalTable&) = delete;
+    KRB5KerberosPrincipalTable& operator=(const KRB5KerberosPrincipalTable&) = delete;
+
+    // The entry of name, parsing it with ctx on first use, returns the krb5_parse_name error on failure
+    [[nodiscard]] krb5_error_code intern(std::string_view name, krb5_context ctx, EntryPtr* entry);
+    // Lookups of interned principals, null when missing or evicted
+    [[nodiscard]] EntryPtr find(std::string_view name) const;
+    [[nodiscard]] EntryPtr find(Id id) const;
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] std::size_t capacity() const;
+};
+typedef std::shared_ptr<KRB5KerberosPrincipalTable> KRB5KerberosPrincipalTablePtr;
+} // namespace octo::kerberos::krb5
+
+#endif
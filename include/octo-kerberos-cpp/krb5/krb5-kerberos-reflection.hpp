@@ -0,0 +1,415 @@
+/**
+ * @file krb5-kerberos-reflection.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_REFLECTION_HPP_
+#define KRB5_KERBEROS_REFLECTION_HPP_
+
+#include <krb5/krb5.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace octo::kerberos::krb5
+{
+/**
+ * Compile time description of the krb5 structs the serializer handles. Each codec (json document, json text, json
+ * writer, binary) is written once against these descriptions instead of once per struct.
+ * Fields are listed in binary order. Json keys are written in the order dump() sorts them into, which is computed at
+ * compile time, and keys read from a document are matched by their precomputed hash before being compared.
+ */
+enum class KRB5KerberosFieldKind
+{
+    // Integer, u32 in binary
+    Number,
+    // Integer holding a boolean, u8 in binary
+    Flag,
+    // Contents and length pair, base64 under its key with the size under "length", counted in binary
+    Blob,
+    // Described struct held by value
+    Struct,
+    // Optional pointer to a described struct, the key is left out and the presence bit unset when null
+    Pointer,
+    // Optional null terminated list of pointers to a described struct, left out the same way when null
+    List,
+    // Principal components, an optional "data" array next to a "length" key, a u32 count in binary
+    Components,
+    // Binary only, a u8 holding the presence bits of the optional fields
+    Presence,
+};
+
+template <typename T>
+struct KRB5KerberosReflection;
+
+template <typename Owner, typename T>
+struct KRB5KerberosNumberField
+{
+    static constexpr auto kind = KRB5KerberosFieldKind::Number;
+    const char* key;
+    T Owner::*member;
+};
+
+template <typename Owner, typename T>
+struct KRB5KerberosFlagField
+{
+    static constexpr auto kind = KRB5KerberosFieldKind::Flag;
+    const char* key;
+    T Owner::*member;
+};
+
+template <typename Owner, typename T>
+struct KRB5KerberosBlobField
+{
+    static constexpr auto kind = KRB5KerberosFieldKind::Blob;
+    const char* key;
+    T* Owner::*contents;
+    unsigned int Owner::*length;
+};
+
+template <typename Owner, typename T>
+struct KRB5KerberosStructField
+{
+    static constexpr auto kind = KRB5KerberosFieldKind::Struct;
+    typedef T Type;
+    const char* key;
+    T Owner::*member;
+};
+
+template <typename Owner, typename T>
+struct KRB5KerberosPointerField
+{
+    static constexpr auto kind = KRB5KerberosFieldKind::Pointer;
+    typedef T Type;
+    const char* key;
+    T* Owner::*member;
+};
+
+template <typename Owner, typename T>
+struct KRB5KerberosListField
+{
+    static constexpr auto kind = KRB5KerberosFieldKind::List;
+    typedef T Type;
+    const char* key;
+    T** Owner::*member;
+};
+
+template <typename Owner, typename T, typename Length>
+struct KRB5KerberosComponentsField
+{
+    static constexpr auto kind = KRB5KerberosFieldKind::Components;
+    typedef T Type;
+    const char* key;
+    T* Owner::*entries;
+    Length Owner::*length;
+};
+
+struct KRB5KerberosPresenceField
+{
+    static constexpr auto kind = KRB5KerberosFieldKind::Presence;
+};
+
+template <typename Owner, typename T>
+KRB5KerberosNumberField(const char*, T Owner::*) -> KRB5KerberosNumberField<Owner, T>;
+template <typename Owner, typename T>
+KRB5KerberosFlagField(const char*, T Owner::*) -> KRB5KerberosFlagField<Owner, T>;
+template <typename Owner, typename T>
+KRB5KerberosBlobField(const char*, T* Owner::*, unsigned int Owner::*) -> KRB5KerberosBlobField<Owner, T>;
+template <typename Owner, typename T>
+KRB5KerberosStructField(const char*, T Owner::*) -> KRB5KerberosStructField<Owner, T>;
+template <typename Owner, typename T>
+KRB5KerberosPointerField(const char*, T* Owner::*) -> KRB5KerberosPointerField<Owner, T>;
+template <typename Owner, typename T>
+KRB5KerberosListField(const char*, T** Owner::*) -> KRB5KerberosListField<Owner, T>;
+template <typename Owner, typename T, typename Length>
+KRB5KerberosComponentsField(const char*, T* Owner::*, Length Owner::*)
+    -> KRB5KerberosComponentsField<Owner, T, Length>;
+
+template <>
+struct KRB5KerberosReflection<krb5_data>
+{
+    static constexpr auto fields =
+        std::make_tuple(KRB5KerberosNumberField{"magic", &krb5_data::magic},
+                        KRB5KerberosBlobField{"data", &krb5_data::data, &krb5_data::length});
+};
+
+template <>
+struct KRB5KerberosReflection<krb5_keyblock>
+{
+    static constexpr auto fields =
+        std::make_tuple(KRB5KerberosNumberField{"magic", &krb5_keyblock::magic},
+                        KRB5KerberosNumberField{"enctype", &krb5_keyblock::enctype},
+                        KRB5KerberosBlobField{"contents", &krb5_keyblock::contents, &krb5_keyblock::length});
+};
+
+template <>
+struct KRB5KerberosReflection<krb5_ticket_times>
+{
+    static constexpr auto fields =
+        std::make_tuple(KRB5KerberosNumberField{"authtime", &krb5_ticket_times::authtime},
+                        KRB5KerberosNumberField{"starttime", &krb5_ticket_times::starttime},
+                        KRB5KerberosNumberField{"endtime", &krb5_ticket_times::endtime},
+                        KRB5KerberosNumberField{"renew_till", &krb5_ticket_times::renew_till});
+};
+
+template <>
+struct KRB5KerberosReflection<krb5_address>
+{
+    static constexpr auto fields =
+        std::make_tuple(KRB5KerberosNumberField{"magic", &krb5_address::magic},
+                        KRB5KerberosNumberField{"addrtype", &krb5_address::addrtype},
+                        KRB5KerberosBlobField{"contents", &krb5_address::contents, &krb5_address::length});
+};
+
+template <>
+struct KRB5KerberosReflection<krb5_authdata>
+{
+    static constexpr auto fields =
+        std::make_tuple(KRB5KerberosNumberField{"magic", &krb5_authdata::magic},
+                        KRB5KerberosNumberField{"ad_type", &krb5_authdata::ad_type},
+                        KRB5KerberosBlobField{"contents", &krb5_authdata::contents, &krb5_authdata::length});
+};
+
+template <>
+struct KRB5KerberosReflection<krb5_principal_data>
+{
+    static constexpr auto fields = std::make_tuple(
+        KRB5KerberosNumberField{"magic", &krb5_principal_data::magic},
+        KRB5KerberosStructField{"realm", &krb5_principal_data::realm},
+        KRB5KerberosComponentsField{"data", &krb5_principal_data::data, &krb5_principal_data::length},
+        KRB5KerberosNumberField{"type", &krb5_principal_data::type});
+};
+
+template <>
+struct KRB5KerberosReflection<krb5_creds>
+{
+    static constexpr auto fields = std::make_tuple(KRB5KerberosNumberField{"magic", &krb5_creds::magic},
+                                                   KRB5KerberosPresenceField{},
+                                                   KRB5KerberosPointerField{"client", &krb5_creds::client},
+                                                   KRB5KerberosPointerField{"server", &krb5_creds::server},
+                                                   KRB5KerberosStructField{"keyblock", &krb5_creds::keyblock},
+                                                   KRB5KerberosStructField{"times", &krb5_creds::times},
+                                                   KRB5KerberosFlagField{"is_skey", &krb5_creds::is_skey},
+                                                   KRB5KerberosNumberField{"ticket_flags", &krb5_creds::ticket_flags},
+                                                   KRB5KerberosListField{"addresses", &krb5_creds::addresses},
+                                                   KRB5KerberosStructField{"ticket", &krb5_creds::ticket},
+                                                   KRB5KerberosStructField{"second_ticket", &krb5_creds::second_ticket},
+                                                   KRB5KerberosListField{"authdata", &krb5_creds::authdata});
+};
+
+// A json key of a described struct, blobs and components own a second "length" key
+struct KRB5KerberosKey
+{
+    std::string_view name;
+    std::uint32_t hash;
+    std::size_t field;
+    bool is_length;
+    bool is_required;
+
+    // FNV-1a
+    static constexpr std::uint32_t hash_of(std::string_view name)
+    {
+        std::uint32_t hash = 2166136261u;
+        for (const auto c : name)
+        {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+        }
+        return hash;
+    }
+};
+
+template <typename T>
+class KRB5KerberosFieldTable
+{
+  private:
+    typedef std::decay_t<decltype(KRB5KerberosReflection<T>::fields)> Fields;
+    static constexpr std::size_t FIELD_COUNT = std::tuple_size_v<Fields>;
+
+    template <typename Field>
+    static constexpr std::size_t key_count()
+    {
+        if constexpr (Field::kind == KRB5KerberosFieldKind::Presence)
+        {
+            return 0;
+        }
+        else if constexpr (Field::kind == KRB5KerberosFieldKind::Blob
+                           || Field::kind == KRB5KerberosFieldKind::Components)
+        {
+            return 2;
+        }
+        return 1;
+    }
+
+    template <typename Field>
+    static constexpr bool is_optional()
+    {
+        return Field::kind == KRB5KerberosFieldKind::Pointer || Field::kind == KRB5KerberosFieldKind::List;
+    }
+
+    template <typename Field>
+    static constexpr std::size_t binary_size()
+    {
+        if constexpr (Field::kind == KRB5KerberosFieldKind::Struct)
+        {
+            return KRB5KerberosFieldTable<typename Field::Type>::binary_min_size();
+        }
+        else if constexpr (Field::kind == KRB5KerberosFieldKind::Flag
+                           || Field::kind == KRB5KerberosFieldKind::Presence)
+        {
+            return 1;
+        }
+        else if constexpr (is_optional<Field>())
+        {
+            return 0;
+        }
+        return 4;
+    }
+
+    template <typename Field>
+    static constexpr void add_keys(const Field& field, std::size_t index, KRB5KerberosKey* keys, std::size_t* count)
+    {
+        if constexpr (key_count<Field>() > 0)
+        {
+            // Components are only read when both of their keys are present
+            const auto is_required = !is_optional<Field>() && Field::kind != KRB5KerberosFieldKind::Components;
+            keys[(*count)++] = {field.key, KRB5KerberosKey::hash_of(field.key), index, false, is_required};
+            if constexpr (key_count<Field>() > 1)
+            {
+                keys[(*count)++] = {"length", KRB5KerberosKey::hash_of("length"), index, true, is_required};
+            }
+        }
+    }
+
+    template <std::size_t... I>
+    static constexpr auto make_keys(std::index_sequence<I...>)
+    {
+        std::array<KRB5KerberosKey, (key_count<std::tuple_element_t<I, Fields>>() + ... + 0)> keys{};
+        std::size_t count = 0;
+        (add_keys(std::get<I>(KRB5KerberosReflection<T>::fields), I, keys.data(), &count), ...);
+        for (std::size_t i = 1; i < keys.size(); ++i)
+        {
+            for (auto j = i; j > 0 && keys[j].name < keys[j - 1].name; --j)
+            {
+                const auto key = keys[j];
+                keys[j] = keys[j - 1];
+                keys[j - 1] = key;
+            }
+        }
+        return keys;
+    }
+
+    template <std::size_t... I>
+    static constexpr std::uint8_t presence_bit(std::index_sequence<I...>)
+    {
+        return static_cast<std::uint8_t>(1 << (std::size_t(is_optional<std::tuple_element_t<I, Fields>>()) + ... + 0));
+    }
+
+    template <std::size_t... I>
+    static constexpr std::size_t binary_min_size(std::index_sequence<I...>)
+    {
+        return (binary_size<std::tuple_element_t<I, Fields>>() + ... + 0);
+    }
+
+    template <typename F, std::size_t... I>
+    static void for_each_field(F& visit, std::index_sequence<I...>)
+    {
+        (visit(std::get<I>(KRB5KerberosReflection<T>::fields), std::integral_constant<std::size_t, I>{}), ...);
+    }
+
+    template <typename F, std::size_t... I>
+    static bool all_fields(F& visit, std::index_sequence<I...>)
+    {
+        return (visit(std::get<I>(KRB5KerberosReflection<T>::fields), std::integral_constant<std::size_t, I>{}) && ...);
+    }
+
+    template <typename F, std::size_t... I>
+    static void for_each_key(F& visit, std::index_sequence<I...>)
+    {
+        (visit(std::get<keys[I].field>(KRB5KerberosReflection<T>::fields), std::bool_constant<keys[I].is_length>{}),
+         ...);
+    }
+
+    template <typename F, std::size_t... I>
+    static bool visit_key(std::string_view name, F& visit, std::index_sequence<I...>)
+    {
+        const auto hash = KRB5KerberosKey::hash_of(name);
+        auto result = true;
+        (void)((hash == keys[I].hash && name == keys[I].name
+                && (result = visit(std::get<keys[I].field>(KRB5KerberosReflection<T>::fields),
+                                   std::integral_constant<std::size_t, I>{},
+                                   std::bool_constant<keys[I].is_length>{}),
+                    true))
+               || ...);
+        return result;
+    }
+
+  public:
+    // Sorted by name
+    static constexpr auto keys = make_keys(std::make_index_sequence<FIELD_COUNT>{});
+
+    // Mask over keys of the ones a document must hold
+    static constexpr std::uint64_t required_keys()
+    {
+        static_assert(keys.size() <= 64, "keys are tracked in a 64 bit mask");
+        std::uint64_t required = 0;
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            required |= keys[i].is_required ? std::uint64_t(1) << i : 0;
+        }
+        return required;
+    }
+
+    // Bit of the optional field at the given index within the presence field
+    template <std::size_t Index>
+    static constexpr std::uint8_t presence_bit()
+    {
+        return presence_bit(std::make_index_sequence<Index>{});
+    }
+
+    // Smallest binary encoding of the struct, bounds the counts a binary reader accepts
+    static constexpr std::size_t binary_min_size()
+    {
+        return binary_min_size(std::make_index_sequence<FIELD_COUNT>{});
+    }
+
+    // visit(field, index) for every field in field order
+    template <typename F>
+    static void for_each_field(F&& visit)
+    {
+        for_each_field(visit, std::make_index_sequence<FIELD_COUNT>{});
+    }
+
+    // visit(field, index) for every field in field order until one returns false
+    template <typename F>
+    [[nodiscard]] static bool all_fields(F&& visit)
+    {
+        return all_fields(visit, std::make_index_sequence<FIELD_COUNT>{});
+    }
+
+    // visit(field, is_length) for every key in key order
+    template <typename F>
+    static void for_each_key(F&& visit)
+    {
+        for_each_key(visit, std::make_index_sequence<keys.size()>{});
+    }
+
+    // Returns visit(field, key_index, is_length) for the key of the given name, unknown names return true
+    template <typename F>
+    [[nodiscard]] static bool visit_key(std::string_view name, F&& visit)
+    {
+        return visit_key(name, visit, std::make_index_sequence<keys.size()>{});
+    }
+};
+} // namespace octo::kerberos::krb5
+
+#endif
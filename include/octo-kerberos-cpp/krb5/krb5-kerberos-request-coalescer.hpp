@@ -0,0 +1,128 @@
+/**
+ * @file krb5-kerberos-request-coalescer.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_REQUEST_COALESCER_HPP_
+#define KRB5_KERBEROS_REQUEST_COALESCER_HPP_
+
+#include "octo-kerberos-cpp/kerberos-ticket.hpp"
+#include "octo-kerberos-cpp/kerberos-user-credentials.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-service-ticket.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-tgt-ticket.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+constexpr const auto DEFAULT_KERBEROS_COALESCER_WAIT_TIMEOUT_MS = 30000;
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+/**
+ * Singleflight for kdc exchanges. The first caller asking for a (client, service, lifetime) ticket runs the exchange,
+ * callers asking for the same one while it is in flight wait for it and get a copy of its result instead of running
+ * their own. Failures reach every waiter, and when a negative ttl is given, callers asking again within it fail right
+ * away instead of hitting the kdc. Only failures the password has no part in are cached this way, an unknown or
+ * expired principal, so a wrong password never locks out the right one and every password attempt still reaches the
+ * kdc and its lockout policy. A tgt exchange is only shared by callers with the same password.
+ * Waiters give up on an exchange still in flight after the wait timeout and run their own.
+ * The result belongs to the authenticator that ran the exchange, see KRB5KerberosAuthenticator for taking it over.
+ * Meant to be shared by the authenticators of a single realm through their settings, the coalescer is thread safe.
+ */
+class KRB5KerberosRequestCoalescer
+{
+  public:
+    // Requests set error to the krb5 error a failed exchange ended with, or leave it 0 when there is none
+    typedef std::function<KRB5KerberosTGTTicketUniquePtr(krb5_error_code* error)> TGTRequest;
+    typedef std::function<KRB5KerberosServiceTicketUniquePtr(krb5_error_code* error)> ServiceTicketRequest;
+
+    struct Statistics
+    {
+        // Exchanges actually run
+        std::uint64_t leaders;
+        // Callers served by the exchange of another
+        std::uint64_t coalesced;
+        // Callers failed by the negative cache
+        std::uint64_t negative_hits;
+        // Callers that gave up waiting and ran their own exchange
+        std::uint64_t wait_timeouts;
+    };
+
+  private:
+    typedef std::function<KerberosTicketUniquePtr(krb5_error_code* error)> Request;
+
+    struct Flight
+    {
+        bool is_done = false;
+        // Null when the exchange failed
+        KerberosTicketUniquePtr ticket;
+        std::condition_variable done_cv;
+        // Of the leader, only set for tgt exchanges, which are only joined with the same one
+        const encryption::SecureString* password = nullptr;
+    };
+
+  private:
+    std::chrono::milliseconds negative_ttl_;
+    std::chrono::milliseconds wait_timeout_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Flight>> flights_;
+    std::unordered_map<std::string, std::chrono::time_point<std::chrono::steady_clock>> failures_;
+    std::atomic<std::uint64_t> leaders_;
+    std::atomic<std::uint64_t> coalesced_;
+    std::atomic<std::uint64_t> negative_hits_;
+    std::atomic<std::uint64_t> wait_timeouts_;
+
+  private:
+    // Length prefixed, principal names contain the separators of any plain concatenation
+    [[nodiscard]] static std::string make_key(char kind, std::initializer_list<std::string_view> fields);
+    [[nodiscard]] KerberosTicketUniquePtr run(const std::string& key,
+                                              const encryption::SecureString* password,
+                                              const Request& request);
+    // Whether error holds whatever the password, the only failures worth caching
+    [[nodiscard]] static bool is_definitive(krb5_error_code error);
+    // Must hold mutex_
+    [[nodiscard]] bool is_negative(const std::string& key);
+    void record_failure(const std::string& key);
+
+  public:
+    // A zero negative ttl disables the negative cache
+    explicit KRB5KerberosRequestCoalescer(
+        std::chrono::milliseconds negative_ttl = std::chrono::milliseconds(0),
+        std::chrono::milliseconds wait_timeout = std::chrono::milliseconds(DEFAULT_KERBEROS_COALESCER_WAIT_TIMEOUT_MS));
+    KRB5KerberosRequestCoalescer(const KRB5KerberosRequestCoalescer&) = delete;
+    KRB5KerberosRequestCoalescer& operator=(const KRB5KerberosRequestCoalescer&) = delete;
+
+    // Runs request, or waits for the identical one in flight, null when the exchange failed. Exceptions of request
+    // propagate to the caller that ran it, its waiters get null
+    [[nodiscard]] KRB5KerberosTGTTicketUniquePtr generate_tgt(const KerberosUserCredentials& creds,
+                                                              std::chrono::seconds lifetime,
+                                                              const TGTRequest& request);
+    [[nodiscard]] KRB5KerberosServiceTicketUniquePtr generate_service_ticket(const KRB5KerberosTGTTicket& tgt,
+                                                                             const std::string& service,
+                                                                             std::chrono::seconds lifetime,
+                                                                             const ServiceTicketRequest& request);
+
+    [[nodiscard]] std::size_t in_flight();
+    [[nodiscard]] Statistics statistics() const;
+};
+typedef std::shared_ptr<KRB5KerberosRequestCoalescer> KRB5KerberosRequestCoalescerPtr;
+} // namespace octo::kerberos::krb5
+
+#endif
@@ -12,16 +12,32 @@
 #ifndef KRB5_KERBEROS_SERIALIZER_HPP_
 #define KRB5_KERBEROS_SERIALIZER_HPP_
 
+#include "octo-kerberos-cpp/kerberos-ticket.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-json-writer.hpp"
 #include <nlohmann/json.hpp>
 #include <krb5/krb5.h>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace octo::kerberos::krb5
 {
-class KRB5KerberosSerializer
+// Fields of a serialized ticket that can be read without materializing its creds
+struct KRB5KerberosTicketHeader
 {
-  private:
-    static void cleanup_creds(krb5_creds* creds);
+    // Tgt user or service
+    std::string name;
+    std::chrono::time_point<std::chrono::system_clock> expiration;
+    // krb5_unparse_name format, empty when the creds have no such principal
+    std::string client;
+    std::string server;
+    krb5_ticket_times times;
+    krb5_flags ticket_flags;
+};
 
+class KRB5KerberosSerializer
+{
   public:
     KRB5KerberosSerializer() = default;
     ~KRB5KerberosSerializer() = default;
@@ -35,6 +51,15 @@ class KRB5KerberosSerializer
     [[nodiscard]] static nlohmann::json serialize_authdata(const krb5_authdata& authdata);
     [[nodiscard]] static nlohmann::json serialize_creds(const krb5_creds& creds);
 
+    // Serialize straight to json text, byte identical to dump() of the above
+    static void serialize_principal_data(const krb5_principal_data& principal_data, KRB5KerberosJsonWriter* writer);
+    static void serialize_data(const krb5_data& data, KRB5KerberosJsonWriter* writer);
+    static void serialize_keyblock(const krb5_keyblock& keyblock, KRB5KerberosJsonWriter* writer);
+    static void serialize_times(const krb5_ticket_times& times, KRB5KerberosJsonWriter* writer);
+    static void serialize_address(const krb5_address& address, KRB5KerberosJsonWriter* writer);
+    static void serialize_authdata(const krb5_authdata& authdata, KRB5KerberosJsonWriter* writer);
+    static void serialize_creds(const krb5_creds& creds, KRB5KerberosJsonWriter* writer);
+
     // Deserialize
     [[nodiscard]] static bool deserialize_principal_data(const nlohmann::json& j, krb5_principal_data* principal_data);
     [[nodiscard]] static bool deserialize_data(const nlohmann::json& j, krb5_data* data);
@@ -43,6 +68,70 @@ class KRB5KerberosSerializer
     [[nodiscard]] static bool deserialize_address(const nlohmann::json& j, krb5_address* address);
     [[nodiscard]] static bool deserialize_authdata(const nlohmann::json& j, krb5_authdata* authdata);
     [[nodiscard]] static bool deserialize_creds(const nlohmann::json& j, krb5_creds* creds, krb5_context ctx);
+
+    // Binary, raw blobs with length prefixes instead of base64 and no repeated keys
+    static void serialize_creds_binary(const krb5_creds& creds, std::string* out);
+    [[nodiscard]] static std::string serialize_creds_binary(const krb5_creds& creds);
+    [[nodiscard]] static bool deserialize_creds_binary(std::string_view data, krb5_creds* creds, krb5_context ctx);
+
+    // Versioned ticket envelope around the binary creds, shared by the tgt and service ticket formats
+    [[nodiscard]] static std::string serialize_ticket_binary(
+        KerberosTicket::Type type,
+        std::string_view name,
+        const std::chrono::time_point<std::chrono::system_clock>& expiration,
+        const krb5_creds& creds);
+    // Validates the envelope and returns views of its fields, the creds are left encoded
+    [[nodiscard]] static bool split_ticket_binary(std::string_view data,
+                                                  KerberosTicket::Type type,
+                                                  std::string_view* name,
+                                                  std::chrono::time_point<std::chrono::system_clock>* expiration,
+                                                  std::string_view* creds);
+    [[nodiscard]] static bool deserialize_ticket_binary(std::string_view data,
+                                                        KerberosTicket::Type type,
+                                                        std::string* name,
+                                                        std::chrono::time_point<std::chrono::system_clock>* expiration,
+                                                        krb5_creds* creds,
+                                                        krb5_context ctx);
+
+    // Json text parsed on demand (simdjson) straight into the creds, without building the document first. Accepts the
+    // same documents as the nlohmann based functions, the last of repeated keys wins in both
+    [[nodiscard]] static bool deserialize_creds_text(std::string_view text, krb5_creds* creds, krb5_context ctx);
+    // Same document as serialize().dump() of the tgt or service ticket of the given type
+    [[nodiscard]] static bool deserialize_ticket_text(std::string_view text,
+                                                      KerberosTicket::Type type,
+                                                      std::string* name,
+                                                      std::chrono::time_point<std::chrono::system_clock>* expiration,
+                                                      krb5_creds* creds,
+                                                      krb5_context ctx);
+
+    // Peek, reads the header of a serialized ticket without decoding its key, ticket, address or authdata blobs and
+    // without allocating creds. Only the parts that are read are validated
+    [[nodiscard]] static bool peek_ticket_text(std::string_view text,
+                                               KerberosTicket::Type type,
+                                               KRB5KerberosTicketHeader* header);
+    [[nodiscard]] static bool peek_ticket_binary(std::string_view data,
+                                                 KerberosTicket::Type type,
+                                                 KRB5KerberosTicketHeader* header);
+
+    // Contiguous, the whole creds graph is laid out in a single allocation which must only be released with
+    // free_creds_contiguous, never with the krb5_free_* family. Suited for creds that are not modified afterwards
+    [[nodiscard]] static krb5_creds* deserialize_creds_contiguous(const nlohmann::json& j);
+    [[nodiscard]] static krb5_creds* deserialize_creds_binary_contiguous(std::string_view data);
+    // Zeroizes the whole block, keys and tickets included, before releasing it
+    static void free_creds_contiguous(krb5_creds* creds);
+
+    // MIT ccache v4 (FILE:) encoding, for a single creds entry or a whole cache with its default principal
+    static void serialize_ccache_creds(const krb5_creds& creds, std::string* out);
+    [[nodiscard]] static bool deserialize_ccache_creds(std::string_view data, krb5_creds* creds, krb5_context ctx);
+    [[nodiscard]] static std::string serialize_ccache(const krb5_principal_data& default_principal,
+                                                      const std::vector<const krb5_creds*>& creds);
+    // Parses v3 or v4 straight into the given creds, the caller releases each one with krb5_free_cred_contents
+    [[nodiscard]] static bool deserialize_ccache(std::string_view data,
+                                                 krb5_principal* default_principal,
+                                                 std::vector<krb5_creds>* creds,
+                                                 krb5_context ctx);
+    // Config entries (X-CACHECONF: realm) store cache metadata, not tickets
+    [[nodiscard]] static bool is_ccache_config_creds(const krb5_creds& creds);
 };
 } // namespace octo::kerberos::krb5
 #endif
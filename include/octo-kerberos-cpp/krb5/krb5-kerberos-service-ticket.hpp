@@ -13,38 +13,64 @@
 #define KRB5_KERBEROS_SERVICE_TICKET_HPP_
 
 #include "octo-kerberos-cpp/kerberos-ticket.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-creds.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-json-writer.hpp"
 #include <krb5/krb5.h>
 #include <memory>
 #include <chrono>
+#include <cstddef>
 #include <string>
 
 namespace octo::kerberos::krb5
 {
-class KRB5KerberosServiceTicket : public KerberosTicket
+class KRB5KerberosServiceTicket final : public KerberosTicket
 {
   private:
     std::string service_;
-    krb5_creds* service_ticket_;
+    // Shared with the copies of this ticket, see KRB5KerberosCredsPtr
+    KRB5KerberosCredsPtr service_ticket_;
     std::chrono::time_point<std::chrono::system_clock> service_ticket_expiration_;
     krb5_context ctx_;
+    // Deserialize into a single contiguous allocation, see KRB5KerberosSerializer::deserialize_creds_contiguous
+    bool contiguous_;
+
+  private:
+    void serialize_to(KRB5KerberosJsonWriter* writer) const;
 
   public:
     explicit KRB5KerberosServiceTicket(std::string service = "",
                                        const std::chrono::time_point<std::chrono::system_clock>&
                                            service_ticket_expiration = std::chrono::system_clock::now());
-    ~KRB5KerberosServiceTicket() override;
+    KRB5KerberosServiceTicket(const KRB5KerberosServiceTicket& other) = default;
+    KRB5KerberosServiceTicket& operator=(const KRB5KerberosServiceTicket& other) = default;
+    ~KRB5KerberosServiceTicket() override = default;
+
+    // Pooled in KRB5KerberosSlabPool like KRB5KerberosTGTTicket
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr) noexcept;
 
     [[nodiscard]] encryption::SecureString ticket() const override;
     [[nodiscard]] encryption::SecureString encoded_ticket() const override;
+    [[nodiscard]] std::string_view ticket_view() const override;
+    [[nodiscard]] std::string_view encoded_ticket_view() const override;
     [[nodiscard]] std::string ticket_purpose() const override;
     [[nodiscard]] KerberosTicket::Type ticket_type() const override;
     [[nodiscard]] const std::chrono::time_point<std::chrono::system_clock>& ticket_expiration_time() const override;
 
+    [[nodiscard]] std::unique_ptr<KerberosTicket> clone() const override;
+
     [[nodiscard]] nlohmann::json serialize() const override;
     [[nodiscard]] bool deserialize(const nlohmann::json& json) override;
+    void serialize_to(std::string* out) const override;
+    void serialize_to(std::ostream& out) const override;
+    [[nodiscard]] bool deserialize_text(std::string_view text) override;
+    [[nodiscard]] std::string serialize_binary() const override;
+    [[nodiscard]] bool deserialize_binary(std::string_view data) override;
 
     [[nodiscard]] std::string service() const;
     [[nodiscard]] krb5_context krb_context() const;
+    // Zeroed creds for a ticket that was not generated or deserialized
+    [[nodiscard]] const krb5_creds& krb_creds() const;
 
     friend class KRB5KerberosAuthenticator;
 };
@@ -0,0 +1,82 @@
+/**
+ * @file krb5-kerberos-slab-pool.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_SLAB_POOL_HPP_
+#define KRB5_KERBEROS_SLAB_POOL_HPP_
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace octo::kerberos::krb5
+{
+/**
+ * Slab allocator for the fixed size objects allocated per ticket, the tickets themselves and their creds.
+ * Blocks are carved out of slabs of SLAB_BLOCKS and recycled through a per thread cache, which trades batches with a
+ * shared depot, so allocating and releasing a ticket takes no lock in the steady state. Released blocks are zeroized.
+ * Slabs are kept for the life of the process, the memory held is bounded by the peak number of live objects and
+ * does not fragment the heap as tickets churn.
+ * Building with KRB5_KERBEROS_DISABLE_SLAB_POOL serves every block from the heap instead, still zeroized on release.
+ */
+class KRB5KerberosSlabPool
+{
+  public:
+    static constexpr std::size_t SLAB_BLOCKS = 64;
+    // A thread holding more free blocks than this hands half of them back to the depot
+    static constexpr std::size_t THREAD_CACHE_BLOCKS = 128;
+    // Pools beyond this many have no thread cache and go through the depot lock
+    static constexpr std::size_t MAX_POOLS = 8;
+
+  private:
+    struct Block;
+    struct ThreadCache;
+
+    std::size_t block_size_;
+    std::size_t id_;
+    mutable std::mutex mutex_;
+    Block* depot_;
+    std::size_t depot_blocks_;
+    std::size_t slabs_;
+
+  private:
+    explicit KRB5KerberosSlabPool(std::size_t block_size);
+    [[nodiscard]] static KRB5KerberosSlabPool* create(std::size_t block_size);
+    // Null once the calling thread is exiting and its cache is gone
+    [[nodiscard]] static ThreadCache* thread_cache();
+
+    // Moves up to SLAB_BLOCKS free blocks out of the depot, carving a new slab when it is empty
+    [[nodiscard]] Block* take_batch(std::size_t* count);
+    void give_batch(Block* head, Block* tail, std::size_t count);
+
+  public:
+    KRB5KerberosSlabPool(const KRB5KerberosSlabPool&) = delete;
+    KRB5KerberosSlabPool& operator=(const KRB5KerberosSlabPool&) = delete;
+
+    // Zeroed blocks of block_size(), throwing std::bad_alloc or returning null when out of memory
+    [[nodiscard]] void* allocate();
+    [[nodiscard]] void* allocate(const std::nothrow_t&) noexcept;
+    void deallocate(void* block) noexcept;
+
+    [[nodiscard]] std::size_t block_size() const;
+    [[nodiscard]] std::size_t slabs() const;
+
+    // The pool serving objects of type T, created on first use and kept for the life of the process
+    template <typename T>
+    [[nodiscard]] static KRB5KerberosSlabPool& of()
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Slab blocks are aligned to max_align_t only");
+        static KRB5KerberosSlabPool* const pool = create(sizeof(T));
+        return *pool;
+    }
+};
+} // namespace octo::kerberos::krb5
+
+#endif
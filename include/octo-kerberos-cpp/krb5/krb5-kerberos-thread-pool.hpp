@@ -0,0 +1,69 @@
+/**
+ * @file krb5-kerberos-thread-pool.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_THREAD_POOL_HPP_
+#define KRB5_KERBEROS_THREAD_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace octo::kerberos::krb5
+{
+/**
+ * Fixed set of worker threads running one parallel loop at a time, the calling thread takes part in it as well.
+ * Work is handed out in chunks of consecutive indices, so per thread state (parsers, scratch buffers) is reused
+ * across the items of a chunk.
+ */
+class KRB5KerberosThreadPool
+{
+  public:
+    typedef std::function<void(std::size_t begin, std::size_t end)> Job;
+
+  private:
+    std::vector<std::thread> workers_;
+    std::mutex loop_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable done_cv_;
+    const Job* job_;
+    std::size_t count_;
+    std::size_t chunk_size_;
+    std::atomic<std::size_t> next_;
+    std::size_t active_workers_;
+    std::uint64_t generation_;
+    bool is_stopping_;
+
+  private:
+    void worker_loop();
+    void run_chunks(const Job& job);
+
+  public:
+    // Zero threads means one per hardware thread, the calling thread counts as one of them
+    explicit KRB5KerberosThreadPool(std::size_t threads = 0);
+    ~KRB5KerberosThreadPool();
+    KRB5KerberosThreadPool(const KRB5KerberosThreadPool&) = delete;
+    KRB5KerberosThreadPool& operator=(const KRB5KerberosThreadPool&) = delete;
+
+    [[nodiscard]] std::size_t threads() const;
+    // Runs job over [0, count) in chunks of at most chunk_size and returns once all of them are done, the job must
+    // not throw. Concurrent calls are run one after the other
+    void parallel_for(std::size_t count, std::size_t chunk_size, const Job& job);
+};
+typedef std::unique_ptr<KRB5KerberosThreadPool> KRB5KerberosThreadPoolUniquePtr;
+} // namespace octo::kerberos::krb5
+
+#endif
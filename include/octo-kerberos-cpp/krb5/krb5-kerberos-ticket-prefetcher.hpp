@@ -0,0 +1,151 @@
+/**
+ * @file krb5-kerberos-ticket-prefetcher.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_TICKET_PREFETCHER_HPP_
+#define KRB5_KERBEROS_TICKET_PREFETCHER_HPP_
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-authenticator.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-service-ticket.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-tgt-ticket.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-timer-wheel.hpp"
+#include <octo-logger-cpp/logger.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+constexpr const auto DEFAULT_KERBEROS_PREFETCH_HOT_THRESHOLD = 4;
+constexpr const auto DEFAULT_KERBEROS_PREFETCH_REFRESH_MARGIN_SECONDS = 60;
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+/**
+ * Service ticket cache of one client that fetches replacements for its hot tickets ahead of their expiry.
+ * Every cached ticket gets a timer at its expiration minus the refresh margin. A ticket used at least hot_threshold
+ * times since it was fetched is then refetched by the refresh thread, through its own authenticator, while the
+ * current one keeps being served until it expires (stale while revalidate). Colder tickets are left to expire and are
+ * evicted, the next get fetches them again through the authenticator of the caller.
+ * The prefetcher is thread safe.
+ */
+class KRB5KerberosTicketPrefetcher
+{
+  public:
+    struct Settings
+    {
+        // Settings of the authenticator the refresh thread fetches through
+        KRB5KerberosAuthenticator::Settings authenticator;
+        std::chrono::seconds service_ticket_lifetime = std::chrono::seconds(DEFAULT_SERVICE_TICKET_LIFETIME_SECONDS);
+        std::chrono::seconds refresh_margin = std::chrono::seconds(DEFAULT_KERBEROS_PREFETCH_REFRESH_MARGIN_SECONDS);
+        // Uses since the last fetch that make a ticket worth refreshing ahead
+        std::uint32_t hot_threshold = DEFAULT_KERBEROS_PREFETCH_HOT_THRESHOLD;
+    };
+
+    struct Statistics
+    {
+        std::uint64_t hits;
+        // Hits served while a replacement was being fetched
+        std::uint64_t stale_hits;
+        std::uint64_t misses;
+        std::uint64_t refreshes;
+        std::uint64_t refresh_failures;
+        std::uint64_t evictions;
+    };
+
+  private:
+    enum class Phase : std::uint8_t
+    {
+        // Waiting for the refresh margin
+        Fresh,
+        // Replacement queued or being fetched
+        Refreshing,
+        // Left to expire, evicted by the next timer
+        Expiring
+    };
+
+    struct Entry
+    {
+        std::uint64_t id;
+        std::string service;
+        KRB5KerberosServiceTicketUniquePtr ticket;
+        std::atomic<std::uint32_t> accesses;
+        Phase phase;
+        KRB5KerberosTimerWheel::Handle timer;
+    };
+
+  private:
+    Settings settings_;
+    logger::Logger logger_;
+    mutable std::mutex tgt_mutex_;
+    KRB5KerberosTGTTicket tgt_;
+    mutable std::shared_mutex mutex_;
+    std::uint64_t next_id_;
+    std::unordered_map<std::uint64_t, Entry> entries_;
+    // Keys point into the service names of the entries
+    std::unordered_map<std::string_view, std::uint64_t> index_;
+    // Owned by the refresh thread once started
+    std::unique_ptr<KRB5KerberosAuthenticator> refresh_authenticator_;
+    std::thread refresh_thread_;
+    std::mutex refresh_mutex_;
+    std::condition_variable refresh_cv_;
+    std::deque<std::uint64_t> refresh_queue_;
+    std::atomic<bool> is_running_;
+    std::atomic<std::uint64_t> hits_;
+    std::atomic<std::uint64_t> stale_hits_;
+    std::atomic<std::uint64_t> misses_;
+    std::atomic<std::uint64_t> refreshes_;
+    std::atomic<std::uint64_t> refresh_failures_;
+    std::atomic<std::uint64_t> evictions_;
+    // Last, so its worker stops before anything its callbacks touch is destroyed
+    KRB5KerberosTimerWheel timers_;
+
+  private:
+    void refresh_loop();
+    void on_timer(KRB5KerberosTimerWheel::Handle timer, std::uint64_t id);
+    // Keeps whichever of the cached and the given ticket expires last, must hold mutex_
+    void store(const std::string& service, KRB5KerberosServiceTicketUniquePtr ticket);
+    void schedule(Entry* entry, const std::chrono::time_point<std::chrono::system_clock>& deadline, Phase phase);
+    [[nodiscard]] KRB5KerberosTGTTicket tgt() const;
+
+  public:
+    KRB5KerberosTicketPrefetcher(Settings settings, const KRB5KerberosTGTTicket& tgt);
+    ~KRB5KerberosTicketPrefetcher();
+    KRB5KerberosTicketPrefetcher(const KRB5KerberosTicketPrefetcher&) = delete;
+    KRB5KerberosTicketPrefetcher& operator=(const KRB5KerberosTicketPrefetcher&) = delete;
+
+    // Starts the refresh thread, fails when its authenticator cannot be initialized
+    [[nodiscard]] bool start();
+    void stop();
+    [[nodiscard]] bool is_running() const;
+
+    // Copy of the cached ticket of service, fetched through authenticator when missing or expired, null when the
+    // fetch fails. Copies share their creds with the cached ticket
+    [[nodiscard]] KRB5KerberosServiceTicketUniquePtr get(KRB5KerberosAuthenticator* authenticator,
+                                                         const std::string& service);
+    // Later fetches use the given tgt, e.g. once it was renewed
+    void update_tgt(const KRB5KerberosTGTTicket& tgt);
+    void erase(const std::string& service);
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] Statistics statistics() const;
+};
+} // namespace octo::kerberos::krb5
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file krb5-kerberos-ticket-registry.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_TICKET_REGISTRY_HPP_
+#define KRB5_KERBEROS_TICKET_REGISTRY_HPP_
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-cpu-dispatch.hpp"
+#include <krb5/krb5.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace octo::kerberos::krb5
+{
+/**
+ * Expiry index of tracked tickets. The endtime, renew till and flags of every ticket are kept in their own contiguous
+ * columns next to its handle, so expiry and renewal window queries scan plain arrays of 32 bit krb5 timestamps
+ * instead of calling into every ticket, with the widest vector unit the cpu supports (AVX2, SSE2 or NEON) picked once
+ * at runtime.
+ * Handles are small integers handed out by add and reused once erased, erasing moves the last ticket into the freed
+ * slot so the columns stay dense. Times are kept as krb5 does, unsigned seconds since the epoch.
+ * The registry is not thread safe.
+ */
+class KRB5KerberosTicketRegistry
+{
+  public:
+    typedef std::uint32_t Handle;
+
+    typedef KRB5KerberosCpu::Implementation Implementation;
+
+    struct Entry
+    {
+        std::chrono::time_point<std::chrono::system_clock> endtime;
+        std::chrono::time_point<std::chrono::system_clock> renew_till;
+        krb5_flags flags;
+    };
+
+  private:
+    // Slot i of every column describes the same ticket
+    std::vector<std::uint32_t> endtimes_;
+    std::vector<std::uint32_t> renew_tills_;
+    std::vector<std::uint32_t> flags_;
+    std::vector<Handle> handles_;
+    // Slot of every handle ever handed out, NO_SLOT once erased
+    std::vector<std::uint32_t> slots_;
+    std::vector<Handle> free_handles_;
+
+  private:
+    static constexpr std::uint32_t NO_SLOT = UINT32_MAX;
+
+    [[nodiscard]] Handle add(std::uint32_t endtime, std::uint32_t renew_till, std::uint32_t flags);
+    [[nodiscard]] bool update(Handle handle, std::uint32_t endtime, std::uint32_t renew_till, std::uint32_t flags);
+
+  public:
+    KRB5KerberosTicketRegistry() = default;
+
+    [[nodiscard]] static Implementation implementation();
+    [[nodiscard]] static const char* implementation_name(Implementation implementation);
+    // Switches every later scan to the given implementation, fails if the cpu does not support it
+    [[nodiscard]] static bool set_implementation(Implementation implementation);
+
+    // Tracks the times and flags of the given creds, e.g. KRB5KerberosTGTTicket::krb_creds()
+    [[nodiscard]] Handle add(const krb5_creds& creds);
+    [[nodiscard]] Handle add(const std::chrono::time_point<std::chrono::system_clock>& endtime,
+                             const std::chrono::time_point<std::chrono::system_clock>& renew_till,
+                             krb5_flags flags);
+    // Fail for handles that are not tracked
+    [[nodiscard]] bool update(Handle handle, const krb5_creds& creds);
+    [[nodiscard]] bool update(Handle handle,
+                              const std::chrono::time_point<std::chrono::system_clock>& endtime,
+                              const std::chrono::time_point<std::chrono::system_clock>& renew_till,
+                              krb5_flags flags);
+    [[nodiscard]] bool erase(Handle handle);
+    [[nodiscard]] bool find(Handle handle, Entry* entry) const;
+    [[nodiscard]] bool contains(Handle handle) const;
+    [[nodiscard]] std::size_t size() const;
+    void reserve(std::size_t size);
+    void clear();
+
+    // Append the handles of the tickets ending before the given time, expired ones included
+    void expiring(const std::chrono::time_point<std::chrono::system_clock>& before, std::vector<Handle>* handles) const;
+    // Append the handles of the renewable tickets ending before the given time that can still be renewed at now
+    void renewable(const std::chrono::time_point<std::chrono::system_clock>& now,
+                   const std::chrono::time_point<std::chrono::system_clock>& before,
+                   std::vector<Handle>* handles) const;
+};
+} // namespace octo::kerberos::krb5
+
+#endif
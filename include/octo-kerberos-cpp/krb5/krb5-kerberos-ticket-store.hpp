@@ -0,0 +1,99 @@
+/**
+ * @file krb5-kerberos-ticket-store.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_TICKET_STORE_HPP_
+#define KRB5_KERBEROS_TICKET_STORE_HPP_
+
+#include "octo-kerberos-cpp/kerberos-ticket.hpp"
+#include <octo-logger-cpp/logger.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace octo::kerberos::krb5
+{
+/**
+ * On disk ticket store keyed by (client, service).
+ * Tickets are kept in their binary serialization in an append only data file, <path>, next to an open addressing
+ * hash index, <path>.idx. Both are memory mapped, so opening the store and looking a ticket up cost the same
+ * regardless of how many tickets it holds. The index is a host local cache of the data file, it is rebuilt from the
+ * data file whenever it is missing, stale or written on a host with a different byte order.
+ * The store is not thread safe, views point into the mapping and are valid until the next modification.
+ */
+class KRB5KerberosTicketStore
+{
+  public:
+    struct View
+    {
+        std::string_view client;
+        std::string_view service;
+        std::chrono::time_point<std::chrono::system_clock> expiration;
+        // Binary serialized ticket, see KerberosTicket::serialize_binary
+        std::string_view ticket;
+    };
+
+  private:
+    std::string path_;
+    int data_fd_;
+    int index_fd_;
+    char* data_map_;
+    std::size_t data_map_size_;
+    std::uint64_t data_size_;
+    char* index_map_;
+    std::size_t index_map_size_;
+    logger::Logger logger_;
+
+  private:
+    [[nodiscard]] bool map_data(std::uint64_t min_size);
+    [[nodiscard]] bool map_index(std::uint64_t capacity, bool reset);
+    [[nodiscard]] bool open_index();
+    [[nodiscard]] bool grow_index();
+    [[nodiscard]] bool replay(std::uint64_t offset);
+    [[nodiscard]] bool read_record(std::uint64_t offset, std::uint8_t* type, View* view, std::uint64_t* next) const;
+    [[nodiscard]] bool index_insert(std::uint64_t hash, std::uint64_t offset, std::string_view client,
+                                    std::string_view service);
+    void index_erase(std::uint64_t hash, std::string_view client, std::string_view service);
+    [[nodiscard]] bool append(std::uint8_t type,
+                              std::string_view client,
+                              std::string_view service,
+                              const std::chrono::time_point<std::chrono::system_clock>& expiration,
+                              std::string_view ticket,
+                              std::uint64_t* offset);
+
+  public:
+    KRB5KerberosTicketStore();
+    ~KRB5KerberosTicketStore();
+    KRB5KerberosTicketStore(const KRB5KerberosTicketStore&) = delete;
+    KRB5KerberosTicketStore& operator=(const KRB5KerberosTicketStore&) = delete;
+
+    [[nodiscard]] bool open(const std::string& path);
+    void close();
+    [[nodiscard]] bool is_open() const;
+
+    // A later put for the same (client, service) replaces the previous ticket
+    [[nodiscard]] bool put(std::string_view client, std::string_view service, const KerberosTicket& ticket);
+    [[nodiscard]] bool put(std::string_view client,
+                           std::string_view service,
+                           const std::chrono::time_point<std::chrono::system_clock>& expiration,
+                           std::string_view ticket);
+    [[nodiscard]] bool find(std::string_view client, std::string_view service, View* view) const;
+    [[nodiscard]] bool erase(std::string_view client, std::string_view service);
+
+    // Rewrites the data file with only the live tickets that did not expire by now
+    [[nodiscard]] bool compact(
+        const std::chrono::time_point<std::chrono::system_clock>& now = std::chrono::system_clock::now());
+    [[nodiscard]] bool sync();
+    [[nodiscard]] std::size_t size() const;
+};
+} // namespace octo::kerberos::krb5
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file krb5-kerberos-timer-wheel.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_TIMER_WHEEL_HPP_
+#define KRB5_KERBEROS_TIMER_WHEEL_HPP_
+
+#include "octo-kerberos-cpp/kerberos-ticket.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+constexpr const auto DEFAULT_KERBEROS_TIMER_WHEEL_TICK_MS = 1000;
+constexpr const auto DEFAULT_KERBEROS_TIMER_WHEEL_REFRESH_MARGIN_S = 300;
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+/**
+ * Hierarchical timing wheel (G. Varghese and T. Lauck, "Hashed and Hierarchical Timing Wheels") for ticket expiry and
+ * refresh events. LEVELS wheels of SLOTS slots each cover SLOTS^LEVELS ticks, about 194 days at the default one second
+ * tick, later deadlines wait in the last wheel until they come into range. Timers sit in intrusive lists, so scheduling
+ * and cancelling are O(1) and a tick only touches the timers that are due or move down a level.
+ * Due timers fire on the worker thread once started, or on whoever calls advance, always outside the wheel lock so
+ * callbacks may schedule and cancel timers. Timers fire at most one tick late and never early.
+ * The wheel is thread safe.
+ */
+class KRB5KerberosTimerWheel
+{
+  public:
+    // Zero is never handed out, handles of fired or cancelled timers are not reused
+    typedef std::uint64_t Handle;
+    // Must not throw
+    typedef std::function<void(Handle handle, std::uint64_t data)> Callback;
+
+    static constexpr std::size_t LEVELS = 4;
+    static constexpr std::size_t SLOT_BITS = 6;
+    static constexpr std::size_t SLOTS = 1 << SLOT_BITS;
+
+  private:
+    static constexpr std::uint32_t NO_NODE = UINT32_MAX;
+
+    struct Node
+    {
+        std::uint64_t expiry;
+        std::uint64_t data;
+        std::uint32_t previous;
+        std::uint32_t next;
+        // Bumped whenever the node is released, stale handles then no longer match
+        std::uint32_t generation;
+        std::uint32_t slot;
+    };
+
+    struct Fired
+    {
+        Handle handle;
+        std::uint64_t data;
+    };
+
+  private:
+    Callback callback_;
+    std::chrono::system_clock::duration tick_;
+    std::chrono::seconds refresh_margin_;
+    std::chrono::time_point<std::chrono::system_clock> base_;
+    mutable std::mutex mutex_;
+    std::uint64_t current_tick_;
+    std::vector<Node> nodes_;
+    std::uint32_t free_nodes_;
+    std::uint32_t slots_[LEVELS * SLOTS];
+    std::size_t size_;
+    // Serializes advances so callbacks fire in deadline order
+    std::mutex advance_mutex_;
+    std::thread worker_thread_;
+    std::mutex worker_mutex_;
+    std::condition_variable worker_cv_;
+    std::atomic<bool> is_running_;
+
+  private:
+    void worker_loop();
+    void link(std::uint32_t index);
+    void unlink(std::uint32_t index);
+    void release(std::uint32_t index);
+    void step(std::vector<Fired>* fired);
+
+  public:
+    explicit KRB5KerberosTimerWheel(
+        Callback callback,
+        std::chrono::milliseconds tick = std::chrono::milliseconds(DEFAULT_KERBEROS_TIMER_WHEEL_TICK_MS),
+        std::chrono::seconds refresh_margin = std::chrono::seconds(DEFAULT_KERBEROS_TIMER_WHEEL_REFRESH_MARGIN_S));
+    ~KRB5KerberosTimerWheel();
+    KRB5KerberosTimerWheel(const KRB5KerberosTimerWheel&) = delete;
+    KRB5KerberosTimerWheel& operator=(const KRB5KerberosTimerWheel&) = delete;
+
+    void start();
+    void stop();
+    [[nodiscard]] bool is_running() const;
+
+    // Deadlines already due fire on the next tick
+    [[nodiscard]] Handle schedule(const std::chrono::time_point<std::chrono::system_clock>& deadline,
+                                  std::uint64_t data);
+    // Schedules at the expiration of the ticket minus the refresh margin
+    [[nodiscard]] Handle schedule_refresh(const KerberosTicket& ticket, std::uint64_t data);
+    // Fails once the timer fired or was cancelled
+    [[nodiscard]] bool cancel(Handle handle);
+    // Fires every timer due by now from the calling thread and returns how many fired
+    std::size_t advance(
+        const std::chrono::time_point<std::chrono::system_clock>& now = std::chrono::system_clock::now());
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] std::chrono::seconds refresh_margin() const;
+};
+typedef std::shared_ptr<KRB5KerberosTimerWheel> KRB5KerberosTimerWheelPtr;
+} // namespace octo::kerberos::krb5
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file krb5-kerberos-trace.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef KRB5_KERBEROS_TRACE_HPP_
+#define KRB5_KERBEROS_TRACE_HPP_
+
+#include <krb5/krb5.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+constexpr const auto DEFAULT_KERBEROS_TRACE_RING_CAPACITY = 4096;
+constexpr const auto DEFAULT_KERBEROS_TRACE_DRAIN_INTERVAL_MS = 50;
+constexpr const auto KERBEROS_TRACE_MESSAGE_MAX_LENGTH = 191;
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+struct KRB5KerberosTraceEvent
+{
+    enum class Type : std::uint8_t
+    {
+        Other,
+        KdcSelection,
+        KdcRequest,
+        KdcResponse,
+        KdcError,
+        PreauthTypes,
+        Preauth,
+        Retry,
+        EnctypeSelection,
+        Referral
+    };
+
+    Type type = Type::Other;
+    std::chrono::time_point<std::chrono::system_clock> timestamp;
+    // Per type numeric payload, bytes for requests / responses and error code for kdc errors, otherwise 0
+    std::int64_t value = 0;
+    std::uint16_t length = 0;
+    char message[KERBEROS_TRACE_MESSAGE_MAX_LENGTH + 1] = {};
+
+    [[nodiscard]] std::string_view message_view() const;
+    [[nodiscard]] static std::string_view type_name(Type type);
+};
+
+// Bounded multi producer / single consumer ring, producers never block and drop events when the ring is full
+class KRB5KerberosTraceRing
+{
+  private:
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        KRB5KerberosTraceEvent event;
+    };
+
+  private:
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t mask_;
+    alignas(64) std::atomic<std::size_t> head_;
+    alignas(64) std::atomic<std::size_t> tail_;
+    alignas(64) std::atomic<std::uint64_t> dropped_;
+
+  public:
+    explicit KRB5KerberosTraceRing(std::size_t capacity = DEFAULT_KERBEROS_TRACE_RING_CAPACITY);
+    ~KRB5KerberosTraceRing() = default;
+
+    [[nodiscard]] bool try_push(const KRB5KerberosTraceEvent& event);
+    [[nodiscard]] bool try_pop(KRB5KerberosTraceEvent* event);
+    [[nodiscard]] std::size_t capacity() const;
+    [[nodiscard]] std::uint64_t dropped() const;
+};
+
+class KRB5KerberosTracer
+{
+  public:
+    typedef std::function<void(const KRB5KerberosTraceEvent&)> Sink;
+
+  private:
+    Sink sink_;
+    KRB5KerberosTraceRing ring_;
+    std::chrono::milliseconds drain_interval_;
+    std::thread drain_thread_;
+    std::mutex drain_mutex_;
+    std::condition_variable drain_cv_;
+    std::atomic<bool> is_running_;
+    // Serializes the ring consumer, the drain thread against flush
+    std::mutex sink_mutex_;
+    // Authenticators currently delivering into this tracer
+    std::mutex attach_mutex_;
+    std::size_t attached_;
+
+  private:
+    void drain_loop();
+    std::size_t drain();
+
+  public:
+    explicit KRB5KerberosTracer(
+        Sink sink,
+        std::size_t capacity = DEFAULT_KERBEROS_TRACE_RING_CAPACITY,
+        std::chrono::milliseconds drain_interval = std::chrono::milliseconds(DEFAULT_KERBEROS_TRACE_DRAIN_INTERVAL_MS));
+    ~KRB5KerberosTracer();
+
+    void start();
+    void stop();
+    [[nodiscard]] bool is_running() const;
+    // Used by the authenticators, the first attach starts the drain thread and the last detach flushes and stops it
+    void attach();
+    void detach();
+
+    void trace(std::string_view message);
+    // Delivers every pending event to the sink from the calling thread, never concurrently with the drain thread
+    std::size_t flush();
+    [[nodiscard]] std::uint64_t dropped_events() const;
+
+    [[nodiscard]] static KRB5KerberosTraceEvent parse_trace_message(std::string_view message);
+    static void krb5_trace_callback(krb5_context ctx, const krb5_trace_info* info, void* cb_data);
+};
+typedef std::shared_ptr<KRB5KerberosTracer> KRB5KerberosTracerPtr;
+} // namespace octo::kerberos::krb5
+
+#endif
@@ -99,9 +99,13 @@ openssl_root = os.environ.get(
     "OPENSSL_ROOT",
     ""
 )
+simdjson_root = os.environ.get(
+    "SIMDJSON_ROOT",
+    ""
+)
 
 for v in ("OCTO_LOGGER_CPP_ROOT", "OCTO_ENCRYPTION_CPP_ROOT", "KRB5_ROOT",
-          "LIBFMT_ROOT", "NLOHMANN_JSON_ROOT", "OPENSSL_ROOT"):
+          "LIBFMT_ROOT", "NLOHMANN_JSON_ROOT", "OPENSSL_ROOT", "SIMDJSON_ROOT"):
     if v not in os.environ.keys():
         logger.warning("[%s] was not found in environment variables,"
                        " using default value!", v)
@@ -161,6 +165,7 @@ krb5_extension = Extension(
     extra_link_args=link_args,
     extra_objects=[
         f"{libfmt_root}/lib/libfmt.a",
+        f"{simdjson_root}/lib/libsimdjson.a",
         *extra_obj_files
     ],
     include_dirs=[
@@ -169,7 +174,8 @@ krb5_extension = Extension(
         f"{octo_encryption_cpp_root}/include",
         f"{krb5_root}/include",
         f"{libfmt_root}/include",
-        f"{nlohmann_json_root}/include"
+        f"{nlohmann_json_root}/include",
+        f"{simdjson_root}/include"
     ],
     libraries=[
         "octo-logger-cpp",
@@ -183,11 +189,28 @@ krb5_extension = Extension(
         f"{libfmt_root}/lib"
     ],
     sources=[
+        "src/kerberos-authenticator.cpp",
+        "src/kerberos-ticket.cpp",
         "src/kerberos-user-credentials.cpp",
         "src/krb5/krb5-kerberos-authenticator.cpp",
+        "src/krb5/krb5-kerberos-base64.cpp",
+        "src/krb5/krb5-kerberos-encoded-ticket.cpp",
+        "src/krb5/krb5-kerberos-creds.cpp",
+        "src/krb5/krb5-kerberos-principal-table.cpp",
+        "src/krb5/krb5-kerberos-json-writer.cpp",
+        "src/krb5/krb5-kerberos-kdc-recording.cpp",
+        "src/krb5/krb5-kerberos-kdc-transport.cpp",
+        "src/krb5/krb5-kerberos-request-coalescer.cpp",
         "src/krb5/krb5-kerberos-service-ticket.cpp",
         "src/krb5/krb5-kerberos-tgt-ticket.cpp",
         "src/krb5/krb5-kerberos-serializer.cpp",
+        "src/krb5/krb5-kerberos-slab-pool.cpp",
+        "src/krb5/krb5-kerberos-thread-pool.cpp",
+        "src/krb5/krb5-kerberos-ticket-prefetcher.cpp",
+        "src/krb5/krb5-kerberos-ticket-registry.cpp",
+        "src/krb5/krb5-kerberos-ticket-store.cpp",
+        "src/krb5/krb5-kerberos-timer-wheel.cpp",
+        "src/krb5/krb5-kerberos-trace.cpp",
         "src/krb5/python/krb5-kerberos-py-bindings.cpp",
         "src/krb5/python/krb5-kerberos-py-types-authenticator.cpp",
         "src/krb5/python/krb5-kerberos-py-types-service-ticket.cpp",
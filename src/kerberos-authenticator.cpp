@@ -0,0 +1,39 @@
+/**
+ * @file kerberos-authenticator.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/kerberos-authenticator.hpp"
+
+namespace octo::kerberos
+{
+KerberosTicketUniquePtr KerberosAuthenticator::deserialize_tgt_binary(std::string_view data)
+{
+    const auto json = nlohmann::json::from_cbor(data, true, false);
+    return json.is_discarded() ? nullptr : deserialize_tgt(json);
+}
+
+KerberosTicketUniquePtr KerberosAuthenticator::deserialize_tgt_text(std::string_view text)
+{
+    const auto json = nlohmann::json::parse(text, nullptr, false);
+    return json.is_discarded() ? nullptr : deserialize_tgt(json);
+}
+
+KerberosTicketUniquePtr KerberosAuthenticator::deserialize_service_ticket_binary(std::string_view data)
+{
+    const auto json = nlohmann::json::from_cbor(data, true, false);
+    return json.is_discarded() ? nullptr : deserialize_service_ticket(json);
+}
+
+KerberosTicketUniquePtr KerberosAuthenticator::deserialize_service_ticket_text(std::string_view text)
+{
+    const auto json = nlohmann::json::parse(text, nullptr, false);
+    return json.is_discarded() ? nullptr : deserialize_service_ticket(json);
+}
+} // namespace octo::kerberos
@@ -0,0 +1,43 @@
+/**
+ * @file kerberos-ticket.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/kerberos-ticket.hpp"
+
+namespace octo::kerberos
+{
+void KerberosTicket::serialize_to(std::string* out) const
+{
+    out->append(serialize().dump());
+}
+
+void KerberosTicket::serialize_to(std::ostream& out) const
+{
+    out << serialize().dump();
+}
+
+std::string KerberosTicket::serialize_binary() const
+{
+    const auto cbor = nlohmann::json::to_cbor(serialize());
+    return std::string(cbor.begin(), cbor.end());
+}
+
+bool KerberosTicket::deserialize_text(std::string_view text)
+{
+    const auto json = nlohmann::json::parse(text, nullptr, false);
+    return !json.is_discarded() && deserialize(json);
+}
+
+bool KerberosTicket::deserialize_binary(std::string_view data)
+{
+    const auto json = nlohmann::json::from_cbor(data, true, false);
+    return !json.is_discarded() && deserialize(json);
+}
+} // namespace octo::kerberos
@@ -12,170 +12,86 @@
 #include "octo-kerberos-cpp/krb5/krb5-kerberos-authenticator.hpp"
 #include "octo-kerberos-cpp/krb5/krb5-kerberos-tgt-ticket.hpp"
 #include "octo-kerberos-cpp/krb5/krb5-kerberos-service-ticket.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-serializer.hpp"
 #include <netdb.h>
+#include <algorithm>
 #include <cstdlib>
 #include <netinet/in.h>
 #include <stdexcept>
 #include <unistd.h>
 
+namespace
+{
+// Consecutive items handed to a worker at once, large enough to amortize the hand off
+constexpr const std::size_t BULK_CHUNK_SIZE = 256;
+} // namespace
+
 namespace octo::kerberos::krb5
 {
 bool KRB5KerberosAuthenticator::create_streamlined_kdc_connection()
 {
-    logger_.info(settings_.session_id).formatted("Creating streamlined kdc connection");
-    auto const port_str(std::to_string(settings_.kdc_port));
-    struct addrinfo *ap, aihints{}, *apstart;
-    int aierr;
-    std::memset(&aihints, 0, sizeof(aihints));
-    aihints.ai_socktype = SOCK_STREAM;
-    aihints.ai_flags = AI_ADDRCONFIG;
-    aierr = getaddrinfo(settings_.kdc_host.c_str(), port_str.c_str(), &aihints, &ap);
-    if (aierr)
+    if (settings_.kdc_transport_factory)
     {
-        logger_.warning(settings_.session_id)
-            .formatted("Failed running getaddrinfo to resolve ip / port [{}] [{}]", aierr, gai_strerror(aierr));
-        return false;
+        kdc_transport_ = settings_.kdc_transport_factory();
+        if (!kdc_transport_)
+        {
+            logger_.warning(settings_.session_id) << "Streamlined kdc transport factory returned no transport";
+            return false;
+        }
     }
-    if (!ap)
+    else if (!settings_.kdc_replay_path.empty())
     {
-        logger_.warning(settings_.session_id).formatted("Failed resolving ip / port using getaddrinfo");
-        return false;
+        logger_.info(settings_.session_id)
+            .formatted("Replaying streamlined kdc exchanges from [{}]", settings_.kdc_replay_path);
+        kdc_transport_ =
+            std::make_shared<KRB5KerberosReplayKdcTransport>(settings_.kdc_replay_path, settings_.kdc_replay_latency);
     }
-    apstart = ap;
-    for (kdc_fd_ = -1; ap && kdc_fd_ == -1; ap = ap->ai_next)
+    else
     {
-        kdc_fd_ = socket(ap->ai_family, SOCK_STREAM, 0);
-        if (kdc_fd_ < 0)
-        {
-            continue;
-        }
-        if (connect(kdc_fd_, ap->ai_addr, ap->ai_addrlen) < 0)
-        {
-            close(kdc_fd_);
-            kdc_fd_ = -1;
-            continue;
-        }
+        kdc_transport_ =
+            std::make_shared<KRB5KerberosTcpKdcTransport>(settings_.kdc_host, settings_.kdc_port, settings_.session_id);
     }
-    if (kdc_fd_ == -1)
+    if (!settings_.kdc_capture_path.empty())
     {
-        logger_.warning(settings_.session_id)
-            .formatted("Failed to connect to host [{}] on port [{}]", settings_.kdc_host, settings_.kdc_port);
-        freeaddrinfo(apstart);
+        logger_.info(settings_.session_id)
+            .formatted("Recording streamlined kdc exchanges to [{}]", settings_.kdc_capture_path);
+        kdc_transport_ =
+            std::make_shared<KRB5KerberosRecordingKdcTransport>(kdc_transport_, settings_.kdc_capture_path);
+    }
+    if (!kdc_transport_->connect())
+    {
+        logger_.warning(settings_.session_id) << "Failed connecting streamlined kdc transport";
+        kdc_transport_.reset();
         return false;
     }
-    freeaddrinfo(apstart);
-    logger_.info(settings_.session_id).formatted("Streamlined connected successfully to host [{}] on port [{}]",
-                                                 settings_.kdc_host, settings_.kdc_port);
     return true;
 }
 
 void KRB5KerberosAuthenticator::close_streamlined_kdc_connection()
 {
-    if (kdc_fd_ != -1)
-    {
-        close(kdc_fd_);
-        kdc_fd_ = -1;
-    }
-    logger_.info(settings_.session_id).formatted("Streamlined disconnected successfully");
-}
-
-int KRB5KerberosAuthenticator::kdc_net_read(char* buf, int len)
-{
-    int ret, bytes_read = 0;
-    do
-    {
-        ret = ::read(kdc_fd_, buf, len);
-        if (ret == 0)
-        {
-            return bytes_read;
-        }
-        if (ret < 0)
-        {
-            if (errno == EINTR)
-            {
-                continue;
-            }
-            return ret;
-        }
-        buf += ret;
-        bytes_read += ret;
-        len -= ret;
-    } while (len > 0);
-    return bytes_read;
-}
-
-int KRB5KerberosAuthenticator::kdc_net_write(char* buf, int len)
-{
-    const char* buffer = static_cast<const char*>(buf);
-    size_t bytes_written = 0;
-    while (bytes_written < len)
+    if (kdc_transport_)
     {
-        ssize_t nbytes = ::write(kdc_fd_, buffer, len - bytes_written);
-        if (nbytes == 0)
-        {
-            return -1;
-        }
-        if (nbytes == -1 && errno != EINTR)
-        {
-            return -1;
-        }
-        bytes_written += static_cast<size_t>(nbytes);
-        buffer += nbytes;
+        kdc_transport_->disconnect();
+        kdc_transport_.reset();
     }
-    return len;
 }
 
 krb5_error_code KRB5KerberosAuthenticator::kdc_read(krb5_data* inbuf)
 {
-    krb5_int32 len;
-    int len2, ilen;
-    char *buf = nullptr;
-
-    std::memset(reinterpret_cast<void*>(inbuf), 0, sizeof(krb5_data));
-    inbuf->magic = KV5M_DATA;
-    if ((len2 = kdc_net_read(reinterpret_cast<char *>(&len), sizeof(krb5_int32))) != sizeof(krb5_int32))
-    {
-        return (len2 < 0) ? errno : ECONNABORTED;
-    }
-    len = ntohl(len);
-
-    if ((len & VALID_UINT_BITS) != (krb5_ui_4)len)
-    {
-        return ENOMEM;
-    }
-
-    ilen = (int)len;
-    if (ilen)
+    if (!kdc_transport_)
     {
-        if (!(buf = static_cast<char*>(malloc(ilen))))
-        {
-            return (ENOMEM);
-        }
-        if ((len2 = kdc_net_read(buf, ilen)) != ilen)
-        {
-            free(buf);
-            return len2 < 0 ? errno : ECONNABORTED;
-        }
+        return ENOTCONN;
     }
-    inbuf->data = buf;
-    inbuf->length = ilen;
-    return 0;
+    return kdc_transport_->receive(inbuf);
 }
 
 krb5_error_code KRB5KerberosAuthenticator::kdc_write(krb5_data* outbuf)
 {
-    auto len = htonl(outbuf->length);
-    auto bytes_written = kdc_net_write(reinterpret_cast<char*>(&len), sizeof(unsigned int));
-    if (bytes_written != sizeof(unsigned int))
+    if (!kdc_transport_)
     {
-        return bytes_written < 0 ? errno : ECONNABORTED;
+        return ENOTCONN;
     }
-    bytes_written = kdc_net_write(outbuf->data, outbuf->length);
-    if (bytes_written != outbuf->length)
-    {
-        return bytes_written < 0 ? errno : ECONNABORTED;
-    }
-    return 0;
+    return kdc_transport_->send(*outbuf);
 }
 
 bool KRB5KerberosAuthenticator::convert_to_krb_address(const std::string& host, int port, krb5_address** outaddr)
@@ -267,10 +183,10 @@ krb5_get_init_creds_opt* KRB5KerberosAuthenticator::allocate_init_creds_options(
     return options;
 }
 
-KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_tgt_direct(const KerberosUserCredentials* const creds,
-                                                                       std::chrono::seconds lifetime)
+KRB5KerberosTGTTicketUniquePtr KRB5KerberosAuthenticator::generate_tgt_direct(
+    const KerberosUserCredentials* const creds, std::chrono::seconds lifetime)
 {
-    krb5_principal client;
+    KRB5KerberosPrincipalTable::EntryPtr client;
     logger_.info(settings_.session_id)
         .formatted("Generating KRB5 tgt for user [{}] with lifetime of [{}]", creds->username(), lifetime.count());
 
@@ -281,8 +197,8 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_tgt_direct(const Ker
         return nullptr;
     }
 
-    // Create the client principal
-    auto ret = krb5_parse_name(ctx_, creds->username().c_str(), &client);
+    // Get the client principal
+    auto ret = principals_->intern(creds->username(), ctx_, &client);
     if (ret)
     {
         logger_.error(settings_.session_id)
@@ -294,28 +210,37 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_tgt_direct(const Ker
     auto ticket =
         std::make_unique<KRB5KerberosTGTTicket>(creds->username(), std::chrono::system_clock::now() + lifetime);
     ticket->ctx_ = ctx_;
+    auto tgt_creds = ticket->tgt_ticket_.replace(ctx_);
+    if (!tgt_creds)
+    {
+        logger_.error(settings_.session_id) << "Failed allocating krb5 tgt creds";
+        krb5_get_init_creds_opt_free(ctx_, options);
+        return nullptr;
+    }
 
+    // The exchange stores its tgt in cache_, whatever cache_ held is gone even if it fails later on
+    cache_tgt_.clear();
     ret = krb5_get_init_creds_password(
-        ctx_, &ticket->tgt_ticket_, client, creds->password().get().data(), nullptr, nullptr, 0, nullptr, options);
+        ctx_, tgt_creds, client->principal, creds->password().get().data(), nullptr, nullptr, 0, nullptr, options);
     if (ret)
     {
+        kdc_error_ = ret;
         logger_.error(settings_.session_id)
             .formatted(
                 "Failed getting krb5 init creds with password [{}] [{}]", ret, krb5_get_error_message(ctx_, ret));
         krb5_get_init_creds_opt_free(ctx_, options);
-        krb5_free_principal(ctx_, client);
         return nullptr;
     }
     krb5_get_init_creds_opt_free(ctx_, options);
-    krb5_free_principal(ctx_, client);
+    cache_tgt_.assign(ticket->ticket_view());
     logger_.info(settings_.session_id).formatted("Successfully generated a tgt for user [{}]", creds->username());
     return ticket;
 }
 
-KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_tgt_streamlined(const KerberosUserCredentials* const creds,
-                                                                            std::chrono::seconds lifetime)
+KRB5KerberosTGTTicketUniquePtr KRB5KerberosAuthenticator::generate_tgt_streamlined(
+    const KerberosUserCredentials* const creds, std::chrono::seconds lifetime)
 {
-    krb5_principal client;
+    KRB5KerberosPrincipalTable::EntryPtr client;
     krb5_init_creds_context init_ctx;
     krb5_data step_response, step_request, step_realm;
     unsigned int flags_out;
@@ -328,15 +253,17 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_tgt_streamlined(cons
         return nullptr;
     }
 
-    // Create the client principal
-    auto ret = krb5_parse_name(ctx_, creds->username().c_str(), &client);
+    // Get the client principal
+    auto ret = principals_->intern(creds->username(), ctx_, &client);
     if (ret)
     {
         logger_.error(settings_.session_id)
             .formatted("Failed initializing krb5 client principal [{}] [{}]", ret, krb5_get_error_message(ctx_, ret));
         return nullptr;
     }
-    ret = krb5_init_creds_init(ctx_, client, nullptr, nullptr, 0, options, &init_ctx);
+    // The exchange stores its tgt in cache_, whatever cache_ held is gone even if it fails later on
+    cache_tgt_.clear();
+    ret = krb5_init_creds_init(ctx_, client->principal, nullptr, nullptr, 0, options, &init_ctx);
     if (ret)
     {
         logger_.error(settings_.session_id)
@@ -363,6 +290,7 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_tgt_streamlined(cons
         ret = krb5_init_creds_step(ctx_, init_ctx, &step_response, &step_request, &step_realm, &flags_out);
         if (ret)
         {
+            kdc_error_ = ret;
             logger_.error(settings_.session_id)
                 .formatted("Failed to run krb5 init creds step [{}] [{}]", ret, krb5_get_error_message(ctx_, ret));
             break;
@@ -403,7 +331,14 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_tgt_streamlined(cons
     auto ticket =
         std::make_unique<KRB5KerberosTGTTicket>(creds->username(), std::chrono::system_clock::now() + lifetime);
     ticket->ctx_ = ctx_;
-    ret = krb5_init_creds_get_creds(ctx_, init_ctx, &ticket->tgt_ticket_);
+    auto tgt_creds = ticket->tgt_ticket_.replace(ctx_);
+    if (!tgt_creds)
+    {
+        logger_.error(settings_.session_id) << "Failed allocating krb5 tgt creds";
+        krb5_init_creds_free(ctx_, init_ctx);
+        return nullptr;
+    }
+    ret = krb5_init_creds_get_creds(ctx_, init_ctx, tgt_creds);
     if (ret)
     {
         logger_.error(settings_.session_id)
@@ -412,78 +347,157 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_tgt_streamlined(cons
         return nullptr;
     }
     krb5_init_creds_free(ctx_, init_ctx);
+    cache_tgt_.assign(ticket->ticket_view());
     logger_.info(settings_.session_id).formatted("Successfully generated a tgt for user [{}]", creds->username());
     return ticket;
 }
 
-bool KRB5KerberosAuthenticator::prepare_tgt_for_st_generation(KRB5KerberosTGTTicket* const krb5_tgt,
-                                                              const std::string& service,
-                                                              std::chrono::seconds lifetime)
+bool KRB5KerberosAuthenticator::take_over_creds(KRB5KerberosCredsPtr* creds)
+{
+    krb5_creds* creds_copy = nullptr;
+    const auto ret = krb5_copy_creds(ctx_, creds->get(), &creds_copy);
+    if (ret)
+    {
+        logger_.error(settings_.session_id)
+            .formatted("Failed copying krb5 creds [{}] [{}]", ret, krb5_get_error_message(ctx_, ret));
+        return false;
+    }
+    *creds = KRB5KerberosCredsPtr::adopt(creds_copy, ctx_, KRB5KerberosCreds::Allocation::Heap);
+    return static_cast<bool>(*creds);
+}
+
+bool KRB5KerberosAuthenticator::store_tgt(const KRB5KerberosTGTTicket* const krb5_tgt)
+{
+    // A tgt generated elsewhere (another authenticator, deserialized) is not in cache_ yet
+    if (krb5_tgt->ticket_view() == cache_tgt_)
+    {
+        return true;
+    }
+    auto tgt_creds = krb5_tgt->krb_creds();
+    if (!tgt_creds.client)
+    {
+        logger_.error(settings_.session_id) << "Cannot use a tgt without a client principal";
+        return false;
+    }
+    // Reinitializing drops the service tickets cached with the previous tgt along with it
+    cache_tgt_.clear();
+    auto ret = krb5_cc_initialize(ctx_, cache_, tgt_creds.client);
+    if (ret)
+    {
+        logger_.error(settings_.session_id)
+            .formatted("Failed initializing krb5 cache [{}] [{}]", ret, krb5_get_error_message(ctx_, ret));
+        return false;
+    }
+    // The cache keeps a copy of its own
+    ret = krb5_cc_store_cred(ctx_, cache_, &tgt_creds);
+    if (ret)
+    {
+        logger_.error(settings_.session_id)
+            .formatted("Failed storing tgt in krb5 cache [{}] [{}]", ret, krb5_get_error_message(ctx_, ret));
+        return false;
+    }
+    cache_tgt_.assign(krb5_tgt->ticket_view());
+    return true;
+}
+
+bool KRB5KerberosAuthenticator::prepare_match_creds(const KRB5KerberosTGTTicket* const krb5_tgt,
+                                                    const std::string& service,
+                                                    std::chrono::seconds lifetime,
+                                                    MatchCreds* match_creds)
 {
-    // Set the tgt ticket client and server principals
-    // Create the client principal
-    auto ret = krb5_parse_name(ctx_, krb5_tgt->tgt_user().c_str(), &krb5_tgt->tgt_ticket_.client);
+    // The tgt itself is never written, the match creds borrow its ticket, key and addresses and the interned
+    // principals, only the times are their own, so one tgt can serve several requests at once
+    match_creds->creds = *krb5_tgt->tgt_ticket_;
+    match_creds->creds.client = nullptr;
+    match_creds->creds.server = nullptr;
+
+    // Get the client principal
+    auto ret = principals_->intern(krb5_tgt->tgt_user(), ctx_, &match_creds->client);
     if (ret)
     {
         logger_.error().formatted(
             "Failed initializing krb5 client principal [{}] [{}]", ret, krb5_get_error_message(ctx_, ret));
+        release_match_creds(match_creds);
         return false;
     }
+    match_creds->creds.client = match_creds->client->principal;
 
-    // Create the server principal
-    ret = krb5_parse_name(ctx_, service.c_str(), &krb5_tgt->tgt_ticket_.server);
+    // Get the server principal
+    ret = principals_->intern(service, ctx_, &match_creds->server);
     if (ret)
     {
         logger_.error().formatted(
             "Failed initializing krb5 server principal [{}] [{}]", ret, krb5_get_error_message(ctx_, ret));
+        release_match_creds(match_creds);
         return false;
     }
+    match_creds->creds.server = match_creds->server->principal;
 
     // Set the ticket expiration
-    ret = krb5_timeofday(ctx_, &krb5_tgt->tgt_ticket_.times.endtime);
+    ret = krb5_timeofday(ctx_, &match_creds->creds.times.endtime);
     if (ret)
     {
         logger_.error().formatted(
             "Failed initializing krb5 end time [{}] [{}]", ret, krb5_get_error_message(ctx_, ret));
+        release_match_creds(match_creds);
         return false;
     }
-    krb5_tgt->tgt_ticket_.times.endtime += lifetime.count();
+    match_creds->creds.times.endtime += lifetime.count();
     return true;
 }
 
-KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_service_ticket_direct(KRB5KerberosTGTTicket* const krb5_tgt,
-                                                                                  const std::string& service,
-                                                                                  std::chrono::seconds lifetime)
+void KRB5KerberosAuthenticator::release_match_creds(MatchCreds* match_creds)
 {
+    // Everything is borrowed, from the tgt or the principal table
+    std::memset(reinterpret_cast<void*>(&match_creds->creds), 0, sizeof(krb5_creds));
+    match_creds->client.reset();
+    match_creds->server.reset();
+}
+
+KRB5KerberosServiceTicketUniquePtr KRB5KerberosAuthenticator::generate_service_ticket_direct(
+    const KRB5KerberosTGTTicket* const krb5_tgt, const std::string& service, std::chrono::seconds lifetime)
+{
+    MatchCreds match_creds;
+
     logger_.info(settings_.session_id).formatted("Generating KRB5 service ticket for service [{}]", service);
 
-    if (!prepare_tgt_for_st_generation(krb5_tgt, service, lifetime))
+    if (!store_tgt(krb5_tgt) || !prepare_match_creds(krb5_tgt, service, lifetime, &match_creds))
     {
-        logger_.error(settings_.session_id).formatted("Failed preparing tgt ticket for service ticket generation");
+        logger_.error(settings_.session_id).formatted("Failed preparing match creds for service ticket generation");
         return nullptr;
     }
 
     // Get the service ticket
     auto ticket = std::make_unique<KRB5KerberosServiceTicket>(
         service,
-        std::chrono::time_point<std::chrono::system_clock>(std::chrono::seconds(krb5_tgt->tgt_ticket_.times.endtime)));
+        std::chrono::time_point<std::chrono::system_clock>(std::chrono::seconds(match_creds.creds.times.endtime)));
     ticket->ctx_ = ctx_;
 
-    auto ret = krb5_get_credentials(ctx_, 0, cache_, &krb5_tgt->tgt_ticket_, &ticket->service_ticket_);
+    krb5_creds* service_creds = nullptr;
+    auto ret = krb5_get_credentials(ctx_, 0, cache_, &match_creds.creds, &service_creds);
+    release_match_creds(&match_creds);
     if (ret)
     {
+        kdc_error_ = ret;
         logger_.error().formatted(
             "Failed getting credentials service ticket [{}] [{}]", ret, krb5_get_error_message(ctx_, ret));
         return nullptr;
     }
+    ticket->service_ticket_ = KRB5KerberosCredsPtr::adopt(service_creds, ctx_, KRB5KerberosCreds::Allocation::Heap);
+    if (!ticket->service_ticket_)
+    {
+        logger_.error(settings_.session_id) << "Failed allocating krb5 service ticket creds";
+        return nullptr;
+    }
     logger_.info(settings_.session_id)
         .formatted("Successfully generated a KRB5 service ticket for service [{}]", service);
     return ticket;
 }
 
-KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_service_ticket_streamlined(
-    KRB5KerberosTGTTicket* const krb5_tgt, const std::string& service, std::chrono::seconds lifetime)
+KRB5KerberosServiceTicketUniquePtr KRB5KerberosAuthenticator::generate_service_ticket_streamlined(
+    const KRB5KerberosTGTTicket* const krb5_tgt, const std::string& service, std::chrono::seconds lifetime)
 {
+    MatchCreds match_creds;
     krb5_tkt_creds_context tkt_ctx;
     krb5_data step_response, step_request, step_realm;
     unsigned int flags_out;
@@ -491,13 +505,17 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_service_ticket_strea
 
     logger_.info(settings_.session_id).formatted("Generating KRB5 service ticket for service [{}]", service);
 
-    if (!prepare_tgt_for_st_generation(krb5_tgt, service, lifetime))
+    if (!store_tgt(krb5_tgt) || !prepare_match_creds(krb5_tgt, service, lifetime, &match_creds))
     {
-        logger_.error(settings_.session_id).formatted("Failed preparing tgt ticket for service ticket generation");
+        logger_.error(settings_.session_id).formatted("Failed preparing match creds for service ticket generation");
         return nullptr;
     }
 
-    auto ret = krb5_tkt_creds_init(ctx_, cache_, &krb5_tgt->tgt_ticket_, 0, &tkt_ctx);
+    // The tkt creds context keeps its own copy of the match creds
+    const auto expiration =
+        std::chrono::time_point<std::chrono::system_clock>(std::chrono::seconds(match_creds.creds.times.endtime));
+    auto ret = krb5_tkt_creds_init(ctx_, cache_, &match_creds.creds, 0, &tkt_ctx);
+    release_match_creds(&match_creds);
     if (ret)
     {
         logger_.error(settings_.session_id)
@@ -517,6 +535,7 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_service_ticket_strea
         ret = krb5_tkt_creds_step(ctx_, tkt_ctx, &step_response, &step_request, &step_realm, &flags_out);
         if (ret)
         {
+            kdc_error_ = ret;
             logger_.error(settings_.session_id)
                 .formatted("Failed to run krb5 tkt creds step [{}] [{}]", ret, krb5_get_error_message(ctx_, ret));
             break;
@@ -555,13 +574,17 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_service_ticket_strea
         return nullptr;
     }
     // Get the service ticket
-    auto ticket = std::make_unique<KRB5KerberosServiceTicket>(
-        service,
-        std::chrono::time_point<std::chrono::system_clock>(std::chrono::seconds(krb5_tgt->tgt_ticket_.times.endtime)));
+    auto ticket = std::make_unique<KRB5KerberosServiceTicket>(service, expiration);
     ticket->ctx_ = ctx_;
-    ticket->service_ticket_ = static_cast<krb5_creds*>(calloc(1, sizeof(krb5_creds)));
+    auto service_creds = ticket->service_ticket_.replace(ctx_);
+    if (!service_creds)
+    {
+        logger_.error(settings_.session_id) << "Failed allocating krb5 service ticket creds";
+        krb5_tkt_creds_free(ctx_, tkt_ctx);
+        return nullptr;
+    }
 
-    ret = krb5_tkt_creds_get_creds(ctx_, tkt_ctx, ticket->service_ticket_);
+    ret = krb5_tkt_creds_get_creds(ctx_, tkt_ctx, service_creds);
     if (ret)
     {
         logger_.error(settings_.session_id)
@@ -581,10 +604,16 @@ KRB5KerberosAuthenticator::KRB5KerberosAuthenticator(KRB5KerberosAuthenticator::
       cache_(nullptr),
       server_(nullptr),
       is_initialized_(false),
+      is_tracing_(false),
       logger_("KRB5KerberosAuthenticator"),
       profile_vtable_(nullptr),
-      kdc_fd_(-1)
+      principals_(settings_.principals),
+      kdc_error_(0)
 {
+    if (!principals_)
+    {
+        principals_ = std::make_shared<KRB5KerberosPrincipalTable>();
+    }
     if (settings_.realm.empty())
     {
         throw std::runtime_error("Realm must be supplied for kerberos authentication");
@@ -603,7 +632,7 @@ KRB5KerberosAuthenticator::KRB5KerberosAuthenticator(KRB5KerberosAuthenticator::
 
 KRB5KerberosAuthenticator::~KRB5KerberosAuthenticator()
 {
-    if (is_initialized_)
+    if (is_initialized_ || is_tracing_)
     {
         if (!cleanup_authenticator())
         {
@@ -648,6 +677,20 @@ bool KRB5KerberosAuthenticator::initialize_authenticator()
         logger_.error().formatted("Failed initializing krb5 context [{}]", ret);
         return false;
     }
+    if (settings_.tracer)
+    {
+        logger_.info(settings_.session_id) << "Installing krb5 trace callback";
+        settings_.tracer->attach();
+        is_tracing_ = true;
+        ret = krb5_set_trace_callback(ctx_, &KRB5KerberosTracer::krb5_trace_callback, settings_.tracer.get());
+        if (ret)
+        {
+            logger_.warning(settings_.session_id)
+                .formatted("Failed installing krb5 trace callback, continuing without tracing [{}] [{}]",
+                           ret,
+                           krb5_get_error_message(ctx_, ret));
+        }
+    }
     logger_.info(settings_.session_id).formatted("Setting default realm to [{}]", settings_.realm);
     // Set default realm
     ret = krb5_set_default_realm(ctx_, settings_.realm.c_str());
@@ -691,6 +734,13 @@ bool KRB5KerberosAuthenticator::initialize_authenticator()
 
 bool KRB5KerberosAuthenticator::cleanup_authenticator()
 {
+    // Stop tracing before the context goes away, delivering what was traced so far
+    if (is_tracing_)
+    {
+        (void)krb5_set_trace_callback(ctx_, nullptr, nullptr);
+        settings_.tracer->detach();
+        is_tracing_ = false;
+    }
     if (is_initialized_)
     {
         logger_.info(settings_.session_id) << "Cleaning KRB5 authenticator";
@@ -699,6 +749,7 @@ bool KRB5KerberosAuthenticator::cleanup_authenticator()
 
         // Cleanup cache
         krb5_cc_destroy(ctx_, cache_);
+        cache_tgt_.clear();
 
         // Cleanup context
         krb5_free_context(ctx_);
@@ -724,14 +775,46 @@ bool KRB5KerberosAuthenticator::is_streamlined() const
     return settings_.streamlined;
 }
 
+const KRB5KerberosPrincipalTablePtr& KRB5KerberosAuthenticator::principals() const
+{
+    return principals_;
+}
+
 KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_tgt(const KerberosUserCredentials* const creds,
                                                                 std::chrono::seconds lifetime)
+{
+    return generate_krb5_tgt(creds, lifetime);
+}
+
+KRB5KerberosTGTTicketUniquePtr KRB5KerberosAuthenticator::generate_krb5_tgt(const KerberosUserCredentials* const creds,
+                                                                            std::chrono::seconds lifetime)
 {
     if (!is_initialized_)
     {
         logger_.warning(settings_.session_id) << "Cannot generate TGT when authenticator is not initialized";
         return nullptr;
     }
+    if (settings_.coalescer)
+    {
+        auto ticket =
+            settings_.coalescer->generate_tgt(*creds, lifetime, [this, creds, lifetime](krb5_error_code* error) {
+                kdc_error_ = 0;
+                auto ticket = settings_.streamlined ? generate_tgt_streamlined(creds, lifetime)
+                                                    : generate_tgt_direct(creds, lifetime);
+                *error = kdc_error_;
+                return ticket;
+            });
+        // The exchange may have run on another authenticator, its creds are taken over and go to cache_ on first use
+        if (ticket && ticket->ctx_ != ctx_)
+        {
+            if (!take_over_creds(&ticket->tgt_ticket_))
+            {
+                return nullptr;
+            }
+            ticket->ctx_ = ctx_;
+        }
+        return ticket;
+    }
     if (settings_.streamlined)
     {
         return generate_tgt_streamlined(creds, lifetime);
@@ -740,6 +823,11 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_tgt(const KerberosUs
 }
 
 KerberosTicketUniquePtr KRB5KerberosAuthenticator::deserialize_tgt(const nlohmann::json& json)
+{
+    return deserialize_krb5_tgt(json);
+}
+
+KRB5KerberosTGTTicketUniquePtr KRB5KerberosAuthenticator::deserialize_krb5_tgt(const nlohmann::json& json)
 {
     if (!is_initialized_)
     {
@@ -756,7 +844,51 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::deserialize_tgt(const nlohman
     return ticket;
 }
 
-KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_service_ticket(KerberosTicket* const tgt,
+KerberosTicketUniquePtr KRB5KerberosAuthenticator::deserialize_tgt_binary(std::string_view data)
+{
+    return deserialize_krb5_tgt_binary(data);
+}
+
+KRB5KerberosTGTTicketUniquePtr KRB5KerberosAuthenticator::deserialize_krb5_tgt_binary(std::string_view data)
+{
+    if (!is_initialized_)
+    {
+        logger_.warning(settings_.session_id) << "Cannot deserialize TGT when authenticator is not initialized";
+        return nullptr;
+    }
+    auto ticket = std::make_unique<KRB5KerberosTGTTicket>();
+    ticket->ctx_ = ctx_;
+    if (!ticket->deserialize_binary(data))
+    {
+        logger_.warning(settings_.session_id) << "Failed to deserialize binary tgt";
+        return nullptr;
+    }
+    return ticket;
+}
+
+KerberosTicketUniquePtr KRB5KerberosAuthenticator::deserialize_tgt_text(std::string_view text)
+{
+    return deserialize_krb5_tgt_text(text);
+}
+
+KRB5KerberosTGTTicketUniquePtr KRB5KerberosAuthenticator::deserialize_krb5_tgt_text(std::string_view text)
+{
+    if (!is_initialized_)
+    {
+        logger_.warning(settings_.session_id) << "Cannot deserialize TGT when authenticator is not initialized";
+        return nullptr;
+    }
+    auto ticket = std::make_unique<KRB5KerberosTGTTicket>();
+    ticket->ctx_ = ctx_;
+    if (!ticket->deserialize_text(text))
+    {
+        logger_.warning(settings_.session_id) << "Failed to deserialize tgt text";
+        return nullptr;
+    }
+    return ticket;
+}
+
+KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_service_ticket(const KerberosTicket* const tgt,
                                                                            const std::string& service,
                                                                            std::chrono::seconds lifetime)
 {
@@ -770,15 +902,58 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::generate_service_ticket(Kerbe
         logger_.error(settings_.session_id) << "Cannot generate a service ticket using a non-tgt ticket";
         return nullptr;
     }
-    auto const krb5_tgt = dynamic_cast<KRB5KerberosTGTTicket* const>(tgt);
+    auto const krb5_tgt = dynamic_cast<const KRB5KerberosTGTTicket* const>(tgt);
+    if (!krb5_tgt)
+    {
+        logger_.error(settings_.session_id) << "Cannot generate a service ticket using a non-krb5 tgt";
+        return nullptr;
+    }
+    return generate_service_ticket(krb5_tgt, service, lifetime);
+}
+
+KRB5KerberosServiceTicketUniquePtr KRB5KerberosAuthenticator::generate_service_ticket(
+    const KRB5KerberosTGTTicket* const tgt, const std::string& service, std::chrono::seconds lifetime)
+{
+    if (!is_initialized_)
+    {
+        logger_.warning(settings_.session_id) << "Cannot generate service token when authenticator is not initialized";
+        return nullptr;
+    }
+    if (settings_.coalescer)
+    {
+        auto ticket =
+            settings_.coalescer->generate_service_ticket(*tgt, service, lifetime, [&](krb5_error_code* error) {
+                kdc_error_ = 0;
+                auto ticket = settings_.streamlined ? generate_service_ticket_streamlined(tgt, service, lifetime)
+                                                    : generate_service_ticket_direct(tgt, service, lifetime);
+                *error = kdc_error_;
+                return ticket;
+            });
+        // The exchange may have run on another authenticator
+        if (ticket && ticket->ctx_ != ctx_)
+        {
+            if (!take_over_creds(&ticket->service_ticket_))
+            {
+                return nullptr;
+            }
+            ticket->ctx_ = ctx_;
+        }
+        return ticket;
+    }
     if (settings_.streamlined)
     {
-        return generate_service_ticket_streamlined(krb5_tgt, service, lifetime);
+        return generate_service_ticket_streamlined(tgt, service, lifetime);
     }
-    return generate_service_ticket_direct(krb5_tgt, service, lifetime);
+    return generate_service_ticket_direct(tgt, service, lifetime);
 }
 
 KerberosTicketUniquePtr KRB5KerberosAuthenticator::deserialize_service_ticket(const nlohmann::json& json)
+{
+    return deserialize_krb5_service_ticket(json);
+}
+
+KRB5KerberosServiceTicketUniquePtr KRB5KerberosAuthenticator::deserialize_krb5_service_ticket(
+    const nlohmann::json& json)
 {
     if (!is_initialized_)
     {
@@ -788,6 +963,7 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::deserialize_service_ticket(co
     }
     auto ticket = std::make_unique<KRB5KerberosServiceTicket>();
     ticket->ctx_ = ctx_;
+    ticket->contiguous_ = settings_.contiguous_service_tickets;
     if (!ticket->deserialize(json))
     {
         logger_.warning(settings_.session_id) << "Failed to deserialize service ticket";
@@ -796,6 +972,287 @@ KerberosTicketUniquePtr KRB5KerberosAuthenticator::deserialize_service_ticket(co
     return ticket;
 }
 
+KerberosTicketUniquePtr KRB5KerberosAuthenticator::deserialize_service_ticket_binary(std::string_view data)
+{
+    return deserialize_krb5_service_ticket_binary(data);
+}
+
+KRB5KerberosServiceTicketUniquePtr KRB5KerberosAuthenticator::deserialize_krb5_service_ticket_binary(
+    std::string_view data)
+{
+    if (!is_initialized_)
+    {
+        logger_.warning(settings_.session_id)
+            << "Cannot deserialize service ticket when authenticator is not initialized";
+        return nullptr;
+    }
+    auto ticket = std::make_unique<KRB5KerberosServiceTicket>();
+    ticket->ctx_ = ctx_;
+    ticket->contiguous_ = settings_.contiguous_service_tickets;
+    if (!ticket->deserialize_binary(data))
+    {
+        logger_.warning(settings_.session_id) << "Failed to deserialize binary service ticket";
+        return nullptr;
+    }
+    return ticket;
+}
+
+KerberosTicketUniquePtr KRB5KerberosAuthenticator::deserialize_service_ticket_text(std::string_view text)
+{
+    return deserialize_krb5_service_ticket_text(text);
+}
+
+KRB5KerberosServiceTicketUniquePtr KRB5KerberosAuthenticator::deserialize_krb5_service_ticket_text(
+    std::string_view text)
+{
+    if (!is_initialized_)
+    {
+        logger_.warning(settings_.session_id)
+            << "Cannot deserialize service ticket when authenticator is not initialized";
+        return nullptr;
+    }
+    auto ticket = std::make_unique<KRB5KerberosServiceTicket>();
+    ticket->ctx_ = ctx_;
+    ticket->contiguous_ = settings_.contiguous_service_tickets;
+    if (!ticket->deserialize_text(text))
+    {
+        logger_.warning(settings_.session_id) << "Failed to deserialize service ticket text";
+        return nullptr;
+    }
+    return ticket;
+}
+
+bool KRB5KerberosAuthenticator::import_ccache(std::string_view data, std::vector<KerberosTicketUniquePtr>* tickets)
+{
+    if (!is_initialized_)
+    {
+        logger_.warning(settings_.session_id) << "Cannot import ccache when authenticator is not initialized";
+        return false;
+    }
+    krb5_principal default_principal = nullptr;
+    std::vector<krb5_creds> creds;
+    if (!KRB5KerberosSerializer::deserialize_ccache(data, &default_principal, &creds, ctx_))
+    {
+        logger_.warning(settings_.session_id) << "Failed to parse ccache";
+        return false;
+    }
+    krb5_free_principal(ctx_, default_principal);
+    tickets->reserve(tickets->size() + creds.size());
+    for (auto& curr_creds : creds)
+    {
+        char* client_name = nullptr;
+        char* server_name = nullptr;
+        if (KRB5KerberosSerializer::is_ccache_config_creds(curr_creds)
+            || krb5_unparse_name_flags(ctx_, curr_creds.client, KRB5_PRINCIPAL_UNPARSE_NO_REALM, &client_name)
+            || krb5_unparse_name_flags(ctx_, curr_creds.server, KRB5_PRINCIPAL_UNPARSE_NO_REALM, &server_name))
+        {
+            krb5_free_unparsed_name(ctx_, client_name);
+            krb5_free_cred_contents(ctx_, &curr_creds);
+            continue;
+        }
+        const auto expiration =
+            std::chrono::time_point<std::chrono::system_clock>(std::chrono::seconds(curr_creds.times.endtime));
+        const auto is_tgt = curr_creds.server->length > 0 && curr_creds.server->data[0].data
+                            && std::string_view(curr_creds.server->data[0].data, curr_creds.server->data[0].length)
+                                   == KRB5_TGS_NAME;
+        // Ownership of the creds contents moves into the ticket
+        if (is_tgt)
+        {
+            auto ticket = std::make_unique<KRB5KerberosTGTTicket>(client_name, expiration);
+            ticket->ctx_ = ctx_;
+            auto tgt_creds = ticket->tgt_ticket_.replace(ctx_);
+            if (tgt_creds)
+            {
+                *tgt_creds = curr_creds;
+                tickets->push_back(std::move(ticket));
+            }
+            else
+            {
+                krb5_free_cred_contents(ctx_, &curr_creds);
+            }
+        }
+        else
+        {
+            auto ticket = std::make_unique<KRB5KerberosServiceTicket>(server_name, expiration);
+            ticket->ctx_ = ctx_;
+            auto service_creds = ticket->service_ticket_.replace(ctx_);
+            if (service_creds)
+            {
+                *service_creds = curr_creds;
+                tickets->push_back(std::move(ticket));
+            }
+            else
+            {
+                krb5_free_cred_contents(ctx_, &curr_creds);
+            }
+        }
+        krb5_free_unparsed_name(ctx_, client_name);
+        krb5_free_unparsed_name(ctx_, server_name);
+    }
+    return true;
+}
+
+bool KRB5KerberosAuthenticator::export_ccache(const std::vector<const KerberosTicket*>& tickets, std::string* data)
+{
+    std::vector<const krb5_creds*> creds;
+    creds.reserve(tickets.size());
+    for (const auto ticket : tickets)
+    {
+        if (!ticket)
+        {
+            continue;
+        }
+        auto const krb5_tgt = dynamic_cast<const KRB5KerberosTGTTicket*>(ticket);
+        auto const krb5_service_ticket = dynamic_cast<const KRB5KerberosServiceTicket*>(ticket);
+        if (!krb5_tgt && !krb5_service_ticket)
+        {
+            logger_.error(settings_.session_id) << "Cannot export a non-krb5 ticket to a ccache";
+            return false;
+        }
+        const auto ticket_creds = krb5_tgt ? krb5_tgt->tgt_ticket_.get() : krb5_service_ticket->service_ticket_.get();
+        // Tickets that never held creds have nothing to export
+        if (ticket_creds)
+        {
+            creds.push_back(ticket_creds);
+        }
+    }
+    if (creds.empty() || !creds.front() || !creds.front()->client)
+    {
+        logger_.warning(settings_.session_id) << "Cannot export an empty ccache";
+        return false;
+    }
+    // Like kinit, the first ticket's client becomes the default principal of the cache
+    *data = KRB5KerberosSerializer::serialize_ccache(*creds.front()->client, creds);
+    return true;
+}
+
+KRB5KerberosThreadPool& KRB5KerberosAuthenticator::bulk_pool()
+{
+    std::lock_guard<std::mutex> lock(bulk_pool_mutex_);
+    if (!bulk_pool_)
+    {
+        bulk_pool_ = std::make_unique<KRB5KerberosThreadPool>(settings_.bulk_threads);
+        logger_.info(settings_.session_id).formatted("Started [{}] bulk worker threads", bulk_pool_->threads());
+    }
+    return *bulk_pool_;
+}
+
+KRB5KerberosAuthenticator::BulkDeserializeResult KRB5KerberosAuthenticator::deserialize_bulk_item(
+    std::string_view data, BulkFormat format, KerberosTicket::Type type) const
+{
+    BulkDeserializeResult result;
+    KerberosTicketUniquePtr ticket;
+    if (type == KerberosTicket::Type::TicketGrantingTicket)
+    {
+        auto tgt = std::make_unique<KRB5KerberosTGTTicket>();
+        tgt->ctx_ = ctx_;
+        ticket = std::move(tgt);
+    }
+    else
+    {
+        auto service_ticket = std::make_unique<KRB5KerberosServiceTicket>();
+        service_ticket->ctx_ = ctx_;
+        service_ticket->contiguous_ = settings_.contiguous_service_tickets;
+        ticket = std::move(service_ticket);
+    }
+    try
+    {
+        if (format == BulkFormat::Binary ? ticket->deserialize_binary(data) : ticket->deserialize_text(data))
+        {
+            result.ticket = std::move(ticket);
+        }
+        else
+        {
+            result.error = format == BulkFormat::Binary ? "Malformed binary ticket" : "Malformed json ticket";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        result.error = e.what();
+    }
+    return result;
+}
+
+std::vector<KRB5KerberosAuthenticator::BulkDeserializeResult> KRB5KerberosAuthenticator::deserialize_bulk(
+    const std::vector<std::string_view>& data, BulkFormat format, KerberosTicket::Type type)
+{
+    std::vector<BulkDeserializeResult> results(data.size());
+    if (!is_initialized_)
+    {
+        logger_.warning(settings_.session_id) << "Cannot deserialize tickets when authenticator is not initialized";
+        for (auto& result : results)
+        {
+            result.error = "Authenticator is not initialized";
+        }
+        return results;
+    }
+    // Only the context is shared and it is only used to release creds, the items are independent of each other
+    bulk_pool().parallel_for(data.size(), BULK_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+        {
+            results[i] = deserialize_bulk_item(data[i], format, type);
+        }
+    });
+    const auto failed = std::count_if(
+        results.begin(), results.end(), [](const BulkDeserializeResult& result) { return !result.ticket; });
+    if (failed > 0)
+    {
+        logger_.warning(settings_.session_id)
+            .formatted("Failed to deserialize [{}] out of [{}] tickets", failed, results.size());
+    }
+    return results;
+}
+
+std::vector<KRB5KerberosAuthenticator::BulkDeserializeResult> KRB5KerberosAuthenticator::deserialize_tgts(
+    const std::vector<std::string_view>& data, BulkFormat format)
+{
+    return deserialize_bulk(data, format, KerberosTicket::Type::TicketGrantingTicket);
+}
+
+std::vector<KRB5KerberosAuthenticator::BulkDeserializeResult> KRB5KerberosAuthenticator::deserialize_service_tickets(
+    const std::vector<std::string_view>& data, BulkFormat format)
+{
+    return deserialize_bulk(data, format, KerberosTicket::Type::ServiceTicket);
+}
+
+std::vector<KRB5KerberosAuthenticator::BulkSerializeResult> KRB5KerberosAuthenticator::serialize_all(
+    const std::vector<const KerberosTicket*>& tickets, BulkFormat format)
+{
+    std::vector<BulkSerializeResult> results(tickets.size());
+    bulk_pool().parallel_for(tickets.size(), BULK_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+        // Tickets of a chunk are usually alike, so each output starts with the capacity of the previous one
+        std::size_t size_hint = 0;
+        for (auto i = begin; i < end; ++i)
+        {
+            auto& result = results[i];
+            if (!tickets[i])
+            {
+                result.error = "Ticket cannot be empty";
+                continue;
+            }
+            try
+            {
+                if (format == BulkFormat::Binary)
+                {
+                    result.data = tickets[i]->serialize_binary();
+                }
+                else
+                {
+                    result.data.reserve(size_hint);
+                    tickets[i]->serialize_to(&result.data);
+                }
+                size_hint = result.data.size();
+            }
+            catch (const std::exception& e)
+            {
+                result.data.clear();
+                result.error = e.what();
+            }
+        }
+    });
+    return results;
+}
+
 long KRB5KerberosAuthenticator::get_profile_values(const char* const* names, char*** ret_values)
 {
     auto curr_name = names;
@@ -0,0 +1,447 @@
+/**
+ * @file krb5-kerberos-base64.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-base64.hpp"
+#include <array>
+
+#if defined(KRB5_KERBEROS_CPU_X86)
+#include <immintrin.h>
+#elif defined(KRB5_KERBEROS_CPU_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+using octo::kerberos::krb5::KRB5KerberosBase64;
+using octo::kerberos::krb5::KRB5KerberosCpuDispatch;
+
+constexpr const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr const char PADDING = '=';
+constexpr const std::uint8_t INVALID = 0xff;
+
+constexpr std::array<std::uint8_t, 256> make_decode_table()
+{
+    std::array<std::uint8_t, 256> table{};
+    for (auto& entry : table)
+    {
+        entry = INVALID;
+    }
+    for (std::uint8_t i = 0; i < 64; ++i)
+    {
+        table[static_cast<unsigned char>(ALPHABET[i])] = i;
+    }
+    return table;
+}
+
+constexpr const std::array<std::uint8_t, 256> DECODE_TABLE = make_decode_table();
+
+/**
+ * Every implementation only handles whole blocks and returns how much input it consumed, always a multiple of 3
+ * input bytes when encoding and of 4 characters when decoding. The scalar codec finishes what is left, which is also
+ * where invalid characters are reported, a vector decoder stops right before the first block it cannot decode.
+ */
+struct Codec
+{
+    KRB5KerberosBase64::Implementation implementation;
+    std::size_t (*encode_blocks)(const unsigned char* src, std::size_t size, char* out);
+    std::size_t (*decode_blocks)(const char* src, std::size_t length, unsigned char* out);
+};
+
+std::size_t encode_blocks_scalar(const unsigned char*, std::size_t, char*)
+{
+    return 0;
+}
+
+std::size_t decode_blocks_scalar(const char*, std::size_t, unsigned char*)
+{
+    return 0;
+}
+
+void encode_scalar(const unsigned char* src, std::size_t size, char* out)
+{
+    std::size_t i = 0;
+    for (; i + 3 <= size; i += 3, out += 4)
+    {
+        const std::uint32_t value = (src[i] << 16) | (src[i + 1] << 8) | src[i + 2];
+        out[0] = ALPHABET[value >> 18];
+        out[1] = ALPHABET[(value >> 12) & 0x3f];
+        out[2] = ALPHABET[(value >> 6) & 0x3f];
+        out[3] = ALPHABET[value & 0x3f];
+    }
+    if (size - i == 1)
+    {
+        const std::uint32_t value = src[i] << 16;
+        out[0] = ALPHABET[value >> 18];
+        out[1] = ALPHABET[(value >> 12) & 0x3f];
+        out[2] = PADDING;
+        out[3] = PADDING;
+    }
+    else if (size - i == 2)
+    {
+        const std::uint32_t value = (src[i] << 16) | (src[i + 1] << 8);
+        out[0] = ALPHABET[value >> 18];
+        out[1] = ALPHABET[(value >> 12) & 0x3f];
+        out[2] = ALPHABET[(value >> 6) & 0x3f];
+        out[3] = PADDING;
+    }
+}
+
+// Padding is only allowed to complete the last quad
+[[nodiscard]] std::size_t unpadded_length(std::string_view encoded)
+{
+    auto length = encoded.size();
+    if (length % 4 == 0 && length > 0 && encoded[length - 1] == PADDING)
+    {
+        length -= encoded[length - 2] == PADDING ? 2 : 1;
+    }
+    return length;
+}
+
+// Length excludes the padding
+[[nodiscard]] bool decode_scalar(const char* src, std::size_t length, unsigned char* out)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= length; i += 4, out += 3)
+    {
+        const auto a = DECODE_TABLE[static_cast<unsigned char>(src[i])];
+        const auto b = DECODE_TABLE[static_cast<unsigned char>(src[i + 1])];
+        const auto c = DECODE_TABLE[static_cast<unsigned char>(src[i + 2])];
+        const auto d = DECODE_TABLE[static_cast<unsigned char>(src[i + 3])];
+        if ((a | b | c | d) == INVALID)
+        {
+            return false;
+        }
+        const std::uint32_t value = (a << 18) | (b << 12) | (c << 6) | d;
+        out[0] = static_cast<unsigned char>(value >> 16);
+        out[1] = static_cast<unsigned char>(value >> 8);
+        out[2] = static_cast<unsigned char>(value);
+    }
+    const auto remaining = length - i;
+    if (remaining == 0)
+    {
+        return true;
+    }
+    const auto a = DECODE_TABLE[static_cast<unsigned char>(src[i])];
+    const auto b = DECODE_TABLE[static_cast<unsigned char>(src[i + 1])];
+    const auto c = remaining == 3 ? DECODE_TABLE[static_cast<unsigned char>(src[i + 2])] : 0;
+    if ((a | b | c) == INVALID)
+    {
+        return false;
+    }
+    const std::uint32_t value = (a << 18) | (b << 12) | (c << 6);
+    out[0] = static_cast<unsigned char>(value >> 16);
+    if (remaining == 3)
+    {
+        out[1] = static_cast<unsigned char>(value >> 8);
+    }
+    return true;
+}
+
+#if defined(KRB5_KERBEROS_CPU_X86)
+/**
+ * Vector codecs after W. Mula and D. Lemire, "Faster Base64 Encoding and Decoding Using AVX2 Instructions".
+ * The AVX2 variants run the SSSE3 algorithm on both 128 bit lanes, so they share the same constants.
+ */
+__attribute__((target("ssse3"))) __m128i encode_reshuffle_ssse3(__m128i in)
+{
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const auto t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const auto t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const auto t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const auto t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+__attribute__((target("ssse3"))) __m128i encode_translate_ssse3(__m128i indices)
+{
+    auto result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const auto less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+    const auto shift = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '+' - 62, '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(shift, result), indices);
+}
+
+// Reads 16 bytes per 12 encoded
+__attribute__((target("ssse3"))) std::size_t encode_blocks_ssse3(const unsigned char* src, std::size_t size, char* out)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 12, out += 16)
+    {
+        const auto in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), encode_translate_ssse3(encode_reshuffle_ssse3(in)));
+    }
+    return i;
+}
+
+// Writes 16 bytes per 12 decoded, stops while the output still has room for the whole store
+__attribute__((target("ssse3"))) std::size_t decode_blocks_ssse3(const char* src, std::size_t length, unsigned char* out)
+{
+    const auto lut_lo = _mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const auto lut_hi = _mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const auto lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const auto mask_2f = _mm_set1_epi8(0x2f);
+    std::size_t i = 0;
+    for (; i + 24 <= length; i += 16, out += 12)
+    {
+        auto in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const auto hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2f);
+        const auto lo_nibbles = _mm_and_si128(in, mask_2f);
+        const auto hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        const auto lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0)
+        {
+            break;
+        }
+        const auto eq_2f = _mm_cmpeq_epi8(in, mask_2f);
+        in = _mm_add_epi8(in, _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles)));
+        const auto merged = _mm_madd_epi16(_mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140)),
+                                           _mm_set1_epi32(0x00011000));
+        const auto packed =
+            _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+    }
+    return i;
+}
+
+// Reads 28 bytes per 24 encoded, two overlapping 16 byte loads feed the two lanes
+__attribute__((target("avx2"))) std::size_t encode_blocks_avx2(const unsigned char* src, std::size_t size, char* out)
+{
+    const auto shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                         10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const auto shift = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '+' - 62, '/' - 63, 'A', 0, 0, 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    std::size_t i = 0;
+    for (; i + 28 <= size; i += 24, out += 32)
+    {
+        auto in = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12)),
+            1);
+        in = _mm256_shuffle_epi8(in, shuffle);
+        const auto t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        const auto t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const auto t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        const auto t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const auto indices = _mm256_or_si256(t1, t3);
+        auto result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const auto less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        result = _mm256_add_epi8(_mm256_shuffle_epi8(shift, result), indices);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), result);
+    }
+    return i + encode_blocks_ssse3(src + i, size - i, out);
+}
+
+// Writes 32 bytes per 24 decoded, stops while the output still has room for the whole store
+__attribute__((target("avx2"))) std::size_t decode_blocks_avx2(const char* src, std::size_t length, unsigned char* out)
+{
+    const auto lut_lo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const auto lut_hi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const auto lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                           0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const auto mask_2f = _mm256_set1_epi8(0x2f);
+    const auto pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                       2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    std::size_t i = 0;
+    for (; i + 48 <= length; i += 32, out += 24)
+    {
+        auto in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const auto hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask_2f);
+        const auto lo_nibbles = _mm256_and_si256(in, mask_2f);
+        const auto hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        const auto lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        if (!_mm256_testz_si256(lo, hi))
+        {
+            break;
+        }
+        const auto eq_2f = _mm256_cmpeq_epi8(in, mask_2f);
+        in = _mm256_add_epi8(in, _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles)));
+        const auto merged = _mm256_madd_epi16(_mm256_maddubs_epi16(in, _mm256_set1_epi32(0x01400140)),
+                                              _mm256_set1_epi32(0x00011000));
+        const auto packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(merged, pack),
+                                                        _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+    }
+    return i + decode_blocks_ssse3(src + i, length - i, out);
+}
+#elif defined(KRB5_KERBEROS_CPU_NEON)
+// 48 bytes to 64 characters, the de-interleaving loads and stores do the reshuffling
+std::size_t encode_blocks_neon(const unsigned char* src, std::size_t size, char* out)
+{
+    const auto alphabet = vld1q_u8_x4(reinterpret_cast<const std::uint8_t*>(ALPHABET));
+    const auto mask = vdupq_n_u8(0x3f);
+    std::size_t i = 0;
+    for (; i + 48 <= size; i += 48, out += 64)
+    {
+        const auto in = vld3q_u8(src + i);
+        uint8x16x4_t indices;
+        indices.val[0] = vshrq_n_u8(in.val[0], 2);
+        indices.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+        indices.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+        indices.val[3] = vandq_u8(in.val[2], mask);
+        uint8x16x4_t result;
+        result.val[0] = vqtbl4q_u8(alphabet, indices.val[0]);
+        result.val[1] = vqtbl4q_u8(alphabet, indices.val[1]);
+        result.val[2] = vqtbl4q_u8(alphabet, indices.val[2]);
+        result.val[3] = vqtbl4q_u8(alphabet, indices.val[3]);
+        vst4q_u8(reinterpret_cast<std::uint8_t*>(out), result);
+    }
+    return i;
+}
+
+// Sets valid to all ones for every byte inside the alphabet
+uint8x16_t decode_translate_neon(uint8x16_t in, uint8x16_t* valid)
+{
+    const auto upper = vandq_u8(vcgeq_u8(in, vdupq_n_u8('A')), vcleq_u8(in, vdupq_n_u8('Z')));
+    const auto lower = vandq_u8(vcgeq_u8(in, vdupq_n_u8('a')), vcleq_u8(in, vdupq_n_u8('z')));
+    const auto digit = vandq_u8(vcgeq_u8(in, vdupq_n_u8('0')), vcleq_u8(in, vdupq_n_u8('9')));
+    const auto plus = vceqq_u8(in, vdupq_n_u8('+'));
+    const auto slash = vceqq_u8(in, vdupq_n_u8('/'));
+    *valid = vorrq_u8(vorrq_u8(vorrq_u8(upper, lower), vorrq_u8(digit, plus)), slash);
+    auto result = vandq_u8(upper, vsubq_u8(in, vdupq_n_u8('A')));
+    result = vorrq_u8(result, vandq_u8(lower, vsubq_u8(in, vdupq_n_u8('a' - 26))));
+    result = vorrq_u8(result, vandq_u8(digit, vaddq_u8(in, vdupq_n_u8(52 - '0'))));
+    result = vorrq_u8(result, vandq_u8(plus, vdupq_n_u8(62)));
+    return vorrq_u8(result, vandq_u8(slash, vdupq_n_u8(63)));
+}
+
+// 64 characters to 48 bytes
+std::size_t decode_blocks_neon(const char* src, std::size_t length, unsigned char* out)
+{
+    std::size_t i = 0;
+    for (; i + 64 <= length; i += 64, out += 48)
+    {
+        const auto in = vld4q_u8(reinterpret_cast<const std::uint8_t*>(src + i));
+        uint8x16_t valid[4];
+        uint8x16x4_t values;
+        for (auto j = 0; j < 4; ++j)
+        {
+            values.val[j] = decode_translate_neon(in.val[j], &valid[j]);
+        }
+        if (vminvq_u8(vandq_u8(vandq_u8(valid[0], valid[1]), vandq_u8(valid[2], valid[3]))) == 0)
+        {
+            break;
+        }
+        uint8x16x3_t result;
+        result.val[0] = vorrq_u8(vshlq_n_u8(values.val[0], 2), vshrq_n_u8(values.val[1], 4));
+        result.val[1] = vorrq_u8(vshlq_n_u8(values.val[1], 4), vshrq_n_u8(values.val[2], 2));
+        result.val[2] = vorrq_u8(vshlq_n_u8(values.val[2], 6), values.val[3]);
+        vst3q_u8(out, result);
+    }
+    return i;
+}
+#endif
+
+constexpr const Codec SCALAR_CODEC{KRB5KerberosBase64::Implementation::Scalar, encode_blocks_scalar,
+                                   decode_blocks_scalar};
+#if defined(KRB5_KERBEROS_CPU_X86)
+constexpr const Codec SSSE3_CODEC{KRB5KerberosBase64::Implementation::SSSE3, encode_blocks_ssse3, decode_blocks_ssse3};
+constexpr const Codec AVX2_CODEC{KRB5KerberosBase64::Implementation::AVX2, encode_blocks_avx2, decode_blocks_avx2};
+#elif defined(KRB5_KERBEROS_CPU_NEON)
+constexpr const Codec NEON_CODEC{KRB5KerberosBase64::Implementation::NEON, encode_blocks_neon, decode_blocks_neon};
+#endif
+
+constexpr const Codec* const CODECS[] = {
+#if defined(KRB5_KERBEROS_CPU_X86)
+    &AVX2_CODEC,
+    &SSSE3_CODEC,
+#elif defined(KRB5_KERBEROS_CPU_NEON)
+    &NEON_CODEC,
+#endif
+    &SCALAR_CODEC};
+
+KRB5KerberosCpuDispatch<Codec>& dispatch()
+{
+    static KRB5KerberosCpuDispatch<Codec> codecs(CODECS);
+    return codecs;
+}
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+KRB5KerberosBase64::Implementation KRB5KerberosBase64::implementation()
+{
+    return dispatch().implementation();
+}
+
+const char* KRB5KerberosBase64::implementation_name(KRB5KerberosBase64::Implementation implementation)
+{
+    return KRB5KerberosCpu::implementation_name(implementation);
+}
+
+bool KRB5KerberosBase64::set_implementation(KRB5KerberosBase64::Implementation implementation)
+{
+    return dispatch().set_implementation(implementation);
+}
+
+std::size_t KRB5KerberosBase64::encoded_size(std::size_t size)
+{
+    return (size + 2) / 3 * 4;
+}
+
+bool KRB5KerberosBase64::decoded_size(std::string_view encoded, std::size_t* size)
+{
+    const auto length = unpadded_length(encoded);
+    if (length % 4 == 1)
+    {
+        return false;
+    }
+    *size = length / 4 * 3 + (length % 4 ? length % 4 - 1 : 0);
+    return true;
+}
+
+void KRB5KerberosBase64::encode(const void* data, std::size_t size, char* out)
+{
+    const auto src = static_cast<const unsigned char*>(data);
+    const auto consumed = dispatch().kernels().encode_blocks(src, size, out);
+    encode_scalar(src + consumed, size - consumed, out + consumed / 3 * 4);
+}
+
+std::string KRB5KerberosBase64::encode(const void* data, std::size_t size)
+{
+    std::string out(encoded_size(size), '\0');
+    encode(data, size, out.data());
+    return out;
+}
+
+bool KRB5KerberosBase64::decode(std::string_view encoded, void* out)
+{
+    const auto length = unpadded_length(encoded);
+    if (length % 4 == 1)
+    {
+        return false;
+    }
+    const auto dst = static_cast<unsigned char*>(out);
+    const auto consumed = dispatch().kernels().decode_blocks(encoded.data(), length, dst);
+    return decode_scalar(encoded.data() + consumed, length - consumed, dst + consumed / 4 * 3);
+}
+
+bool KRB5KerberosBase64::decode(std::string_view encoded, std::string* out)
+{
+    std::size_t size;
+    if (!decoded_size(encoded, &size))
+    {
+        return false;
+    }
+    out->resize(size);
+    return decode(encoded, out->data());
+}
+} // namespace octo::kerberos::krb5
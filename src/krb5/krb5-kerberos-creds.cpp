@@ -0,0 +1,238 @@
+/**
+ * @file krb5-kerberos-creds.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-creds.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-serializer.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-slab-pool.hpp"
+#include <cassert>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace
+{
+const krb5_creds EMPTY_CREDS{};
+
+// Called through a volatile pointer so the wipe of a buffer about to be released is not optimized away
+void zeroize(krb5_data* data)
+{
+    static void* (*const volatile memset_function)(void*, int, std::size_t) = std::memset;
+    if (data->data)
+    {
+        memset_function(data->data, 0, data->length);
+    }
+}
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+KRB5KerberosCreds::KRB5KerberosCreds(krb5_creds* creds, krb5_context ctx, Allocation allocation)
+    : creds_(creds), ctx_(ctx), allocation_(allocation), references_(1)
+{
+}
+
+KRB5KerberosCreds::~KRB5KerberosCreds()
+{
+    if (allocation_ == Allocation::Contiguous)
+    {
+        KRB5KerberosSerializer::free_creds_contiguous(creds_);
+        return;
+    }
+    // libkrb5 only wipes the key, the ticket blobs are wiped here
+    zeroize(&creds_->ticket);
+    zeroize(&creds_->second_ticket);
+    if (allocation_ == Allocation::Pooled)
+    {
+        krb5_free_cred_contents(ctx_, creds_);
+        KRB5KerberosSlabPool::of<krb5_creds>().deallocate(creds_);
+        return;
+    }
+    krb5_free_creds(ctx_, creds_);
+}
+
+// The pool hands out blocks of exactly this class
+void* KRB5KerberosCreds::operator new([[maybe_unused]] std::size_t size)
+{
+    assert(size == sizeof(KRB5KerberosCreds));
+    return KRB5KerberosSlabPool::of<KRB5KerberosCreds>().allocate();
+}
+
+void* KRB5KerberosCreds::operator new([[maybe_unused]] std::size_t size, const std::nothrow_t&) noexcept
+{
+    assert(size == sizeof(KRB5KerberosCreds));
+    return KRB5KerberosSlabPool::of<KRB5KerberosCreds>().allocate(std::nothrow);
+}
+
+void KRB5KerberosCreds::operator delete(void* ptr) noexcept
+{
+    KRB5KerberosSlabPool::of<KRB5KerberosCreds>().deallocate(ptr);
+}
+
+KRB5KerberosCredsPtr::KRB5KerberosCredsPtr() : block_(nullptr)
+{
+}
+
+KRB5KerberosCredsPtr::KRB5KerberosCredsPtr(KRB5KerberosCreds* block) : block_(block)
+{
+}
+
+KRB5KerberosCredsPtr::~KRB5KerberosCredsPtr()
+{
+    release();
+}
+
+KRB5KerberosCredsPtr::KRB5KerberosCredsPtr(const KRB5KerberosCredsPtr& other) : block_(other.block_)
+{
+    if (block_)
+    {
+        block_->references_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+KRB5KerberosCredsPtr::KRB5KerberosCredsPtr(KRB5KerberosCredsPtr&& other) noexcept : block_(other.block_)
+{
+    other.block_ = nullptr;
+}
+
+KRB5KerberosCredsPtr& KRB5KerberosCredsPtr::operator=(const KRB5KerberosCredsPtr& other)
+{
+    if (block_ != other.block_)
+    {
+        KRB5KerberosCredsPtr copy(other);
+        std::swap(block_, copy.block_);
+    }
+    return *this;
+}
+
+KRB5KerberosCredsPtr& KRB5KerberosCredsPtr::operator=(KRB5KerberosCredsPtr&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        block_ = other.block_;
+        other.block_ = nullptr;
+    }
+    return *this;
+}
+
+void KRB5KerberosCredsPtr::release()
+{
+    // The last reference has to see every write made through the others before releasing the creds
+    if (block_ && block_->references_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete block_;
+    }
+    block_ = nullptr;
+}
+
+KRB5KerberosCredsPtr KRB5KerberosCredsPtr::adopt(krb5_creds* creds,
+                                                 krb5_context ctx,
+                                                 KRB5KerberosCreds::Allocation allocation)
+{
+    if (!creds)
+    {
+        return {};
+    }
+    auto block = new (std::nothrow) KRB5KerberosCreds(creds, ctx, allocation);
+    if (!block)
+    {
+        if (allocation == KRB5KerberosCreds::Allocation::Contiguous)
+        {
+            KRB5KerberosSerializer::free_creds_contiguous(creds);
+        }
+        else if (allocation == KRB5KerberosCreds::Allocation::Pooled)
+        {
+            krb5_free_cred_contents(ctx, creds);
+            KRB5KerberosSlabPool::of<krb5_creds>().deallocate(creds);
+        }
+        else
+        {
+            krb5_free_creds(ctx, creds);
+        }
+        return {};
+    }
+    return KRB5KerberosCredsPtr(block);
+}
+
+KRB5KerberosCredsPtr::operator bool() const
+{
+    return block_ != nullptr;
+}
+
+const krb5_creds* KRB5KerberosCredsPtr::get() const
+{
+    return block_ ? block_->creds_ : nullptr;
+}
+
+const krb5_creds& KRB5KerberosCredsPtr::operator*() const
+{
+    return block_ ? *block_->creds_ : EMPTY_CREDS;
+}
+
+const krb5_creds* KRB5KerberosCredsPtr::operator->() const
+{
+    return &**this;
+}
+
+std::size_t KRB5KerberosCredsPtr::use_count() const
+{
+    return block_ ? block_->references_.load(std::memory_order_acquire) : 0;
+}
+
+std::string_view KRB5KerberosCredsPtr::encoded_ticket() const
+{
+    return block_ ? block_->encoded_ticket_.view(block_->creds_->ticket) : std::string_view();
+}
+
+krb5_creds* KRB5KerberosCredsPtr::mutate(krb5_context ctx)
+{
+    if (!block_)
+    {
+        return replace(ctx);
+    }
+    if (use_count() == 1 && block_->allocation_ != KRB5KerberosCreds::Allocation::Contiguous)
+    {
+        block_->encoded_ticket_.reset();
+        return block_->creds_;
+    }
+    krb5_creds* creds = nullptr;
+    if (krb5_copy_creds(ctx, block_->creds_, &creds))
+    {
+        return nullptr;
+    }
+    *this = adopt(creds, ctx, KRB5KerberosCreds::Allocation::Heap);
+    return block_ ? block_->creds_ : nullptr;
+}
+
+krb5_creds* KRB5KerberosCredsPtr::replace(krb5_context ctx)
+{
+    if (block_ && use_count() == 1 && block_->allocation_ != KRB5KerberosCreds::Allocation::Contiguous)
+    {
+        block_->encoded_ticket_.reset();
+        zeroize(&block_->creds_->ticket);
+        zeroize(&block_->creds_->second_ticket);
+        // Released with the context they were allocated with, the new contents belong to the given one
+        krb5_free_cred_contents(block_->ctx_, block_->creds_);
+        std::memset(reinterpret_cast<void*>(block_->creds_), 0, sizeof(krb5_creds));
+        block_->ctx_ = ctx;
+        return block_->creds_;
+    }
+    *this = adopt(static_cast<krb5_creds*>(KRB5KerberosSlabPool::of<krb5_creds>().allocate(std::nothrow)),
+                  ctx,
+                  KRB5KerberosCreds::Allocation::Pooled);
+    return block_ ? block_->creds_ : nullptr;
+}
+
+void KRB5KerberosCredsPtr::reset()
+{
+    release();
+}
+} // namespace octo::kerberos::krb5
@@ -0,0 +1,60 @@
+/**
+ * @file krb5-kerberos-encoded-ticket.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-encoded-ticket.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-base64.hpp"
+#include <cstring>
+
+namespace
+{
+// Called through a volatile pointer so the wipe of a buffer about to be released is not optimized away
+void zeroize(std::string* value)
+{
+    static void* (*const volatile memset_function)(void*, int, std::size_t) = std::memset;
+    memset_function(value->data(), 0, value->size());
+    value->clear();
+}
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+KRB5KerberosEncodedTicket::KRB5KerberosEncodedTicket() : is_encoded_(false)
+{
+}
+
+KRB5KerberosEncodedTicket::~KRB5KerberosEncodedTicket()
+{
+    zeroize(&encoded_);
+}
+
+std::string_view KRB5KerberosEncodedTicket::view(const krb5_data& ticket) const
+{
+    if (!is_encoded_.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!is_encoded_.load(std::memory_order_relaxed))
+        {
+            // Sized up front so the base64 is written in place, without a temporary holding a second copy
+            encoded_.resize(KRB5KerberosBase64::encoded_size(ticket.length));
+            KRB5KerberosBase64::encode(ticket.data, ticket.length, encoded_.data());
+            is_encoded_.store(true, std::memory_order_release);
+        }
+    }
+    return encoded_;
+}
+
+void KRB5KerberosEncodedTicket::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    zeroize(&encoded_);
+    is_encoded_.store(false, std::memory_order_release);
+}
+} // namespace octo::kerberos::krb5
@@ -0,0 +1,187 @@
+/**
+ * @file krb5-kerberos-json-writer.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-json-writer.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-base64.hpp"
+#include <charconv>
+
+namespace
+{
+constexpr const std::size_t STREAM_CHUNK_SIZE = 16 * 1024;
+constexpr const char HEX_DIGITS[] = "0123456789abcdef";
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+KRB5KerberosJsonWriter::KRB5KerberosJsonWriter(std::string* out)
+    : out_(out), stream_(nullptr), needs_separator_(false)
+{
+}
+
+KRB5KerberosJsonWriter::KRB5KerberosJsonWriter(std::ostream& stream)
+    : out_(&buffer_), stream_(&stream), needs_separator_(false)
+{
+    buffer_.reserve(STREAM_CHUNK_SIZE);
+}
+
+KRB5KerberosJsonWriter::~KRB5KerberosJsonWriter()
+{
+    flush();
+}
+
+void KRB5KerberosJsonWriter::separate()
+{
+    if (needs_separator_)
+    {
+        out_->push_back(',');
+    }
+}
+
+void KRB5KerberosJsonWriter::flush_if_full()
+{
+    if (stream_ && buffer_.size() >= STREAM_CHUNK_SIZE)
+    {
+        flush();
+    }
+}
+
+void KRB5KerberosJsonWriter::flush()
+{
+    if (stream_ && !buffer_.empty())
+    {
+        stream_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+}
+
+// Same escaping as nlohmann::json::dump() with ensure_ascii off
+void KRB5KerberosJsonWriter::write_escaped(std::string_view value)
+{
+    out_->push_back('"');
+    std::size_t run = 0;
+    for (std::size_t i = 0; i < value.size(); ++i)
+    {
+        const auto c = static_cast<unsigned char>(value[i]);
+        if (c >= 0x20 && c != '"' && c != '\\')
+        {
+            continue;
+        }
+        out_->append(value.data() + run, i - run);
+        run = i + 1;
+        switch (c)
+        {
+            case '"':
+                out_->append("\\\"");
+                break;
+            case '\\':
+                out_->append("\\\\");
+                break;
+            case '\b':
+                out_->append("\\b");
+                break;
+            case '\f':
+                out_->append("\\f");
+                break;
+            case '\n':
+                out_->append("\\n");
+                break;
+            case '\r':
+                out_->append("\\r");
+                break;
+            case '\t':
+                out_->append("\\t");
+                break;
+            default:
+            {
+                const char escaped[] = {'\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0xf]};
+                out_->append(escaped, sizeof(escaped));
+                break;
+            }
+        }
+    }
+    out_->append(value.data() + run, value.size() - run);
+    out_->push_back('"');
+}
+
+void KRB5KerberosJsonWriter::begin_object()
+{
+    separate();
+    out_->push_back('{');
+    needs_separator_ = false;
+}
+
+void KRB5KerberosJsonWriter::end_object()
+{
+    out_->push_back('}');
+    needs_separator_ = true;
+    flush_if_full();
+}
+
+void KRB5KerberosJsonWriter::begin_array()
+{
+    separate();
+    out_->push_back('[');
+    needs_separator_ = false;
+}
+
+void KRB5KerberosJsonWriter::end_array()
+{
+    out_->push_back(']');
+    needs_separator_ = true;
+    flush_if_full();
+}
+
+void KRB5KerberosJsonWriter::key(std::string_view name)
+{
+    separate();
+    write_escaped(name);
+    out_->push_back(':');
+    needs_separator_ = false;
+}
+
+void KRB5KerberosJsonWriter::value_int(std::int64_t value)
+{
+    char digits[24];
+    separate();
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out_->append(digits, result.ptr - digits);
+    needs_separator_ = true;
+}
+
+void KRB5KerberosJsonWriter::value_uint(std::uint64_t value)
+{
+    char digits[24];
+    separate();
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out_->append(digits, result.ptr - digits);
+    needs_separator_ = true;
+}
+
+void KRB5KerberosJsonWriter::value_string(std::string_view value)
+{
+    separate();
+    write_escaped(value);
+    needs_separator_ = true;
+    flush_if_full();
+}
+
+void KRB5KerberosJsonWriter::value_base64(const void* data, std::size_t size)
+{
+    separate();
+    out_->push_back('"');
+    const auto offset = out_->size();
+    out_->resize(offset + KRB5KerberosBase64::encoded_size(size));
+    KRB5KerberosBase64::encode(data, size, out_->data() + offset);
+    out_->push_back('"');
+    needs_separator_ = true;
+    flush_if_full();
+}
+} // namespace octo::kerberos::krb5
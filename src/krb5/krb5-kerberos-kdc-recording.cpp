@@ -0,0 +1,827 @@
+/**
+ * @file krb5-kerberos-kdc-recording.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-kdc-recording.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-byte-buffer.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <thread>
+
+namespace
+{
+constexpr const char KDC_RECORDING_MAGIC[] = {'O', 'K', 'K', 'R'};
+constexpr const std::uint16_t KDC_RECORDING_VERSION = 1;
+
+// DER identifiers of the kerberos messages (RFC 4120), every kerberos tag fits a single identifier byte
+constexpr const std::uint8_t DER_CONSTRUCTED = 0x20;
+constexpr const std::uint8_t DER_CONTEXT = 0xa0;
+constexpr const std::uint8_t DER_SEQUENCE = 0x30;
+constexpr const std::uint8_t DER_INTEGER = 0x02;
+constexpr const std::uint8_t DER_AUTHENTICATOR = 0x62;
+constexpr const std::uint8_t DER_AS_REQ = 0x6a;
+constexpr const std::uint8_t DER_AS_REP = 0x6b;
+constexpr const std::uint8_t DER_TGS_REQ = 0x6c;
+constexpr const std::uint8_t DER_TGS_REP = 0x6d;
+constexpr const std::uint8_t DER_AP_REQ = 0x6e;
+constexpr const std::uint8_t DER_ENC_AS_REP_PART = 0x79;
+constexpr const std::uint8_t DER_ENC_TGS_REP_PART = 0x7a;
+constexpr const std::uint8_t DER_KRB_ERROR = 0x7e;
+constexpr const auto DER_MAX_DEPTH = 32;
+constexpr const auto NO_PENDING_MATCH = std::numeric_limits<std::size_t>::max();
+
+constexpr const std::int64_t PA_TGS_REQ = 1;
+constexpr const std::int64_t PA_ETYPE_INFO2 = 19;
+constexpr const std::int64_t PA_REQ_ENC_PA_REP = 149;
+
+struct DerNode
+{
+    std::uint8_t tag = 0;
+    // Primitive nodes only
+    std::string content;
+    // Constructed nodes only
+    std::vector<DerNode> children;
+};
+
+bool parse_der(std::string_view* input, DerNode* node, int depth)
+{
+    if (depth > DER_MAX_DEPTH || input->size() < 2 || (static_cast<std::uint8_t>((*input)[0]) & 0x1f) == 0x1f)
+    {
+        return false;
+    }
+    node->tag = static_cast<std::uint8_t>((*input)[0]);
+    std::size_t length = static_cast<std::uint8_t>((*input)[1]);
+    std::size_t header = 2;
+    if (length & 0x80)
+    {
+        // Long form, the indefinite form is not DER
+        const auto count = length & 0x7f;
+        if (count == 0 || count > 4 || input->size() < header + count)
+        {
+            return false;
+        }
+        length = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            length = (length << 8) | static_cast<std::uint8_t>((*input)[header + i]);
+        }
+        header += count;
+    }
+    if (input->size() - header < length)
+    {
+        return false;
+    }
+    auto content = input->substr(header, length);
+    input->remove_prefix(header + length);
+
+    node->content.clear();
+    node->children.clear();
+    if (!(node->tag & DER_CONSTRUCTED))
+    {
+        node->content = std::string(content);
+        return true;
+    }
+    while (!content.empty())
+    {
+        node->children.emplace_back();
+        if (!parse_der(&content, &node->children.back(), depth + 1))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parse_der_message(std::string_view data, DerNode* node)
+{
+    return parse_der(&data, node, 0) && data.empty();
+}
+
+void serialize_der(const DerNode& node, std::string* output)
+{
+    std::string constructed;
+    if (node.tag & DER_CONSTRUCTED)
+    {
+        for (const auto& child : node.children)
+        {
+            serialize_der(child, &constructed);
+        }
+    }
+    const auto& content = (node.tag & DER_CONSTRUCTED) ? constructed : node.content;
+    output->push_back(static_cast<char>(node.tag));
+    if (content.size() < 0x80)
+    {
+        output->push_back(static_cast<char>(content.size()));
+    }
+    else
+    {
+        std::size_t count = 0;
+        for (auto length = content.size(); length > 0; length >>= 8)
+        {
+            ++count;
+        }
+        output->push_back(static_cast<char>(0x80 | count));
+        for (auto i = count; i > 0; --i)
+        {
+            output->push_back(static_cast<char>(content.size() >> ((i - 1) * 8)));
+        }
+    }
+    output->append(content);
+}
+
+std::string der_encode(const DerNode& node)
+{
+    std::string output;
+    serialize_der(node, &output);
+    return output;
+}
+
+// The explicitly tagged [number] field of a SEQUENCE
+DerNode* der_field(DerNode* sequence, unsigned number)
+{
+    if (!sequence || sequence->tag != DER_SEQUENCE)
+    {
+        return nullptr;
+    }
+    for (auto& child : sequence->children)
+    {
+        if (child.tag == (DER_CONTEXT | number) && child.children.size() == 1)
+        {
+            return &child.children.front();
+        }
+    }
+    return nullptr;
+}
+
+// The SEQUENCE wrapped by an [APPLICATION] tag
+DerNode* der_unwrap(DerNode* node, std::uint8_t tag)
+{
+    return node && node->tag == tag && node->children.size() == 1 && node->children.front().tag == DER_SEQUENCE
+               ? &node->children.front()
+               : nullptr;
+}
+
+bool der_integer(const DerNode* node, std::int64_t* value)
+{
+    if (!node || node->tag != DER_INTEGER || node->content.empty() || node->content.size() > 8)
+    {
+        return false;
+    }
+    *value = static_cast<std::int8_t>(node->content[0]);
+    for (std::size_t i = 1; i < node->content.size(); ++i)
+    {
+        *value = (*value << 8) | static_cast<std::uint8_t>(node->content[i]);
+    }
+    return true;
+}
+
+// PrincipalName ::= SEQUENCE { name-type [0] Int32, name-string [1] SEQUENCE OF KerberosString }
+std::vector<std::string> der_principal(DerNode* name)
+{
+    std::vector<std::string> components;
+    if (auto strings = der_field(name, 1))
+    {
+        for (const auto& component : strings->children)
+        {
+            components.push_back(component.content);
+        }
+    }
+    return components;
+}
+
+std::string join_principal(const std::vector<std::string>& components)
+{
+    std::string joined;
+    for (const auto& component : components)
+    {
+        joined.append(joined.empty() ? "" : "/").append(component);
+    }
+    return joined;
+}
+
+// PA-DATA ::= SEQUENCE { padata-type [1] Int32, padata-value [2] OCTET STRING }, within a SEQUENCE OF PA-DATA
+DerNode* find_padata(DerNode* method_data, std::int64_t type)
+{
+    if (!method_data || method_data->tag != DER_SEQUENCE)
+    {
+        return nullptr;
+    }
+    for (auto& padata : method_data->children)
+    {
+        std::int64_t padata_type;
+        if (der_integer(der_field(&padata, 1), &padata_type) && padata_type == type)
+        {
+            return der_field(&padata, 2);
+        }
+    }
+    return nullptr;
+}
+
+struct KdcRequest
+{
+    DerNode message;
+    DerNode* request = nullptr;
+    DerNode* body = nullptr;
+    std::string identity;
+};
+
+// KDC-REQ ::= SEQUENCE { pvno [1], msg-type [2], padata [3] OPTIONAL, req-body [4] KDC-REQ-BODY }
+// KDC-REQ-BODY ::= SEQUENCE { kdc-options [0], cname [1] OPTIONAL, realm [2], sname [3] OPTIONAL, from [4] OPTIONAL,
+//                             till [5], rtime [6] OPTIONAL, nonce [7], ... }
+bool parse_kdc_request(std::string_view data, KdcRequest* request)
+{
+    auto& message = request->message;
+    if (!parse_der_message(data, &message) || (message.tag != DER_AS_REQ && message.tag != DER_TGS_REQ))
+    {
+        return false;
+    }
+    request->request = der_unwrap(&message, message.tag);
+    request->body = der_field(request->request, 4);
+    auto realm = der_field(request->body, 2);
+    if (!realm || !der_field(request->body, 7))
+    {
+        return false;
+    }
+    request->identity.assign(1, static_cast<char>(message.tag));
+    request->identity.append(realm->content)
+        .append(1, '\0')
+        .append(join_principal(der_principal(der_field(request->body, 1))))
+        .append(1, '\0')
+        .append(join_principal(der_principal(der_field(request->body, 3))));
+    return true;
+}
+
+krb5_keyblock keyblock_of(const std::string& contents, krb5_enctype enctype)
+{
+    krb5_keyblock keyblock{};
+    keyblock.magic = KV5M_KEYBLOCK;
+    keyblock.enctype = enctype;
+    keyblock.length = contents.size();
+    keyblock.contents = reinterpret_cast<krb5_octet*>(const_cast<char*>(contents.data()));
+    return keyblock;
+}
+
+// EncryptionKey ::= SEQUENCE { keytype [0] Int32, keyvalue [1] OCTET STRING }
+bool der_key(DerNode* node, krb5_enctype* enctype, std::string* contents)
+{
+    std::int64_t keytype;
+    auto keyvalue = der_field(node, 1);
+    if (!der_integer(der_field(node, 0), &keytype) || !keyvalue)
+    {
+        return false;
+    }
+    *enctype = static_cast<krb5_enctype>(keytype);
+    *contents = keyvalue->content;
+    return true;
+}
+
+// EncryptedData ::= SEQUENCE { etype [0] Int32, kvno [1] UInt32 OPTIONAL, cipher [2] OCTET STRING }
+krb5_error_code decrypt_der(krb5_context ctx,
+                            const krb5_keyblock& key,
+                            krb5_keyusage usage,
+                            DerNode* encrypted,
+                            std::string* plain)
+{
+    auto cipher = der_field(encrypted, 2);
+    if (!cipher)
+    {
+        return ASN1_PARSE_ERROR;
+    }
+    krb5_enc_data input{};
+    input.magic = KV5M_ENC_DATA;
+    input.enctype = key.enctype;
+    input.ciphertext.magic = KV5M_DATA;
+    input.ciphertext.length = cipher->content.size();
+    input.ciphertext.data = &cipher->content[0];
+    plain->assign(cipher->content.size(), '\0');
+    krb5_data output{KV5M_DATA, static_cast<unsigned int>(plain->size()), &(*plain)[0]};
+    auto error = krb5_c_decrypt(ctx, &key, usage, nullptr, &input, &output);
+    plain->resize(error ? 0 : output.length);
+    return error;
+}
+
+krb5_error_code encrypt_der(krb5_context ctx,
+                            const krb5_keyblock& key,
+                            krb5_keyusage usage,
+                            const std::string& plain,
+                            DerNode* encrypted)
+{
+    auto cipher = der_field(encrypted, 2);
+    std::size_t length = 0;
+    if (!cipher)
+    {
+        return ASN1_PARSE_ERROR;
+    }
+    auto error = krb5_c_encrypt_length(ctx, key.enctype, plain.size(), &length);
+    if (error)
+    {
+        return error;
+    }
+    std::string ciphertext(length, '\0');
+    krb5_data input{KV5M_DATA, static_cast<unsigned int>(plain.size()), const_cast<char*>(plain.data())};
+    krb5_enc_data output{};
+    output.magic = KV5M_ENC_DATA;
+    output.ciphertext.magic = KV5M_DATA;
+    output.ciphertext.length = ciphertext.size();
+    output.ciphertext.data = &ciphertext[0];
+    error = krb5_c_encrypt(ctx, &key, usage, nullptr, &input, &output);
+    if (!error)
+    {
+        ciphertext.resize(output.ciphertext.length);
+        cipher->content = std::move(ciphertext);
+    }
+    return error;
+}
+
+// Checksum ::= SEQUENCE { cksumtype [0] Int32, checksum [1] OCTET STRING }, computed over the live request
+krb5_error_code replace_checksum(krb5_context ctx, const krb5_keyblock& key, std::string_view request, DerNode* node)
+{
+    DerNode checksum;
+    std::int64_t checksum_type;
+    if (!parse_der_message(node->content, &checksum) || !der_integer(der_field(&checksum, 0), &checksum_type)
+        || !der_field(&checksum, 1))
+    {
+        return ASN1_PARSE_ERROR;
+    }
+    krb5_data input{KV5M_DATA, static_cast<unsigned int>(request.size()), const_cast<char*>(request.data())};
+    krb5_checksum computed{};
+    auto error = krb5_c_make_checksum(
+        ctx, static_cast<krb5_cksumtype>(checksum_type), &key, KRB5_KEYUSAGE_AS_REQ, &input, &computed);
+    if (error)
+    {
+        return error;
+    }
+    der_field(&checksum, 1)->content.assign(reinterpret_cast<const char*>(computed.contents), computed.length);
+    krb5_free_checksum_contents(ctx, &computed);
+    node->content = der_encode(checksum);
+    return 0;
+}
+
+// KerberosTime is a fixed length GeneralizedTime, later times compare greater and the epoch stands for no limit
+void clamp_time(DerNode* reply_time, const DerNode* requested_time)
+{
+    if (reply_time && requested_time && reply_time->content.size() == requested_time->content.size()
+        && requested_time->content != "19700101000000Z" && reply_time->content > requested_time->content)
+    {
+        reply_time->content = requested_time->content;
+    }
+}
+
+void zeroize(std::string* value)
+{
+    static void* (*const volatile memset_function)(void*, int, std::size_t) = std::memset;
+    memset_function(&(*value)[0], 0, value->size());
+}
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+bool KRB5KerberosKdcRecorder::open(const std::string& path)
+{
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_)
+    {
+        return false;
+    }
+    std::string header;
+    KRB5KerberosByteWriter writer(&header);
+    writer.write_bytes(KDC_RECORDING_MAGIC, sizeof(KDC_RECORDING_MAGIC));
+    writer.write_u16(KDC_RECORDING_VERSION);
+    file_.write(header.data(), header.size());
+    start_ = std::chrono::steady_clock::now();
+    return file_.good();
+}
+
+void KRB5KerberosKdcRecorder::close()
+{
+    if (file_.is_open())
+    {
+        file_.close();
+    }
+}
+
+bool KRB5KerberosKdcRecorder::is_open() const
+{
+    return file_.is_open();
+}
+
+bool KRB5KerberosKdcRecorder::record(KRB5KerberosKdcFrame::Direction direction, const krb5_data& data)
+{
+    if (!file_.is_open())
+    {
+        return false;
+    }
+    std::string frame;
+    frame.reserve(data.length + 13);
+    KRB5KerberosByteWriter writer(&frame);
+    writer.write_u8(static_cast<std::uint8_t>(direction));
+    writer.write_u64(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+    writer.write_counted(data.data, data.length);
+    file_.write(frame.data(), frame.size());
+    // Flush every frame so a crashed process still leaves a usable recording
+    file_.flush();
+    return file_.good();
+}
+
+KRB5KerberosKdcReplayer::KRB5KerberosKdcReplayer(std::chrono::microseconds latency,
+                                                 encryption::SecureStringUniquePtr client_password)
+    : cursor_(0),
+      latency_(latency),
+      pending_match_(NO_PENDING_MATCH),
+      client_password_(std::move(client_password)),
+      ctx_(nullptr)
+{
+}
+
+KRB5KerberosKdcReplayer::~KRB5KerberosKdcReplayer()
+{
+    for (auto& keys : {&client_keys_, &session_keys_})
+    {
+        for (auto& entry : *keys)
+        {
+            zeroize(&entry.second.contents);
+        }
+    }
+    if (ctx_)
+    {
+        krb5_free_context(ctx_);
+    }
+}
+
+bool KRB5KerberosKdcReplayer::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    return parse(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+}
+
+bool KRB5KerberosKdcReplayer::parse(const std::string& recording)
+{
+    KRB5KerberosByteReader reader(recording);
+    std::string_view magic;
+    std::uint16_t version;
+    if (!reader.read_bytes(sizeof(KDC_RECORDING_MAGIC), &magic)
+        || magic != std::string_view(KDC_RECORDING_MAGIC, sizeof(KDC_RECORDING_MAGIC)) || !reader.read_u16(&version)
+        || version != KDC_RECORDING_VERSION)
+    {
+        return false;
+    }
+    frames_.clear();
+    identities_.clear();
+    rewind();
+    while (reader.remaining() > 0)
+    {
+        std::uint8_t direction;
+        std::uint64_t offset;
+        std::string_view payload;
+        if (!reader.read_u8(&direction) || !reader.read_u64(&offset) || !reader.read_counted(&payload)
+            || direction > static_cast<std::uint8_t>(KRB5KerberosKdcFrame::Direction::Response))
+        {
+            frames_.clear();
+            identities_.clear();
+            return false;
+        }
+        frames_.push_back(KRB5KerberosKdcFrame{static_cast<KRB5KerberosKdcFrame::Direction>(direction),
+                                               std::chrono::nanoseconds(offset),
+                                               std::string(payload)});
+        // Recorded requests that do not parse are never matched
+        KdcRequest request;
+        identities_.push_back(frames_.back().direction == KRB5KerberosKdcFrame::Direction::Request
+                                      && parse_kdc_request(payload, &request)
+                                  ? std::move(request.identity)
+                                  : std::string());
+    }
+    return true;
+}
+
+krb5_error_code KRB5KerberosKdcReplayer::replay_request(const krb5_data& data)
+{
+    KdcRequest request;
+    pending_match_ = NO_PENDING_MATCH;
+    if (!parse_kdc_request(std::string_view(data.data, data.length), &request))
+    {
+        return KRB5KRB_AP_ERR_MSG_TYPE;
+    }
+    for (auto pass = 0; pass < 2 && pending_match_ == NO_PENDING_MATCH; ++pass)
+    {
+        for (; cursor_ < frames_.size(); ++cursor_)
+        {
+            if (identities_[cursor_] == request.identity)
+            {
+                pending_match_ = cursor_++;
+                break;
+            }
+        }
+        if (pending_match_ == NO_PENDING_MATCH)
+        {
+            cursor_ = 0;
+        }
+    }
+    if (pending_match_ == NO_PENDING_MATCH)
+    {
+        return KRB5_PRINC_NOMATCH;
+    }
+    pending_request_.assign(data.data, data.length);
+    return 0;
+}
+
+krb5_error_code KRB5KerberosKdcReplayer::replay_response(krb5_data* data)
+{
+    std::memset(reinterpret_cast<void*>(data), 0, sizeof(krb5_data));
+    data->magic = KV5M_DATA;
+    const auto match = pending_match_;
+    pending_match_ = NO_PENDING_MATCH;
+    if (match == NO_PENDING_MATCH || match + 1 >= frames_.size()
+        || frames_[match + 1].direction != KRB5KerberosKdcFrame::Direction::Response)
+    {
+        return ECONNABORTED;
+    }
+    cursor_ = match + 2;
+    if (latency_.count() > 0)
+    {
+        std::this_thread::sleep_for(latency_);
+    }
+
+    auto payload = frames_[match + 1].payload;
+    if (client_password_)
+    {
+        auto error = rebind_response(frames_[match].payload, &payload);
+        if (error)
+        {
+            return error;
+        }
+    }
+    if (!payload.empty())
+    {
+        // Allocated with malloc, the caller releases it with krb5_free_data_contents
+        data->data = static_cast<char*>(malloc(payload.size()));
+        if (!data->data)
+        {
+            return ENOMEM;
+        }
+        std::memcpy(data->data, payload.data(), payload.size());
+    }
+    data->length = payload.size();
+    return 0;
+}
+
+krb5_error_code KRB5KerberosKdcReplayer::rebind_response(std::string_view recorded_request, std::string* response)
+{
+    DerNode reply;
+    if (!parse_der_message(*response, &reply))
+    {
+        return ASN1_PARSE_ERROR;
+    }
+    if (reply.tag == DER_KRB_ERROR)
+    {
+        // KRB-ERROR ::= SEQUENCE { ..., e-data [12] OCTET STRING OPTIONAL }, preauth hints carry the client salts
+        if (auto e_data = der_field(der_unwrap(&reply, DER_KRB_ERROR), 12))
+        {
+            learn_salts(e_data->content);
+        }
+        return 0;
+    }
+    if (reply.tag != DER_AS_REP && reply.tag != DER_TGS_REP)
+    {
+        return 0;
+    }
+    if (!ctx_)
+    {
+        auto error = krb5_init_context(&ctx_);
+        if (error)
+        {
+            ctx_ = nullptr;
+            return error;
+        }
+    }
+
+    KdcRequest live, recorded;
+    // KDC-REP ::= SEQUENCE { pvno [0], msg-type [1], padata [2] OPTIONAL, crealm [3], cname [4], ticket [5],
+    //                      enc-part [6] }
+    auto rep = der_unwrap(&reply, reply.tag);
+    auto ticket = der_field(rep, 5);
+    auto enc_part = der_field(rep, 6);
+    std::int64_t etype;
+    if (!parse_kdc_request(pending_request_, &live) || !parse_kdc_request(recorded_request, &recorded) || !ticket
+        || !der_integer(der_field(enc_part, 0), &etype))
+    {
+        return ASN1_PARSE_ERROR;
+    }
+
+    Key decrypt_key, encrypt_key, checksum_key;
+    krb5_keyusage decrypt_usage, encrypt_usage;
+    if (reply.tag == DER_AS_REP)
+    {
+        if (auto padata = der_field(rep, 2))
+        {
+            learn_salts(der_encode(*padata));
+        }
+        // Unless the kdc says otherwise the salt is the client realm followed by its name components
+        auto default_salt = der_field(live.body, 2)->content;
+        for (const auto& component : der_principal(der_field(live.body, 1)))
+        {
+            default_salt.append(component);
+        }
+        auto error = as_reply_key(default_salt, static_cast<krb5_enctype>(etype), &decrypt_key);
+        if (error)
+        {
+            return error;
+        }
+        encrypt_key = checksum_key = decrypt_key;
+        decrypt_usage = encrypt_usage = KRB5_KEYUSAGE_AS_REP_ENCPART;
+    }
+    else
+    {
+        // The tgt session key comes from the replayed reply that issued the tgt, replies to other tgts stay as recorded
+        const auto request_keys = [this](KdcRequest* request, Key* session_key, Key* subkey) -> krb5_error_code {
+            // AP-REQ ::= [APPLICATION 14] SEQUENCE { pvno [0], msg-type [1], ap-options [2], ticket [3],
+            //                                        authenticator [4] EncryptedData }
+            DerNode ap_request;
+            auto padata = find_padata(der_field(request->request, 3), PA_TGS_REQ);
+            auto ap = padata && parse_der_message(padata->content, &ap_request) ? der_unwrap(&ap_request, DER_AP_REQ)
+                                                                                 : nullptr;
+            auto tgt = der_field(ap, 3);
+            if (!tgt || !der_field(ap, 4))
+            {
+                return ASN1_PARSE_ERROR;
+            }
+            auto found = session_keys_.find(der_encode(*tgt));
+            if (found == session_keys_.end())
+            {
+                session_key->contents.clear();
+                return 0;
+            }
+            *session_key = found->second;
+
+            // Authenticator ::= [APPLICATION 2] SEQUENCE { ..., subkey [6] EncryptionKey OPTIONAL, ... }
+            std::string plain;
+            DerNode authenticator;
+            auto error = decrypt_der(ctx_,
+                                     keyblock_of(session_key->contents, session_key->enctype),
+                                     KRB5_KEYUSAGE_TGS_REQ_AUTH,
+                                     der_field(ap, 4),
+                                     &plain);
+            if (error)
+            {
+                return error;
+            }
+            auto fields = parse_der_message(plain, &authenticator) ? der_unwrap(&authenticator, DER_AUTHENTICATOR)
+                                                                   : nullptr;
+            auto key = der_field(fields, 6);
+            if (!fields || (key && !der_key(key, &subkey->enctype, &subkey->contents)))
+            {
+                return ASN1_PARSE_ERROR;
+            }
+            return 0;
+        };
+        Key recorded_session_key, live_session_key, recorded_subkey, live_subkey;
+        auto error = request_keys(&recorded, &recorded_session_key, &recorded_subkey);
+        if (!error)
+        {
+            error = request_keys(&live, &live_session_key, &live_subkey);
+        }
+        if (error || recorded_session_key.contents.empty() || live_session_key.contents.empty())
+        {
+            return error;
+        }
+        checksum_key = live_session_key;
+        decrypt_key = recorded_subkey.contents.empty() ? recorded_session_key : recorded_subkey;
+        encrypt_key = live_subkey.contents.empty() ? live_session_key : live_subkey;
+        decrypt_usage = recorded_subkey.contents.empty() ? KRB5_KEYUSAGE_TGS_REP_ENCPART_SESSKEY
+                                                         : KRB5_KEYUSAGE_TGS_REP_ENCPART_SUBKEY;
+        encrypt_usage = live_subkey.contents.empty() ? KRB5_KEYUSAGE_TGS_REP_ENCPART_SESSKEY
+                                                     : KRB5_KEYUSAGE_TGS_REP_ENCPART_SUBKEY;
+    }
+
+    std::string plain;
+    DerNode part;
+    auto error = decrypt_der(
+        ctx_, keyblock_of(decrypt_key.contents, decrypt_key.enctype), decrypt_usage, enc_part, &plain);
+    if (error)
+    {
+        return error;
+    }
+    if (!parse_der_message(plain, &part) || (part.tag != DER_ENC_AS_REP_PART && part.tag != DER_ENC_TGS_REP_PART))
+    {
+        return ASN1_PARSE_ERROR;
+    }
+    // EncKDCRepPart ::= SEQUENCE { key [0], last-req [1], nonce [2], key-expiration [3] OPTIONAL, flags [4],
+    //                              authtime [5], starttime [6] OPTIONAL, endtime [7], renew-till [8] OPTIONAL,
+    //                              srealm [9], sname [10], caddr [11] OPTIONAL, encrypted-pa-data [12] OPTIONAL }
+    auto enc_rep = der_unwrap(&part, part.tag);
+    auto nonce = der_field(enc_rep, 2);
+    Key session_key;
+    if (!nonce || !der_key(der_field(enc_rep, 0), &session_key.enctype, &session_key.contents))
+    {
+        return ASN1_PARSE_ERROR;
+    }
+    nonce->content = der_field(live.body, 7)->content;
+    clamp_time(der_field(enc_rep, 7), der_field(live.body, 5));
+    clamp_time(der_field(enc_rep, 8), der_field(live.body, 6));
+    if (auto checksum = find_padata(der_field(enc_rep, 12), PA_REQ_ENC_PA_REP))
+    {
+        error = replace_checksum(
+            ctx_, keyblock_of(checksum_key.contents, checksum_key.enctype), pending_request_, checksum);
+        if (error)
+        {
+            return error;
+        }
+    }
+    error = encrypt_der(
+        ctx_, keyblock_of(encrypt_key.contents, encrypt_key.enctype), encrypt_usage, der_encode(part), enc_part);
+    if (error)
+    {
+        return error;
+    }
+    session_keys_[der_encode(*ticket)] = std::move(session_key);
+    *response = der_encode(reply);
+    return 0;
+}
+
+krb5_error_code KRB5KerberosKdcReplayer::as_reply_key(std::string_view default_salt, krb5_enctype enctype, Key* key)
+{
+    const auto found = salts_.find(enctype);
+    const std::string_view salt =
+        found != salts_.end() && found->second.has_salt ? std::string_view(found->second.salt) : default_salt;
+    const std::string_view params = found != salts_.end() ? std::string_view(found->second.params) : "";
+
+    // String to key is deliberately slow, every enctype, salt and params is derived once
+    auto cache_key = std::to_string(enctype);
+    cache_key.append(1, '\0').append(salt).append(1, '\0').append(params);
+    auto cached = client_keys_.find(cache_key);
+    if (cached != client_keys_.end())
+    {
+        *key = cached->second;
+        return 0;
+    }
+
+    const auto& password = client_password_->get();
+    krb5_data password_data{KV5M_DATA, static_cast<unsigned int>(password.size()), const_cast<char*>(password.data())};
+    krb5_data salt_data{KV5M_DATA, static_cast<unsigned int>(salt.size()), const_cast<char*>(salt.data())};
+    krb5_data params_data{KV5M_DATA, static_cast<unsigned int>(params.size()), const_cast<char*>(params.data())};
+    krb5_keyblock keyblock{};
+    auto error = krb5_c_string_to_key_with_params(
+        ctx_, enctype, &password_data, &salt_data, params.empty() ? nullptr : &params_data, &keyblock);
+    if (error)
+    {
+        return error;
+    }
+    key->enctype = keyblock.enctype;
+    key->contents.assign(reinterpret_cast<const char*>(keyblock.contents), keyblock.length);
+    krb5_free_keyblock_contents(ctx_, &keyblock);
+    client_keys_[cache_key] = *key;
+    return 0;
+}
+
+void KRB5KerberosKdcReplayer::learn_salts(std::string_view method_data)
+{
+    DerNode padata_sequence, etype_info;
+    auto value = parse_der_message(method_data, &padata_sequence) ? find_padata(&padata_sequence, PA_ETYPE_INFO2)
+                                                                  : nullptr;
+    if (!value || !parse_der_message(value->content, &etype_info) || etype_info.tag != DER_SEQUENCE)
+    {
+        return;
+    }
+    // ETYPE-INFO2-ENTRY ::= SEQUENCE { etype [0] Int32, salt [1] KerberosString OPTIONAL, s2kparams [2] OCTET STRING
+    //                                  OPTIONAL }
+    for (auto& entry : etype_info.children)
+    {
+        std::int64_t etype;
+        if (!der_integer(der_field(&entry, 0), &etype))
+        {
+            continue;
+        }
+        auto salt_node = der_field(&entry, 1);
+        auto params_node = der_field(&entry, 2);
+        auto& salt = salts_[static_cast<krb5_enctype>(etype)];
+        salt.has_salt = salt_node != nullptr;
+        salt.salt = salt_node ? salt_node->content : "";
+        salt.params = params_node ? params_node->content : "";
+    }
+}
+
+const std::vector<KRB5KerberosKdcFrame>& KRB5KerberosKdcReplayer::frames() const
+{
+    return frames_;
+}
+
+void KRB5KerberosKdcReplayer::rewind()
+{
+    cursor_ = 0;
+    pending_match_ = NO_PENDING_MATCH;
+}
+} // namespace octo::kerberos::krb5
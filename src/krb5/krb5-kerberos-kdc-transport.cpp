@@ -0,0 +1,424 @@
+/**
+ * @file krb5-kerberos-kdc-transport.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-kdc-transport.hpp"
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+krb5_error_code copy_to_krb5_data(std::string_view payload, krb5_data* data)
+{
+    std::memset(reinterpret_cast<void*>(data), 0, sizeof(krb5_data));
+    data->magic = KV5M_DATA;
+    if (!payload.empty())
+    {
+        data->data = static_cast<char*>(malloc(payload.size()));
+        if (!data->data)
+        {
+            return ENOMEM;
+        }
+        std::memcpy(data->data, payload.data(), payload.size());
+    }
+    data->length = payload.size();
+    return 0;
+}
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+KRB5KerberosTcpKdcTransport::KRB5KerberosTcpKdcTransport(std::string host, std::uint32_t port, std::string session_id)
+    : host_(std::move(host)),
+      port_(port),
+      session_id_(std::move(session_id)),
+      fd_(-1),
+      logger_("KRB5KerberosTcpKdcTransport")
+{
+}
+
+KRB5KerberosTcpKdcTransport::~KRB5KerberosTcpKdcTransport()
+{
+    disconnect();
+}
+
+bool KRB5KerberosTcpKdcTransport::connect()
+{
+    logger_.info(session_id_).formatted("Creating streamlined kdc connection");
+    auto const port_str(std::to_string(port_));
+    struct addrinfo *ap, aihints{}, *apstart;
+    int aierr;
+    std::memset(&aihints, 0, sizeof(aihints));
+    aihints.ai_socktype = SOCK_STREAM;
+    aihints.ai_flags = AI_ADDRCONFIG;
+    aierr = getaddrinfo(host_.c_str(), port_str.c_str(), &aihints, &ap);
+    if (aierr)
+    {
+        logger_.warning(session_id_)
+            .formatted("Failed running getaddrinfo to resolve ip / port [{}] [{}]", aierr, gai_strerror(aierr));
+        return false;
+    }
+    if (!ap)
+    {
+        logger_.warning(session_id_).formatted("Failed resolving ip / port using getaddrinfo");
+        return false;
+    }
+    apstart = ap;
+    for (fd_ = -1; ap && fd_ == -1; ap = ap->ai_next)
+    {
+        fd_ = socket(ap->ai_family, SOCK_STREAM, 0);
+        if (fd_ < 0)
+        {
+            continue;
+        }
+        if (::connect(fd_, ap->ai_addr, ap->ai_addrlen) < 0)
+        {
+            close(fd_);
+            fd_ = -1;
+            continue;
+        }
+    }
+    if (fd_ == -1)
+    {
+        logger_.warning(session_id_).formatted("Failed to connect to host [{}] on port [{}]", host_, port_);
+        freeaddrinfo(apstart);
+        return false;
+    }
+    freeaddrinfo(apstart);
+    logger_.info(session_id_).formatted("Streamlined connected successfully to host [{}] on port [{}]", host_, port_);
+    return true;
+}
+
+void KRB5KerberosTcpKdcTransport::disconnect()
+{
+    if (fd_ != -1)
+    {
+        close(fd_);
+        fd_ = -1;
+        logger_.info(session_id_).formatted("Streamlined disconnected successfully");
+    }
+}
+
+bool KRB5KerberosTcpKdcTransport::is_connected() const
+{
+    return fd_ != -1;
+}
+
+int KRB5KerberosTcpKdcTransport::net_read(char* buf, int len)
+{
+    int ret, bytes_read = 0;
+    do
+    {
+        ret = ::read(fd_, buf, len);
+        if (ret == 0)
+        {
+            return bytes_read;
+        }
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return ret;
+        }
+        buf += ret;
+        bytes_read += ret;
+        len -= ret;
+    } while (len > 0);
+    return bytes_read;
+}
+
+int KRB5KerberosTcpKdcTransport::net_write(const char* buf, int len)
+{
+    size_t bytes_written = 0;
+    while (bytes_written < len)
+    {
+        ssize_t nbytes = ::write(fd_, buf, len - bytes_written);
+        if (nbytes == 0)
+        {
+            return -1;
+        }
+        if (nbytes == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        bytes_written += static_cast<size_t>(nbytes);
+        buf += nbytes;
+    }
+    return len;
+}
+
+krb5_error_code KRB5KerberosTcpKdcTransport::send(const krb5_data& request)
+{
+    auto len = htonl(request.length);
+    auto bytes_written = net_write(reinterpret_cast<const char*>(&len), sizeof(unsigned int));
+    if (bytes_written != sizeof(unsigned int))
+    {
+        return bytes_written < 0 ? errno : ECONNABORTED;
+    }
+    bytes_written = net_write(request.data, request.length);
+    if (bytes_written != request.length)
+    {
+        return bytes_written < 0 ? errno : ECONNABORTED;
+    }
+    return 0;
+}
+
+krb5_error_code KRB5KerberosTcpKdcTransport::receive(krb5_data* response)
+{
+    krb5_int32 len;
+    int len2, ilen;
+    char* buf = nullptr;
+
+    std::memset(reinterpret_cast<void*>(response), 0, sizeof(krb5_data));
+    response->magic = KV5M_DATA;
+    if ((len2 = net_read(reinterpret_cast<char*>(&len), sizeof(krb5_int32))) != sizeof(krb5_int32))
+    {
+        return (len2 < 0) ? errno : ECONNABORTED;
+    }
+    len = ntohl(len);
+
+    if ((len & VALID_UINT_BITS) != (krb5_ui_4)len)
+    {
+        return ENOMEM;
+    }
+
+    ilen = (int)len;
+    if (ilen)
+    {
+        if (!(buf = static_cast<char*>(malloc(ilen))))
+        {
+            return (ENOMEM);
+        }
+        if ((len2 = net_read(buf, ilen)) != ilen)
+        {
+            free(buf);
+            return len2 < 0 ? errno : ECONNABORTED;
+        }
+    }
+    response->data = buf;
+    response->length = ilen;
+    return 0;
+}
+
+KRB5KerberosLoopbackKdcTransport::KRB5KerberosLoopbackKdcTransport(KRB5KerberosLoopbackKdcTransport::Handler handler)
+    : handler_(std::move(handler)), is_connected_(false)
+{
+}
+
+bool KRB5KerberosLoopbackKdcTransport::connect()
+{
+    is_connected_ = static_cast<bool>(handler_);
+    return is_connected_;
+}
+
+void KRB5KerberosLoopbackKdcTransport::disconnect()
+{
+    responses_.clear();
+    is_connected_ = false;
+}
+
+bool KRB5KerberosLoopbackKdcTransport::is_connected() const
+{
+    return is_connected_;
+}
+
+krb5_error_code KRB5KerberosLoopbackKdcTransport::send(const krb5_data& request)
+{
+    if (!is_connected_)
+    {
+        return ENOTCONN;
+    }
+    std::string response;
+    auto ret = handler_(std::string_view(request.data, request.length), &response);
+    if (ret)
+    {
+        return ret;
+    }
+    responses_.push_back(std::move(response));
+    return 0;
+}
+
+krb5_error_code KRB5KerberosLoopbackKdcTransport::receive(krb5_data* response)
+{
+    if (responses_.empty())
+    {
+        std::memset(reinterpret_cast<void*>(response), 0, sizeof(krb5_data));
+        response->magic = KV5M_DATA;
+        return ECONNABORTED;
+    }
+    auto ret = copy_to_krb5_data(responses_.front(), response);
+    responses_.pop_front();
+    return ret;
+}
+
+KRB5KerberosFaultInjectingKdcTransport::KRB5KerberosFaultInjectingKdcTransport(
+    KRB5KerberosKdcTransportPtr inner, KRB5KerberosFaultInjectingKdcTransport::Faults faults)
+    : inner_(std::move(inner)), faults_(faults), generator_(faults.seed)
+{
+}
+
+bool KRB5KerberosFaultInjectingKdcTransport::roll(double probability)
+{
+    return probability > 0 && std::uniform_real_distribution<double>(0, 1)(generator_) < probability;
+}
+
+bool KRB5KerberosFaultInjectingKdcTransport::connect()
+{
+    return inner_ && inner_->connect();
+}
+
+void KRB5KerberosFaultInjectingKdcTransport::disconnect()
+{
+    if (inner_)
+    {
+        inner_->disconnect();
+    }
+}
+
+bool KRB5KerberosFaultInjectingKdcTransport::is_connected() const
+{
+    return inner_ && inner_->is_connected();
+}
+
+krb5_error_code KRB5KerberosFaultInjectingKdcTransport::send(const krb5_data& request)
+{
+    if (roll(faults_.send_failure_probability))
+    {
+        return ECONNABORTED;
+    }
+    return inner_->send(request);
+}
+
+krb5_error_code KRB5KerberosFaultInjectingKdcTransport::receive(krb5_data* response)
+{
+    auto delay = faults_.latency;
+    if (faults_.jitter.count() > 0)
+    {
+        delay += std::chrono::microseconds(
+            std::uniform_int_distribution<std::int64_t>(0, faults_.jitter.count())(generator_));
+    }
+    if (delay.count() > 0)
+    {
+        std::this_thread::sleep_for(delay);
+    }
+    auto ret = inner_->receive(response);
+    if (ret)
+    {
+        return ret;
+    }
+    if (roll(faults_.receive_failure_probability))
+    {
+        krb5_free_data_contents(nullptr, response);
+        return ETIMEDOUT;
+    }
+    if (response->length > 0 && roll(faults_.corruption_probability))
+    {
+        const auto index = std::uniform_int_distribution<std::size_t>(0, response->length - 1)(generator_);
+        response->data[index] ^= static_cast<char>(1 + generator_() % 255);
+    }
+    return 0;
+}
+
+KRB5KerberosRecordingKdcTransport::KRB5KerberosRecordingKdcTransport(KRB5KerberosKdcTransportPtr inner,
+                                                                     std::string path)
+    : inner_(std::move(inner)), path_(std::move(path))
+{
+}
+
+bool KRB5KerberosRecordingKdcTransport::connect()
+{
+    if (!inner_ || !recorder_.open(path_))
+    {
+        return false;
+    }
+    return inner_->connect();
+}
+
+void KRB5KerberosRecordingKdcTransport::disconnect()
+{
+    if (inner_)
+    {
+        inner_->disconnect();
+    }
+    recorder_.close();
+}
+
+bool KRB5KerberosRecordingKdcTransport::is_connected() const
+{
+    return inner_ && inner_->is_connected();
+}
+
+krb5_error_code KRB5KerberosRecordingKdcTransport::send(const krb5_data& request)
+{
+    auto ret = inner_->send(request);
+    if (!ret && !recorder_.record(KRB5KerberosKdcFrame::Direction::Request, request))
+    {
+        return EIO;
+    }
+    return ret;
+}
+
+krb5_error_code KRB5KerberosRecordingKdcTransport::receive(krb5_data* response)
+{
+    auto ret = inner_->receive(response);
+    if (!ret && !recorder_.record(KRB5KerberosKdcFrame::Direction::Response, *response))
+    {
+        krb5_free_data_contents(nullptr, response);
+        return EIO;
+    }
+    return ret;
+}
+
+KRB5KerberosReplayKdcTransport::KRB5KerberosReplayKdcTransport(std::string path,
+                                                               std::chrono::microseconds latency,
+                                                               encryption::SecureStringUniquePtr client_password)
+    : path_(std::move(path)), replayer_(latency, std::move(client_password)), is_connected_(false)
+{
+}
+
+bool KRB5KerberosReplayKdcTransport::connect()
+{
+    is_connected_ = replayer_.load(path_);
+    return is_connected_;
+}
+
+void KRB5KerberosReplayKdcTransport::disconnect()
+{
+    replayer_.rewind();
+    is_connected_ = false;
+}
+
+bool KRB5KerberosReplayKdcTransport::is_connected() const
+{
+    return is_connected_;
+}
+
+krb5_error_code KRB5KerberosReplayKdcTransport::send(const krb5_data& request)
+{
+    return replayer_.replay_request(request);
+}
+
+krb5_error_code KRB5KerberosReplayKdcTransport::receive(krb5_data* response)
+{
+    return replayer_.replay_response(response);
+}
+} // namespace octo::kerberos::krb5
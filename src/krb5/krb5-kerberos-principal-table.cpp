@@ -0,0 +1,126 @@
+/**
+ * @file krb5-kerberos-principal-table.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-principal-table.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace
+{
+using octo::kerberos::krb5::KRB5KerberosPrincipalTable;
+
+// libkrb5 does not use the context to free a principal, so entries do not keep the one they were parsed with, which
+// may be gone before they are
+void release_entry(const KRB5KerberosPrincipalTable::Entry* entry)
+{
+    krb5_free_principal(nullptr, entry->principal);
+    delete entry;
+}
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+KRB5KerberosPrincipalTable::KRB5KerberosPrincipalTable(std::size_t capacity)
+    : capacity_(std::max<std::size_t>(capacity, 1))
+{
+}
+
+void KRB5KerberosPrincipalTable::evict()
+{
+    // Every entry is spared at most once, so this ends within two passes
+    while (!order_.empty())
+    {
+        const auto name = order_.front();
+        order_.pop_front();
+        const auto it = index_.find(name);
+        if (it->second.is_referenced.exchange(false, std::memory_order_relaxed))
+        {
+            order_.push_back(name);
+            continue;
+        }
+        ids_.erase(it->second.entry->id);
+        index_.erase(it);
+        return;
+    }
+}
+
+krb5_error_code KRB5KerberosPrincipalTable::intern(std::string_view name, krb5_context ctx, EntryPtr* entry)
+{
+    *entry = find(name);
+    if (*entry)
+    {
+        return 0;
+    }
+
+    // Parsed outside the lock, a racing intern of the same name keeps the first one
+    krb5_principal principal = nullptr;
+    const auto ret = krb5_parse_name(ctx, std::string(name).c_str(), &principal);
+    if (ret)
+    {
+        return ret;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const auto it = index_.find(name);
+    if (it != index_.end())
+    {
+        krb5_free_principal(ctx, principal);
+        it->second.is_referenced.store(true, std::memory_order_relaxed);
+        *entry = it->second.entry;
+        return 0;
+    }
+    if (index_.size() >= capacity_)
+    {
+        evict();
+    }
+    EntryPtr added(new Entry{next_id_++, std::string(name), principal}, release_entry);
+    index_.try_emplace(added->name).first->second.entry = added;
+    ids_.emplace(added->id, added->name);
+    order_.push_back(added->name);
+    *entry = std::move(added);
+    return 0;
+}
+
+KRB5KerberosPrincipalTable::EntryPtr KRB5KerberosPrincipalTable::find(std::string_view name) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const auto it = index_.find(name);
+    if (it == index_.end())
+    {
+        return nullptr;
+    }
+    it->second.is_referenced.store(true, std::memory_order_relaxed);
+    return it->second.entry;
+}
+
+KRB5KerberosPrincipalTable::EntryPtr KRB5KerberosPrincipalTable::find(Id id) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const auto it = ids_.find(id);
+    if (it == ids_.end())
+    {
+        return nullptr;
+    }
+    const auto& slot = index_.find(it->second)->second;
+    slot.is_referenced.store(true, std::memory_order_relaxed);
+    return slot.entry;
+}
+
+std::size_t KRB5KerberosPrincipalTable::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return index_.size();
+}
+
+std::size_t KRB5KerberosPrincipalTable::capacity() const
+{
+    return capacity_;
+}
+} // namespace octo::kerberos::krb5
@@ -0,0 +1,202 @@
+/**
+ * @file krb5-kerberos-request-coalescer.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-request-coalescer.hpp"
+#include <iterator>
+
+namespace
+{
+// Expired failures are swept once this many are remembered
+constexpr const std::size_t KERBEROS_COALESCER_FAILURES_SWEEP_SIZE = 1024;
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+KRB5KerberosRequestCoalescer::KRB5KerberosRequestCoalescer(std::chrono::milliseconds negative_ttl,
+                                                           std::chrono::milliseconds wait_timeout)
+    : negative_ttl_(negative_ttl),
+      wait_timeout_(wait_timeout),
+      leaders_(0),
+      coalesced_(0),
+      negative_hits_(0),
+      wait_timeouts_(0)
+{
+}
+
+std::string KRB5KerberosRequestCoalescer::make_key(char kind, std::initializer_list<std::string_view> fields)
+{
+    std::string key(1, kind);
+    for (const auto field : fields)
+    {
+        key.append(std::to_string(field.size())).append(1, ':').append(field);
+    }
+    return key;
+}
+
+bool KRB5KerberosRequestCoalescer::is_definitive(krb5_error_code error)
+{
+    // Password failures, lockouts and transport errors are left out, they may not hold for the next attempt
+    switch (error)
+    {
+        case KRB5KDC_ERR_C_PRINCIPAL_UNKNOWN:
+        case KRB5KDC_ERR_S_PRINCIPAL_UNKNOWN:
+        case KRB5KDC_ERR_NAME_EXP:
+        case KRB5KDC_ERR_SERVICE_EXP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool KRB5KerberosRequestCoalescer::is_negative(const std::string& key)
+{
+    const auto it = failures_.find(key);
+    if (it == failures_.end())
+    {
+        return false;
+    }
+    if (it->second <= std::chrono::steady_clock::now())
+    {
+        failures_.erase(it);
+        return false;
+    }
+    return true;
+}
+
+void KRB5KerberosRequestCoalescer::record_failure(const std::string& key)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (failures_.size() >= KERBEROS_COALESCER_FAILURES_SWEEP_SIZE)
+    {
+        for (auto it = failures_.begin(); it != failures_.end();)
+        {
+            it = it->second <= now ? failures_.erase(it) : std::next(it);
+        }
+    }
+    failures_[key] = now + negative_ttl_;
+}
+
+KerberosTicketUniquePtr KRB5KerberosRequestCoalescer::run(const std::string& key,
+                                                          const encryption::SecureString* password,
+                                                          const Request& request)
+{
+    std::shared_ptr<Flight> flight;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (negative_ttl_.count() > 0 && is_negative(key))
+        {
+            negative_hits_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        const auto it = flights_.find(key);
+        if (it != flights_.end())
+        {
+            flight = it->second;
+            // Another password may well succeed where the leader fails, it gets an exchange of its own
+            if (!password || password->get() == flight->password->get())
+            {
+                if (flight->done_cv.wait_for(lock, wait_timeout_, [&flight]() { return flight->is_done; }))
+                {
+                    coalesced_.fetch_add(1, std::memory_order_relaxed);
+                    return flight->ticket ? flight->ticket->clone() : nullptr;
+                }
+                // The leader is stuck on the kdc, this caller tries on its own rather than waiting for it any longer
+                wait_timeouts_.fetch_add(1, std::memory_order_relaxed);
+            }
+            flight.reset();
+        }
+        else
+        {
+            flight = std::make_shared<Flight>();
+            flight->password = password;
+            flights_.emplace(key, flight);
+        }
+    }
+
+    leaders_.fetch_add(1, std::memory_order_relaxed);
+    krb5_error_code error = 0;
+    if (!flight)
+    {
+        return request(&error);
+    }
+
+    KerberosTicketUniquePtr ticket;
+    try
+    {
+        ticket = request(&error);
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            flights_.erase(key);
+            flight->is_done = true;
+        }
+        flight->done_cv.notify_all();
+        throw;
+    }
+
+    auto copy = ticket ? ticket->clone() : nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flights_.erase(key);
+        if (!ticket && negative_ttl_.count() > 0 && is_definitive(error))
+        {
+            record_failure(key);
+        }
+        // The password belongs to the leader, which returns right after
+        flight->password = nullptr;
+        flight->ticket = std::move(ticket);
+        flight->is_done = true;
+    }
+    flight->done_cv.notify_all();
+    return copy;
+}
+
+KRB5KerberosTGTTicketUniquePtr KRB5KerberosRequestCoalescer::generate_tgt(
+    const KerberosUserCredentials& creds,
+    std::chrono::seconds lifetime,
+    const KRB5KerberosRequestCoalescer::TGTRequest& request)
+{
+    const auto key = make_key('a', {creds.username(), std::to_string(lifetime.count())});
+    auto ticket = run(key, &creds.password(), [&request](krb5_error_code* error) -> KerberosTicketUniquePtr {
+        return request(error);
+    });
+    return KRB5KerberosTGTTicketUniquePtr(static_cast<KRB5KerberosTGTTicket*>(ticket.release()));
+}
+
+KRB5KerberosServiceTicketUniquePtr KRB5KerberosRequestCoalescer::generate_service_ticket(
+    const KRB5KerberosTGTTicket& tgt,
+    const std::string& service,
+    std::chrono::seconds lifetime,
+    const KRB5KerberosRequestCoalescer::ServiceTicketRequest& request)
+{
+    const auto key = make_key('t', {tgt.tgt_user(), service, std::to_string(lifetime.count())});
+    auto ticket = run(key, nullptr, [&request](krb5_error_code* error) -> KerberosTicketUniquePtr {
+        return request(error);
+    });
+    return KRB5KerberosServiceTicketUniquePtr(static_cast<KRB5KerberosServiceTicket*>(ticket.release()));
+}
+
+std::size_t KRB5KerberosRequestCoalescer::in_flight()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return flights_.size();
+}
+
+KRB5KerberosRequestCoalescer::Statistics KRB5KerberosRequestCoalescer::statistics() const
+{
+    return Statistics{leaders_.load(std::memory_order_relaxed),
+                      coalesced_.load(std::memory_order_relaxed),
+                      negative_hits_.load(std::memory_order_relaxed),
+                      wait_timeouts_.load(std::memory_order_relaxed)};
+}
+} // namespace octo::kerberos::krb5
@@ -10,402 +10,2087 @@
  */
 
 #include "octo-kerberos-cpp/krb5/krb5-kerberos-serializer.hpp"
-#include <octo-encryption-cpp/base64.hpp>
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-base64.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-byte-buffer.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-reflection.hpp"
+#include <simdjson.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
 #define SAFE_FREE(X)                                                                                                   \
     free(X);                                                                                                           \
     (X) = nullptr
 
-namespace octo::kerberos::krb5
+namespace
+{
+/**
+ * Binary creds layout (big endian), version 1:
+ *   u8 version, u32 magic, u8 present fields (client, server, addresses, authdata)
+ *   [principal client] [principal server]
+ *   keyblock: u32 magic, u32 enctype, counted contents
+ *   times: u32 authtime, u32 starttime, u32 endtime, u32 renew_till
+ *   u8 is_skey, u32 ticket_flags
+ *   [u32 count, address: u32 magic, u32 addrtype, counted contents]
+ *   data ticket, data second_ticket
+ *   [u32 count, authdata: u32 magic, u32 ad_type, counted contents]
+ * principal: u32 magic, data realm, u32 count, data components, u32 type
+ * data: u32 magic, counted data
+ * Generated from the field order of krb5-kerberos-reflection.hpp, only the peek helpers read it by hand.
+ *
+ * Binary ticket envelope, version 1:
+ *   "OKKT", u8 version, u8 ticket type, counted name, u64 expiration seconds, counted creds
+ */
+constexpr const std::uint8_t CREDS_BINARY_VERSION = 1;
+constexpr const std::uint8_t CREDS_HAS_CLIENT = 1 << 0;
+constexpr const std::uint8_t CREDS_HAS_SERVER = 1 << 1;
+constexpr const std::uint8_t CREDS_HAS_ADDRESSES = 1 << 2;
+constexpr const std::uint8_t CREDS_HAS_AUTHDATA = 1 << 3;
+constexpr const char TICKET_BINARY_MAGIC[] = {'O', 'K', 'K', 'T'};
+constexpr const std::uint8_t TICKET_BINARY_VERSION = 1;
+
+/**
+ * MIT ccache, see doc/formats/ccache_file_format.rst in the krb5 sources. Versions 3 and 4 are big endian and only
+ * differ by the v4 header (tagged fields such as the kdc time offset, skipped on read and left empty on write) and by
+ * v3 writing the keyblock enctype twice. Only v4 is written.
+ * Magics are not stored, they are restored to their KV5M values on read.
+ */
+constexpr const std::uint16_t CCACHE_VERSION_3 = 0x0503;
+constexpr const std::uint16_t CCACHE_VERSION_4 = 0x0504;
+constexpr const char CCACHE_CONFIG_REALM[] = "X-CACHECONF:";
+
+using octo::kerberos::krb5::KRB5KerberosBase64;
+using octo::kerberos::krb5::KRB5KerberosByteReader;
+using octo::kerberos::krb5::KRB5KerberosByteWriter;
+using octo::kerberos::krb5::KRB5KerberosFieldKind;
+using octo::kerberos::krb5::KRB5KerberosFieldTable;
+using octo::kerberos::krb5::KRB5KerberosJsonWriter;
+
+static_assert(CREDS_HAS_CLIENT == KRB5KerberosFieldTable<krb5_creds>::presence_bit<2>()
+                  && CREDS_HAS_SERVER == KRB5KerberosFieldTable<krb5_creds>::presence_bit<3>()
+                  && CREDS_HAS_ADDRESSES == KRB5KerberosFieldTable<krb5_creds>::presence_bit<8>()
+                  && CREDS_HAS_AUTHDATA == KRB5KerberosFieldTable<krb5_creds>::presence_bit<11>(),
+              "the peek helpers read the presence bits of the creds description");
+
+// Allocates with calloc so the result can be released by the krb5_free_* family
+template <typename T>
+[[nodiscard]] bool read_blob(KRB5KerberosByteReader& reader, T** contents, unsigned int* length)
+{
+    std::string_view bytes;
+    if (!reader.read_counted(&bytes))
+    {
+        return false;
+    }
+    *contents = nullptr;
+    *length = bytes.size();
+    if (!bytes.empty())
+    {
+        *contents = static_cast<T*>(calloc(bytes.size(), sizeof(char)));
+        if (!*contents)
+        {
+            return false;
+        }
+        std::memcpy(*contents, bytes.data(), bytes.size());
+    }
+    return true;
+}
+
+template <typename T>
+[[nodiscard]] bool read_i32(KRB5KerberosByteReader& reader, T* value)
+{
+    std::uint32_t raw;
+    if (!reader.read_u32(&raw))
+    {
+        return false;
+    }
+    *value = static_cast<T>(raw);
+    return true;
+}
+
+void release_blob(void* contents, std::size_t length)
+{
+    if (contents)
+    {
+        std::memset(contents, 0, length);
+        free(contents);
+    }
+}
+
+/**
+ * Codecs over the field descriptions of krb5-kerberos-reflection.hpp, each one handles every described struct.
+ * Field is the descriptor type, its kind picks the branch at compile time.
+ */
+template <typename Field>
+constexpr bool is_kind(KRB5KerberosFieldKind kind)
+{
+    return Field::kind == kind;
+}
+
+template <typename T>
+void release_contents(T* value);
+
+// Zeroizes and releases what the given field of the struct points to, and empties it
+template <typename T, typename Field>
+void release_field(T* value, const Field& field)
+{
+    if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Blob))
+    {
+        release_blob(value->*field.contents, value->*field.length);
+        value->*field.contents = nullptr;
+        value->*field.length = 0;
+    }
+    else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Struct))
+    {
+        release_contents(&(value->*field.member));
+    }
+    else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Pointer))
+    {
+        if (value->*field.member)
+        {
+            release_contents(value->*field.member);
+            SAFE_FREE(value->*field.member);
+        }
+    }
+    else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::List))
+    {
+        if (value->*field.member)
+        {
+            for (auto entry = value->*field.member; *entry; ++entry)
+            {
+                release_contents(*entry);
+                free(*entry);
+            }
+            SAFE_FREE(value->*field.member);
+        }
+    }
+    else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Components))
+    {
+        if (value->*field.entries)
+        {
+            for (std::int64_t i = 0; i < value->*field.length; ++i)
+            {
+                release_contents(&(value->*field.entries)[i]);
+            }
+            SAFE_FREE(value->*field.entries);
+        }
+        value->*field.length = 0;
+    }
+}
+
+// Zeroizes and releases everything the struct points to, the struct itself is left to the caller
+template <typename T>
+void release_contents(T* value)
+{
+    KRB5KerberosFieldTable<T>::for_each_field([value](const auto& field, auto) { release_field(value, field); });
+}
+
+template <typename T>
+[[nodiscard]] std::uint8_t presence_bits(const T& value)
+{
+    std::uint8_t present = 0;
+    KRB5KerberosFieldTable<T>::for_each_field([&value, &present](const auto& field, auto index) {
+        typedef std::decay_t<decltype(field)> Field;
+        if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Pointer) || is_kind<Field>(KRB5KerberosFieldKind::List))
+        {
+            if (value.*field.member)
+            {
+                present |= KRB5KerberosFieldTable<T>::template presence_bit<decltype(index)::value>();
+            }
+        }
+    });
+    return present;
+}
+
+template <typename T>
+[[nodiscard]] nlohmann::json json_value(const T& value)
+{
+    nlohmann::json j;
+    KRB5KerberosFieldTable<T>::for_each_field([&value, &j](const auto& field, auto) {
+        typedef std::decay_t<decltype(field)> Field;
+        if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Number) || is_kind<Field>(KRB5KerberosFieldKind::Flag))
+        {
+            j[field.key] = value.*field.member;
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Blob))
+        {
+            j[field.key] = KRB5KerberosBase64::encode(value.*field.contents, value.*field.length);
+            j["length"] = value.*field.length;
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Struct))
+        {
+            j[field.key] = json_value(value.*field.member);
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Pointer))
+        {
+            if (value.*field.member)
+            {
+                j[field.key] = json_value(*(value.*field.member));
+            }
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::List))
+        {
+            if (value.*field.member)
+            {
+                auto& j_list = j[field.key] = nlohmann::json::array();
+                for (auto entry = value.*field.member; *entry; ++entry)
+                {
+                    j_list.push_back(json_value(**entry));
+                }
+            }
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Components))
+        {
+            if (value.*field.entries && value.*field.length > 0)
+            {
+                auto& j_entries = j[field.key] = nlohmann::json::array();
+                for (std::int64_t i = 0; i < value.*field.length; ++i)
+                {
+                    j_entries.push_back(json_value((value.*field.entries)[i]));
+                }
+            }
+            j["length"] = value.*field.length;
+        }
+    });
+    return j;
+}
+
+template <typename T>
+void write_json_number(KRB5KerberosJsonWriter* writer, T value)
+{
+    if constexpr (std::is_signed_v<T>)
+    {
+        writer->value_int(value);
+    }
+    else
+    {
+        writer->value_uint(value);
+    }
+}
+
+// Keys are written in the order dump() sorts them into, optional ones are left out like json_value does
+template <typename T>
+void write_json(KRB5KerberosJsonWriter* writer, const T& value)
+{
+    writer->begin_object();
+    KRB5KerberosFieldTable<T>::for_each_key([writer, &value](const auto& field, auto is_length) {
+        typedef std::decay_t<decltype(field)> Field;
+        if constexpr (decltype(is_length)::value)
+        {
+            writer->key("length");
+            write_json_number(writer, value.*field.length);
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Number) || is_kind<Field>(KRB5KerberosFieldKind::Flag))
+        {
+            writer->key(field.key);
+            write_json_number(writer, value.*field.member);
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Blob))
+        {
+            writer->key(field.key);
+            writer->value_base64(value.*field.contents, value.*field.length);
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Struct))
+        {
+            writer->key(field.key);
+            write_json(writer, value.*field.member);
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Pointer))
+        {
+            if (value.*field.member)
+            {
+                writer->key(field.key);
+                write_json(writer, *(value.*field.member));
+            }
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::List))
+        {
+            if (value.*field.member)
+            {
+                writer->key(field.key);
+                writer->begin_array();
+                for (auto entry = value.*field.member; *entry; ++entry)
+                {
+                    write_json(writer, **entry);
+                }
+                writer->end_array();
+            }
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Components))
+        {
+            if (value.*field.entries && value.*field.length > 0)
+            {
+                writer->key(field.key);
+                writer->begin_array();
+                for (std::int64_t i = 0; i < value.*field.length; ++i)
+                {
+                    write_json(writer, (value.*field.entries)[i]);
+                }
+                writer->end_array();
+            }
+        }
+    });
+    writer->end_object();
+}
+
+template <typename T>
+void write_binary(KRB5KerberosByteWriter& writer, const T& value)
+{
+    KRB5KerberosFieldTable<T>::for_each_field([&writer, &value](const auto& field, auto) {
+        typedef std::decay_t<decltype(field)> Field;
+        if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Number))
+        {
+            writer.write_u32(value.*field.member);
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Flag))
+        {
+            writer.write_u8(value.*field.member ? 1 : 0);
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Blob))
+        {
+            writer.write_counted(value.*field.contents, value.*field.length);
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Struct))
+        {
+            write_binary(writer, value.*field.member);
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Pointer))
+        {
+            if (value.*field.member)
+            {
+                write_binary(writer, *(value.*field.member));
+            }
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::List))
+        {
+            if (value.*field.member)
+            {
+                std::uint32_t count = 0;
+                while ((value.*field.member)[count])
+                {
+                    ++count;
+                }
+                writer.write_u32(count);
+                for (std::uint32_t i = 0; i < count; ++i)
+                {
+                    write_binary(writer, *(value.*field.member)[i]);
+                }
+            }
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Components))
+        {
+            const auto length = value.*field.entries ? value.*field.length : 0;
+            writer.write_u32(length);
+            for (std::int64_t i = 0; i < length; ++i)
+            {
+                write_binary(writer, (value.*field.entries)[i]);
+            }
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Presence))
+        {
+            writer.write_u8(presence_bits(value));
+        }
+    });
+}
+
+/**
+ * Readers allocate through a sink. HeapSink hands out separate calloc'd allocations the krb5_free_* family
+ * releases. The contiguous sinks lay the whole graph out in one block:
+ *   header (padded to max_align_t), krb5_creds, then principals, component arrays, lists and blobs in input order
+ * Every reader runs twice over the same input, first against a ContiguousLayout which only measures the block and
+ * then against a ContiguousArena which hands out the measured block in the same order. The layout pass has nothing
+ * to write into, readers write into a scratch value instead.
+ */
+struct ContiguousHeader
+{
+    std::size_t size;
+};
+
+constexpr std::size_t align_up(std::size_t offset, std::size_t alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+constexpr const std::size_t CONTIGUOUS_HEADER_SIZE = align_up(sizeof(ContiguousHeader), alignof(std::max_align_t));
+
+class HeapSink
+{
+  public:
+    static constexpr bool fills = true;
+    static constexpr bool separate_entries = true;
+
+    template <typename T>
+    [[nodiscard]] T* take(std::size_t count)
+    {
+        return count > 0 ? static_cast<T*>(calloc(count, sizeof(T))) : nullptr;
+    }
+};
+
+class ContiguousLayout
+{
+  private:
+    std::size_t size_ = 0;
+
+  public:
+    static constexpr bool fills = false;
+    static constexpr bool separate_entries = false;
+
+    template <typename T>
+    [[nodiscard]] T* take(std::size_t count)
+    {
+        size_ = align_up(size_, alignof(T)) + count * sizeof(T);
+        return nullptr;
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return size_;
+    }
+};
+
+class ContiguousArena
+{
+  private:
+    char* block_;
+    std::size_t size_;
+    std::size_t offset_ = 0;
+
+  public:
+    static constexpr bool fills = true;
+    static constexpr bool separate_entries = false;
+
+    ContiguousArena(char* block, std::size_t size) : block_(block), size_(size)
+    {
+    }
+
+    // The block is zeroed, readers only set what differs from zero
+    template <typename T>
+    [[nodiscard]] T* take(std::size_t count)
+    {
+        const auto offset = align_up(offset_, alignof(T));
+        if (offset + count * sizeof(T) > size_)
+        {
+            return nullptr;
+        }
+        offset_ = offset + count * sizeof(T);
+        return reinterpret_cast<T*>(block_ + offset);
+    }
+};
+
+// Entries are null in the layout pass and for empty heap entries, running out of memory is the only failure
+template <typename Sink, typename T>
+[[nodiscard]] bool take_entries(Sink& sink, std::size_t count, T** entries)
+{
+    *entries = sink.template take<T>(count);
+    return !Sink::fills || count == 0 || *entries;
+}
+
+template <typename T>
+[[nodiscard]] T* entry_or(T* entries, std::size_t index, T* scratch)
+{
+    return entries ? &entries[index] : scratch;
+}
+
+// Null terminated pointer array, followed by the entries it points to unless the sink allocates them one by one
+template <typename Sink, typename T>
+[[nodiscard]] bool take_list(Sink& sink, std::size_t count, T*** list)
+{
+    T* entries = nullptr;
+    if (!take_entries(sink, count + 1, list) || (!Sink::separate_entries && !take_entries(sink, count, &entries)))
+    {
+        return false;
+    }
+    for (std::size_t i = 0; *list && i < count; ++i)
+    {
+        (*list)[i] = Sink::separate_entries ? sink.template take<T>(1) : &entries[i];
+        if (!(*list)[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void zeroize(void* data, std::size_t size)
+{
+    // Through a volatile pointer so the wipe of a block about to be freed is not optimized away
+    static void* (*const volatile memset_function)(void*, int, std::size_t) = std::memset;
+    memset_function(data, 0, size);
+}
+
+template <typename Sink, typename T>
+[[nodiscard]] bool copy_blob(Sink& sink, std::string_view bytes, unsigned int* length, T** contents)
+{
+    char* blob = nullptr;
+    *length = bytes.size();
+    if (!take_entries(sink, bytes.size(), &blob))
+    {
+        return false;
+    }
+    if (blob)
+    {
+        std::memcpy(blob, bytes.data(), bytes.size());
+    }
+    *contents = reinterpret_cast<T*>(blob);
+    return true;
+}
+
+/**
+ * The json length field is the blob length whatever the contents decode to. Contents decoding to less are zero padded
+ * up to it, so the blob never reads past them, and the bytes of contents decoding to more are wiped past it, since a
+ * release only wipes the length.
+ */
+template <typename Sink, typename T>
+[[nodiscard]] bool copy_json_blob(Sink& sink,
+                                  const nlohmann::json& j,
+                                  const char* key,
+                                  unsigned int* length,
+                                  T** contents)
+{
+    char* blob = nullptr;
+    std::size_t size;
+    *length = j["length"];
+    const auto& encoded = j[key].get_ref<const std::string&>();
+    if (!KRB5KerberosBase64::decoded_size(encoded, &size)
+        || !take_entries(sink, std::max<std::size_t>(size, *length), &blob))
+    {
+        return false;
+    }
+    // Handed over before decoding so a heap blob is released with the rest on failure
+    *contents = reinterpret_cast<T*>(blob);
+    if (!blob)
+    {
+        return true;
+    }
+    if (!KRB5KerberosBase64::decode(encoded, blob))
+    {
+        return false;
+    }
+    if (size > *length)
+    {
+        zeroize(blob + *length, size - *length);
+    }
+    return true;
+}
+
+template <typename Sink, typename T>
+[[nodiscard]] bool read_json(Sink& sink, const nlohmann::json& j, T* value);
+
+template <typename Sink, typename T>
+[[nodiscard]] bool read_json_entry(Sink& sink, const nlohmann::json& j, T** entry)
+{
+    T scratch{};
+    return take_entries(sink, 1, entry) && read_json(sink, j, entry_or(*entry, 0, &scratch));
+}
+
+template <typename Sink, typename T>
+[[nodiscard]] bool read_json_list(Sink& sink, const nlohmann::json& j, T*** list)
+{
+    if (!j.is_array() || !take_list(sink, j.size(), list))
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < j.size(); ++i)
+    {
+        T scratch{};
+        if (!read_json(sink, j[i], *list ? (*list)[i] : &scratch))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Every required key has to be present. Components are only read when both "data" and "length" are present, and only
+ * the first "length" of them have to be valid
+ */
+template <typename Sink, typename T>
+[[nodiscard]] bool read_json(Sink& sink, const nlohmann::json& j, T* value)
+{
+    for (const auto& key : KRB5KerberosFieldTable<T>::keys)
+    {
+        // Names view string literals
+        if (key.is_required && !j.contains(key.name.data()))
+        {
+            return false;
+        }
+    }
+    return KRB5KerberosFieldTable<T>::all_fields([&sink, &j, value](const auto& field, auto) {
+        typedef std::decay_t<decltype(field)> Field;
+        if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Number) || is_kind<Field>(KRB5KerberosFieldKind::Flag))
+        {
+            value->*field.member = j[field.key];
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Blob))
+        {
+            return copy_json_blob(sink, j, field.key, &(value->*field.length), &(value->*field.contents));
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Struct))
+        {
+            return read_json(sink, j[field.key], &(value->*field.member));
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Pointer))
+        {
+            return !j.contains(field.key) || read_json_entry(sink, j[field.key], &(value->*field.member));
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::List))
+        {
+            return !j.contains(field.key) || read_json_list(sink, j[field.key], &(value->*field.member));
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Components))
+        {
+            if (!j.contains(field.key) || !j.contains("length"))
+            {
+                return true;
+            }
+            const auto& j_entries = j[field.key];
+            const auto length = j["length"].template get<std::size_t>();
+            if (!j_entries.is_array() || j_entries.size() < length
+                || !take_entries(sink, length, &(value->*field.entries)))
+            {
+                return false;
+            }
+            value->*field.length = static_cast<std::decay_t<decltype(value->*field.length)>>(length);
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                typename Field::Type scratch{};
+                if (!read_json(sink, j_entries[i], entry_or(value->*field.entries, i, &scratch)))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    });
+}
+
+template <typename Sink, typename T>
+[[nodiscard]] bool read_binary(Sink& sink, KRB5KerberosByteReader& reader, T* value);
+
+template <typename Sink, typename T>
+[[nodiscard]] bool read_binary_entry(Sink& sink, KRB5KerberosByteReader& reader, T** entry)
+{
+    T scratch{};
+    return take_entries(sink, 1, entry) && read_binary(sink, reader, entry_or(*entry, 0, &scratch));
+}
+
+// Counts are bounded by what the remaining input can hold
+template <typename Sink, typename T>
+[[nodiscard]] bool read_binary_list(Sink& sink, KRB5KerberosByteReader& reader, T*** list)
+{
+    std::uint32_t count;
+    if (!reader.read_u32(&count) || count > reader.remaining() / KRB5KerberosFieldTable<T>::binary_min_size()
+        || !take_list(sink, count, list))
+    {
+        return false;
+    }
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        T scratch{};
+        if (!read_binary(sink, reader, *list ? (*list)[i] : &scratch))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Sink, typename T>
+[[nodiscard]] bool read_binary(Sink& sink, KRB5KerberosByteReader& reader, T* value)
+{
+    std::uint8_t present = 0;
+    return KRB5KerberosFieldTable<T>::all_fields([&sink, &reader, value, &present](const auto& field, auto index) {
+        typedef std::decay_t<decltype(field)> Field;
+        if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Number))
+        {
+            return read_i32(reader, &(value->*field.member));
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Flag))
+        {
+            std::uint8_t flag;
+            if (!reader.read_u8(&flag))
+            {
+                return false;
+            }
+            value->*field.member = flag != 0;
+            return true;
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Blob))
+        {
+            std::string_view bytes;
+            return reader.read_counted(&bytes)
+                   && copy_blob(sink, bytes, &(value->*field.length), &(value->*field.contents));
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Struct))
+        {
+            return read_binary(sink, reader, &(value->*field.member));
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Pointer))
+        {
+            return !(present & KRB5KerberosFieldTable<T>::template presence_bit<decltype(index)::value>())
+                   || read_binary_entry(sink, reader, &(value->*field.member));
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::List))
+        {
+            return !(present & KRB5KerberosFieldTable<T>::template presence_bit<decltype(index)::value>())
+                   || read_binary_list(sink, reader, &(value->*field.member));
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Components))
+        {
+            typedef typename Field::Type Entry;
+            std::uint32_t length;
+            if (!reader.read_u32(&length)
+                || length > reader.remaining() / KRB5KerberosFieldTable<Entry>::binary_min_size()
+                || !take_entries(sink, length, &(value->*field.entries)))
+            {
+                return false;
+            }
+            value->*field.length = length;
+            for (std::uint32_t i = 0; i < length; ++i)
+            {
+                Entry scratch{};
+                if (!read_binary(sink, reader, entry_or(value->*field.entries, i, &scratch)))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        else
+        {
+            return reader.read_u8(&present);
+        }
+    });
+}
+
+template <typename Sink>
+[[nodiscard]] bool read_binary_creds(Sink& sink, std::string_view data, krb5_creds* creds)
+{
+    KRB5KerberosByteReader reader(data);
+    std::uint8_t version;
+    return reader.read_u8(&version) && version == CREDS_BINARY_VERSION && read_binary(sink, reader, creds)
+           && reader.remaining() == 0;
+}
+
+// Measures, allocates and fills, the creds are the first entry of the block
+template <typename Read>
+[[nodiscard]] krb5_creds* build_contiguous_creds(const Read& read)
+{
+    const auto read_creds = [&read](auto& sink) {
+        krb5_creds* entry;
+        krb5_creds scratch{};
+        return take_entries(sink, 1, &entry) && read(sink, entry_or(entry, 0, &scratch));
+    };
+    ContiguousLayout layout;
+    if (!read_creds(layout))
+    {
+        return nullptr;
+    }
+    const auto size = CONTIGUOUS_HEADER_SIZE + layout.size();
+    auto block = static_cast<char*>(calloc(1, size));
+    if (!block)
+    {
+        return nullptr;
+    }
+    reinterpret_cast<ContiguousHeader*>(block)->size = size;
+    ContiguousArena arena(block + CONTIGUOUS_HEADER_SIZE, layout.size());
+    auto success = false;
+    try
+    {
+        success = read_creds(arena);
+    }
+    catch (...)
+    {
+        zeroize(block, size);
+        free(block);
+        throw;
+    }
+    if (!success)
+    {
+        zeroize(block, size);
+        free(block);
+        return nullptr;
+    }
+    return reinterpret_cast<krb5_creds*>(block + CONTIGUOUS_HEADER_SIZE);
+}
+
+void write_ccache_principal(KRB5KerberosByteWriter& writer, const krb5_principal_data& principal_data)
+{
+    const auto length = principal_data.data ? principal_data.length : 0;
+    writer.write_u32(principal_data.type);
+    writer.write_u32(length);
+    writer.write_counted(principal_data.realm.data, principal_data.realm.length);
+    for (auto i = 0; i < length; ++i)
+    {
+        writer.write_counted(principal_data.data[i].data, principal_data.data[i].length);
+    }
+}
+
+[[nodiscard]] bool read_ccache_data(KRB5KerberosByteReader& reader, krb5_data* data)
+{
+    data->magic = KV5M_DATA;
+    return read_blob(reader, &data->data, &data->length);
+}
+
+[[nodiscard]] bool read_ccache_principal(KRB5KerberosByteReader& reader, krb5_principal* principal)
+{
+    std::uint32_t length;
+    *principal = static_cast<krb5_principal>(calloc(1, sizeof(krb5_principal_data)));
+    if (!*principal || !read_i32(reader, &(*principal)->type) || !reader.read_u32(&length)
+        || !read_ccache_data(reader, &(*principal)->realm) || length > reader.remaining() / 4)
+    {
+        return false;
+    }
+    (*principal)->magic = KV5M_PRINCIPAL;
+    if (length > 0)
+    {
+        (*principal)->data = static_cast<krb5_data*>(calloc(length, sizeof(krb5_data)));
+        if (!(*principal)->data)
+        {
+            return false;
+        }
+        (*principal)->length = length;
+        for (std::uint32_t i = 0; i < length; ++i)
+        {
+            if (!read_ccache_data(reader, &(*principal)->data[i]))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+[[nodiscard]] bool read_ccache_address(KRB5KerberosByteReader& reader, krb5_address* address)
+{
+    std::uint16_t addrtype;
+    address->magic = KV5M_ADDRESS;
+    if (!reader.read_u16(&addrtype))
+    {
+        return false;
+    }
+    address->addrtype = addrtype;
+    return read_blob(reader, &address->contents, &address->length);
+}
+
+[[nodiscard]] bool read_ccache_authdata(KRB5KerberosByteReader& reader, krb5_authdata* authdata)
+{
+    std::uint16_t ad_type;
+    authdata->magic = KV5M_AUTHDATA;
+    if (!reader.read_u16(&ad_type))
+    {
+        return false;
+    }
+    authdata->ad_type = ad_type;
+    return read_blob(reader, &authdata->contents, &authdata->length);
+}
+
+// Empty lists are stored as a zero count, read them back as null like libkrb5 does
+template <typename T>
+[[nodiscard]] bool read_ccache_list(KRB5KerberosByteReader& reader,
+                                    T*** list,
+                                    bool (*read_entry)(KRB5KerberosByteReader&, T*))
+{
+    std::uint32_t count;
+    if (!reader.read_u32(&count) || count > reader.remaining() / 6)
+    {
+        return false;
+    }
+    if (count == 0)
+    {
+        *list = nullptr;
+        return true;
+    }
+    *list = static_cast<T**>(calloc(count + 1, sizeof(T*)));
+    if (!*list)
+    {
+        return false;
+    }
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        (*list)[i] = static_cast<T*>(calloc(1, sizeof(T)));
+        if (!(*list)[i] || !read_entry(reader, (*list)[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reads a single creds entry into a zeroed creds, on failure the partially read contents are left for the caller
+[[nodiscard]] bool read_ccache_creds(KRB5KerberosByteReader& reader, krb5_creds* creds, std::uint16_t version)
+{
+    std::uint16_t enctype, v3_enctype;
+    std::uint8_t is_skey;
+    creds->magic = KV5M_CREDS;
+    creds->keyblock.magic = KV5M_KEYBLOCK;
+    if (!read_ccache_principal(reader, &creds->client) || !read_ccache_principal(reader, &creds->server)
+        || !reader.read_u16(&enctype)
+        || (version == CCACHE_VERSION_3 && (!reader.read_u16(&v3_enctype) || v3_enctype != enctype))
+        || !read_blob(reader, &creds->keyblock.contents, &creds->keyblock.length)
+        || !read_i32(reader, &creds->times.authtime) || !read_i32(reader, &creds->times.starttime)
+        || !read_i32(reader, &creds->times.endtime) || !read_i32(reader, &creds->times.renew_till)
+        || !reader.read_u8(&is_skey) || !read_i32(reader, &creds->ticket_flags)
+        || !read_ccache_list(reader, &creds->addresses, read_ccache_address)
+        || !read_ccache_list(reader, &creds->authdata, read_ccache_authdata)
+        || !read_ccache_data(reader, &creds->ticket) || !read_ccache_data(reader, &creds->second_ticket))
+    {
+        return false;
+    }
+    // Enctypes are signed, the negative (local) ones survive the 16 bit field
+    creds->keyblock.enctype = static_cast<std::int16_t>(enctype);
+    creds->is_skey = is_skey;
+    return true;
+}
+
+/**
+ * Json text, parsed on demand straight into the creds. Accepts the documents deserialize_creds accepts, a repeated
+ * key replaces what the earlier ones read as it does in nlohmann, and unknown keys are skipped without being validated
+ * further.
+ */
+namespace ondemand = simdjson::ondemand;
+
+// Keys of the ticket documents, and of the creds fields the peek reads
+constexpr const std::uint32_t TEXT_NAME = 1 << 0;
+constexpr const std::uint32_t TEXT_CREDS = 1 << 1;
+constexpr const std::uint32_t TEXT_EXPIRATION = 1 << 2;
+constexpr const std::uint32_t TEXT_CLIENT = 1 << 3;
+constexpr const std::uint32_t TEXT_SERVER = 1 << 4;
+constexpr const std::uint32_t TEXT_TIMES = 1 << 5;
+constexpr const std::uint32_t TEXT_TICKET_FLAGS = 1 << 6;
+
+// Returns whether the key was seen before, so what it read can be released first
+template <typename Mask>
+[[nodiscard]] bool mark_seen(Mask* seen, Mask key)
+{
+    const auto was_seen = (*seen & key) != 0;
+    *seen |= key;
+    return was_seen;
+}
+
+// Numbers convert the way nlohmann converts them to arithmetic fields, floats truncate and booleans are 0 or 1
+template <typename T>
+[[nodiscard]] bool text_number(ondemand::value& value, T* out)
+{
+    ondemand::json_type type;
+    if (value.type().get(type))
+    {
+        return false;
+    }
+    if (type == ondemand::json_type::boolean)
+    {
+        bool flag;
+        if (value.get_bool().get(flag))
+        {
+            return false;
+        }
+        *out = static_cast<T>(flag);
+        return true;
+    }
+    ondemand::number_type number_type;
+    if (type != ondemand::json_type::number || value.get_number_type().get(number_type))
+    {
+        return false;
+    }
+    switch (number_type)
+    {
+        case ondemand::number_type::signed_integer:
+        {
+            std::int64_t number;
+            if (value.get_int64().get(number))
+            {
+                return false;
+            }
+            *out = static_cast<T>(number);
+            return true;
+        }
+        case ondemand::number_type::unsigned_integer:
+        {
+            std::uint64_t number;
+            if (value.get_uint64().get(number))
+            {
+                return false;
+            }
+            *out = static_cast<T>(number);
+            return true;
+        }
+        default:
+        {
+            // Integers too large for 64 bits are floats in nlohmann as well
+            double number;
+            if (value.get_double().get(number))
+            {
+                return false;
+            }
+            *out = static_cast<T>(number);
+            return true;
+        }
+    }
+}
+
+template <typename T>
+[[nodiscard]] bool text_blob(ondemand::value& value, T** contents, unsigned int* length)
+{
+    std::string_view encoded;
+    std::size_t size;
+    if (value.get_string().get(encoded) || !KRB5KerberosBase64::decoded_size(encoded, &size)
+        || size > std::numeric_limits<unsigned int>::max())
+    {
+        return false;
+    }
+    if (size == 0)
+    {
+        return true;
+    }
+    *contents = static_cast<T*>(calloc(size, sizeof(char)));
+    if (!*contents)
+    {
+        return false;
+    }
+    *length = static_cast<unsigned int>(size);
+    return KRB5KerberosBase64::decode(encoded, *contents);
+}
+
+// Fields are visited in document order, visit returns false to abort
+template <typename F>
+[[nodiscard]] bool text_fields(ondemand::object& object, F&& visit)
+{
+    for (auto result : object)
+    {
+        ondemand::field field;
+        std::string_view key;
+        if (std::move(result).get(field) || field.unescaped_key().get(key) || !visit(key, field.value()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename F>
+[[nodiscard]] bool text_object(ondemand::value& value, F&& visit)
+{
+    ondemand::object object;
+    return !value.get_object().get(object) && text_fields(object, std::forward<F>(visit));
+}
+
+template <typename T>
+[[nodiscard]] bool text_value(ondemand::value& value, T* out);
+
+template <typename T>
+[[nodiscard]] bool text_list(ondemand::value& value, T*** list);
+
+/**
+ * Reads the fields of one struct in the order the document holds them, keys are matched through their hashes. What
+ * was read is left in the struct for the caller to release on failure.
+ * Blobs take their "length" as copy_json_blob does. Components are only taken when both "data" and "length" are
+ * present, and only the first "length" of them have to be valid
+ */
+template <typename T>
+class TextReader
+{
+  private:
+    T* out_;
+    std::uint64_t seen_ = 0;
+    unsigned int blob_length_ = 0;
+    std::vector<krb5_data> components_;
+    krb5_int32 components_length_ = 0;
+    bool has_components_ = false;
+    bool has_components_length_ = false;
+    bool are_components_valid_ = true;
+    bool is_components_length_valid_ = true;
+
+  private:
+    [[nodiscard]] bool read_components(ondemand::value& value)
+    {
+        // Not being an array only matters when "length" is present as well
+        ondemand::array array;
+        has_components_ = true;
+        are_components_valid_ = !value.get_array().get(array);
+        if (!are_components_valid_)
+        {
+            return true;
+        }
+        auto parsing = true;
+        for (auto result : array)
+        {
+            ondemand::value entry;
+            if (std::move(result).get(entry))
+            {
+                return false;
+            }
+            if (parsing)
+            {
+                krb5_data component{};
+                parsing = text_value(entry, &component);
+                if (parsing)
+                {
+                    components_.push_back(component);
+                }
+                else
+                {
+                    release_contents(&component);
+                }
+            }
+        }
+        return true;
+    }
+
+    template <typename Field>
+    [[nodiscard]] bool take_components(const Field& field)
+    {
+        static_assert(std::is_same_v<typename Field::Type, krb5_data>, "components are read as krb5_data");
+        if (!has_components_ || !has_components_length_)
+        {
+            return true;
+        }
+        if (!are_components_valid_ || !is_components_length_valid_ || components_length_ < 0
+            || components_.size() < static_cast<std::size_t>(components_length_))
+        {
+            return false;
+        }
+        auto& entries = out_->*field.entries;
+        entries = static_cast<krb5_data*>(calloc(std::max(components_length_, 1), sizeof(krb5_data)));
+        if (!entries)
+        {
+            return false;
+        }
+        std::copy(components_.begin(), components_.begin() + components_length_, entries);
+        out_->*field.length = components_length_;
+        components_.erase(components_.begin(), components_.begin() + components_length_);
+        return true;
+    }
+
+    // A repeated key starts over, the struct only keeps what its last occurrence holds
+    template <typename Field>
+    void forget(const Field& field)
+    {
+        if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Components))
+        {
+            for (auto& component : components_)
+            {
+                release_contents(&component);
+            }
+            components_.clear();
+        }
+        else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Struct))
+        {
+            release_field(out_, field);
+            out_->*field.member = {};
+        }
+        else
+        {
+            release_field(out_, field);
+        }
+    }
+
+    // The contents are decoded before "length" may be read, they are padded or wiped past it once both are known
+    template <typename Contents>
+    [[nodiscard]] bool take_blob_length(Contents** contents, unsigned int* length)
+    {
+        if (blob_length_ > *length)
+        {
+            auto blob = static_cast<Contents*>(calloc(blob_length_, sizeof(char)));
+            if (!blob)
+            {
+                return false;
+            }
+            if (*contents)
+            {
+                std::memcpy(blob, *contents, *length);
+            }
+            release_blob(*contents, *length);
+            *contents = blob;
+        }
+        else if (blob_length_ < *length)
+        {
+            zeroize(reinterpret_cast<char*>(*contents) + blob_length_, *length - blob_length_);
+        }
+        *length = blob_length_;
+        return true;
+    }
+
+  public:
+    explicit TextReader(T* out) : out_(out)
+    {
+    }
+
+    ~TextReader()
+    {
+        for (auto& component : components_)
+        {
+            release_contents(&component);
+        }
+    }
+
+    TextReader(const TextReader&) = delete;
+    TextReader& operator=(const TextReader&) = delete;
+
+    [[nodiscard]] bool field(std::string_view key, ondemand::value& value)
+    {
+        return KRB5KerberosFieldTable<T>::visit_key(key, [this, &value](const auto& field, auto index, auto is_length) {
+            typedef std::decay_t<decltype(field)> Field;
+            if (mark_seen(&seen_, std::uint64_t(1) << decltype(index)::value) && !decltype(is_length)::value)
+            {
+                forget(field);
+            }
+            if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Components))
+            {
+                if constexpr (decltype(is_length)::value)
+                {
+                    has_components_length_ = true;
+                    is_components_length_valid_ = text_number(value, &components_length_);
+                    return true;
+                }
+                else
+                {
+                    return read_components(value);
+                }
+            }
+            else if constexpr (decltype(is_length)::value)
+            {
+                return text_number(value, &blob_length_);
+            }
+            else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Number)
+                               || is_kind<Field>(KRB5KerberosFieldKind::Flag))
+            {
+                return text_number(value, &(out_->*field.member));
+            }
+            else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Blob))
+            {
+                return text_blob(value, &(out_->*field.contents), &(out_->*field.length));
+            }
+            else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Struct))
+            {
+                return text_value(value, &(out_->*field.member));
+            }
+            else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Pointer))
+            {
+                typedef typename Field::Type Entry;
+                auto& entry = out_->*field.member;
+                entry = static_cast<Entry*>(calloc(1, sizeof(Entry)));
+                return entry && text_value(value, entry);
+            }
+            else
+            {
+                return text_list(value, &(out_->*field.member));
+            }
+        });
+    }
+
+    [[nodiscard]] bool finish()
+    {
+        constexpr auto required = KRB5KerberosFieldTable<T>::required_keys();
+        return (seen_ & required) == required && KRB5KerberosFieldTable<T>::all_fields([this](const auto& field, auto) {
+                   typedef std::decay_t<decltype(field)> Field;
+                   if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Blob))
+                   {
+                       return take_blob_length(&(out_->*field.contents), &(out_->*field.length));
+                   }
+                   else if constexpr (is_kind<Field>(KRB5KerberosFieldKind::Components))
+                   {
+                       return take_components(field);
+                   }
+                   return true;
+               });
+    }
+};
+
+template <typename T>
+[[nodiscard]] bool text_value(ondemand::value& value, T* out)
 {
-nlohmann::json KRB5KerberosSerializer::serialize_principal_data(const krb5_principal_data& principal_data)
+    TextReader<T> reader(out);
+    return text_object(value,
+                       [&reader](std::string_view key, ondemand::value& field) { return reader.field(key, field); })
+           && reader.finish();
+}
+
+// The list is always handed over null terminated, so on failure the krb5_free_* family releases what was parsed
+template <typename T>
+[[nodiscard]] bool text_list(ondemand::value& value, T*** list)
 {
-    nlohmann::json client;
-    client["magic"] = principal_data.magic;
-    client["realm"] = KRB5KerberosSerializer::serialize_data(principal_data.realm);
-    if (principal_data.data && principal_data.length > 0)
+    ondemand::array array;
+    if (value.get_array().get(array))
+    {
+        return false;
+    }
+    std::vector<T*> entries;
+    auto success = true;
+    for (auto result : array)
     {
-        client["data"] = nlohmann::json::array();
-        for (auto i = 0; i < principal_data.length; ++i)
+        ondemand::value entry_value;
+        auto entry = static_cast<T*>(calloc(1, sizeof(T)));
+        if (entry)
+        {
+            entries.push_back(entry);
+        }
+        if (!entry || std::move(result).get(entry_value) || !text_value(entry_value, entry))
         {
-            client["data"].push_back(KRB5KerberosSerializer::serialize_data(principal_data.data[i]));
+            success = false;
+            break;
         }
     }
-    client["length"] = principal_data.length;
-    client["type"] = principal_data.type;
-    return client;
-}
-
-nlohmann::json KRB5KerberosSerializer::serialize_data(const krb5_data& data)
-{
-    nlohmann::json j_data;
-    j_data["magic"] = data.magic;
-    j_data["length"] = data.length;
-    j_data["data"] = encryption::Base64::base64_encode(std::string(data.data, data.length));
-    return j_data;
+    *list = static_cast<T**>(calloc(entries.size() + 1, sizeof(T*)));
+    if (!*list)
+    {
+        for (auto entry : entries)
+        {
+            release_contents(entry);
+            free(entry);
+        }
+        return false;
+    }
+    std::copy(entries.begin(), entries.end(), *list);
+    return success;
 }
 
-nlohmann::json KRB5KerberosSerializer::serialize_keyblock(const krb5_keyblock& keyblock)
+// The parser and the padded copy of the text are reused per thread, simdjson reads past the end of its input
+template <typename F>
+[[nodiscard]] bool text_document(std::string_view text, F&& visit)
 {
-    nlohmann::json j_keyblock;
-    j_keyblock["magic"] = keyblock.magic;
-    j_keyblock["enctype"] = keyblock.enctype;
-    j_keyblock["length"] = keyblock.length;
-    j_keyblock["contents"] =
-        encryption::Base64::base64_encode(std::string(reinterpret_cast<char*>(keyblock.contents), keyblock.length));
-    return j_keyblock;
+    thread_local ondemand::parser parser;
+    thread_local std::string padded;
+    padded.reserve(text.size() + simdjson::SIMDJSON_PADDING);
+    padded.assign(text);
+    ondemand::document document;
+    ondemand::object object;
+    return !parser.iterate(padded.data(), padded.size(), padded.capacity()).get(document)
+           && !document.get_object().get(object) && text_fields(object, std::forward<F>(visit)) && document.at_end();
 }
 
-nlohmann::json KRB5KerberosSerializer::serialize_times(const krb5_ticket_times& times)
+// Same escaping as krb5_unparse_name, the realm separator is only escaped within components
+void append_unparsed(std::string* out, std::string_view part, bool is_component)
 {
-    nlohmann::json j_times;
-    j_times["authtime"] = times.authtime;
-    j_times["starttime"] = times.starttime;
-    j_times["endtime"] = times.endtime;
-    j_times["renew_till"] = times.renew_till;
-    return j_times;
+    for (const auto c : part)
+    {
+        switch (c)
+        {
+            case '\0':
+                out->append("\\0");
+                break;
+            case '\b':
+                out->append("\\b");
+                break;
+            case '\t':
+                out->append("\\t");
+                break;
+            case '\n':
+                out->append("\\n");
+                break;
+            case '/':
+                out->append(is_component ? "\\/" : "/");
+                break;
+            case '@':
+            case '\\':
+                out->push_back('\\');
+                out->push_back(c);
+                break;
+            default:
+                out->push_back(c);
+                break;
+        }
+    }
 }
 
-nlohmann::json KRB5KerberosSerializer::serialize_address(const krb5_address& address)
+void unparse_principal(const std::vector<std::string>& components, std::string_view realm, std::string* name)
 {
-    nlohmann::json j_address;
-    j_address["magic"] = address.magic;
-    j_address["addrtype"] = address.addrtype;
-    j_address["length"] = address.length;
-    j_address["contents"] =
-        encryption::Base64::base64_encode(std::string(reinterpret_cast<char*>(address.contents), address.length));
-    return j_address;
+    name->clear();
+    for (std::size_t i = 0; i < components.size(); ++i)
+    {
+        if (i > 0)
+        {
+            name->push_back('/');
+        }
+        append_unparsed(name, components[i], true);
+    }
+    name->push_back('@');
+    append_unparsed(name, realm, false);
 }
 
-nlohmann::json KRB5KerberosSerializer::serialize_authdata(const krb5_authdata& authdata)
+[[nodiscard]] bool peek_text_data(ondemand::value& value, std::string* data)
 {
-    nlohmann::json j_authdata;
-    j_authdata["magic"] = authdata.magic;
-    j_authdata["ad_type"] = authdata.ad_type;
-    j_authdata["length"] = authdata.length;
-    j_authdata["contents"] =
-        encryption::Base64::base64_encode(std::string(reinterpret_cast<char*>(authdata.contents), authdata.length));
-    return j_authdata;
+    auto found = false;
+    return text_object(value,
+                       [&](std::string_view key, ondemand::value& field) {
+                           std::string_view encoded;
+                           if (key != "data")
+                           {
+                               return true;
+                           }
+                           found = true;
+                           return !field.get_string().get(encoded) && KRB5KerberosBase64::decode(encoded, data);
+                       })
+           && found;
 }
 
-nlohmann::json KRB5KerberosSerializer::serialize_creds(const krb5_creds& creds)
+// Components are taken from "data", cut to "length" when both are present like deserialize_principal_data does
+[[nodiscard]] bool peek_text_principal(ondemand::value& value, std::string* name)
 {
-    nlohmann::json j;
-    j["magic"] = creds.magic;
-    if (creds.client)
+    std::vector<std::string> components;
+    std::string realm;
+    krb5_int32 length = -1;
+    if (!text_object(value, [&](std::string_view key, ondemand::value& field) {
+            if (key == "realm")
+            {
+                return peek_text_data(field, &realm);
+            }
+            if (key == "length")
+            {
+                return text_number(field, &length);
+            }
+            if (key != "data")
+            {
+                return true;
+            }
+            ondemand::array array;
+            if (field.get_array().get(array))
+            {
+                return false;
+            }
+            components.clear();
+            for (auto result : array)
+            {
+                ondemand::value entry;
+                components.emplace_back();
+                if (std::move(result).get(entry) || !peek_text_data(entry, &components.back()))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }))
     {
-        j["client"] = KRB5KerberosSerializer::serialize_principal_data(*creds.client);
+        return false;
     }
-    if (creds.server)
+    if (length < 0 || components.empty())
     {
-        j["server"] = KRB5KerberosSerializer::serialize_principal_data(*creds.server);
+        components.clear();
     }
-    j["keyblock"] = KRB5KerberosSerializer::serialize_keyblock(creds.keyblock);
-    j["times"] = KRB5KerberosSerializer::serialize_times(creds.times);
-    j["is_skey"] = creds.is_skey;
-    j["ticket_flags"] = creds.ticket_flags;
-    if (creds.addresses)
+    else if (components.size() > static_cast<std::size_t>(length))
     {
-        j["addresses"] = nlohmann::json::array();
-        krb5_address** curr_addr = creds.addresses;
-        while (*curr_addr)
-        {
-            j["addresses"].push_back(KRB5KerberosSerializer::serialize_address(**curr_addr));
-            ++curr_addr;
-        }
+        components.resize(length);
     }
-    j["ticket"] = KRB5KerberosSerializer::serialize_data(creds.ticket);
-    j["second_ticket"] = KRB5KerberosSerializer::serialize_data(creds.second_ticket);
-    if (creds.authdata)
+    unparse_principal(components, realm, name);
+    return true;
+}
+
+[[nodiscard]] bool peek_binary_principal(KRB5KerberosByteReader& reader, std::string* name)
+{
+    std::uint32_t magic, length;
+    std::string_view realm;
+    if (!reader.read_u32(&magic) || !reader.read_u32(&magic) || !reader.read_counted(&realm)
+        || !reader.read_u32(&length) || length > reader.remaining() / 8)
     {
-        j["authdata"] = nlohmann::json::array();
-        krb5_authdata** curr_authdata = creds.authdata;
-        while (*curr_authdata)
+        return false;
+    }
+    std::vector<std::string> components(length);
+    for (auto& component : components)
+    {
+        std::string_view bytes;
+        if (!reader.read_u32(&magic) || !reader.read_counted(&bytes))
         {
-            j["authdata"].push_back(KRB5KerberosSerializer::serialize_authdata(**curr_authdata));
-            ++curr_authdata;
+            return false;
         }
+        component = std::string(bytes);
     }
-    return j;
+    unparse_principal(components, realm, name);
+    return reader.read_u32(&magic);
 }
-
-bool KRB5KerberosSerializer::deserialize_principal_data(const nlohmann::json& j, krb5_principal_data* principal_data)
+// Replaces what the struct held, on failure it is left released
+template <typename T>
+[[nodiscard]] bool replace_json(const nlohmann::json& j, T* value)
 {
-    if (!principal_data || !j.contains("magic") || !j.contains("realm") || !j.contains("type"))
+    HeapSink heap;
+    auto success = false;
+    if (!value)
     {
         return false;
     }
-    principal_data->magic = j["magic"];
-    if (!KRB5KerberosSerializer::deserialize_data(j["realm"], &principal_data->realm))
+    release_contents(value);
+    try
     {
-        return false;
+        success = read_json(heap, j, value);
     }
-    if (principal_data->data && principal_data->length > 0)
+    catch (...)
     {
-        for (auto i = 0; i < principal_data->length; ++i)
-        {
-            if (principal_data->data[i].data && principal_data->data[i].length > 0)
-            {
-                std::memset(reinterpret_cast<void*>(principal_data->data[i].data), 0, principal_data->data[i].length);
-                SAFE_FREE(principal_data->data[i].data);
-            }
-        }
-        SAFE_FREE(principal_data->data);
+        release_contents(value);
+        throw;
     }
-    principal_data->data = nullptr;
-    principal_data->length = 0;
-    if (j.contains("data") && j.contains("length"))
+    if (!success)
     {
-        std::vector<nlohmann::json> j_data = j["data"];
-        principal_data->length = j["length"];
-        principal_data->data = reinterpret_cast<krb5_data*>(calloc(principal_data->length, sizeof(krb5_data)));
-        for (auto i = 0; i < principal_data->length; ++i)
-        {
-            if (!KRB5KerberosSerializer::deserialize_data(j_data[i], &principal_data->data[i]))
-            {
-                SAFE_FREE(principal_data->data);
-                return false;
-            }
-        }
+        release_contents(value);
     }
-    principal_data->type = j["type"];
-    return true;
+    return success;
+}
+
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+nlohmann::json KRB5KerberosSerializer::serialize_principal_data(const krb5_principal_data& principal_data)
+{
+    return json_value(principal_data);
+}
+
+nlohmann::json KRB5KerberosSerializer::serialize_data(const krb5_data& data)
+{
+    return json_value(data);
+}
+
+nlohmann::json KRB5KerberosSerializer::serialize_keyblock(const krb5_keyblock& keyblock)
+{
+    return json_value(keyblock);
+}
+
+nlohmann::json KRB5KerberosSerializer::serialize_times(const krb5_ticket_times& times)
+{
+    return json_value(times);
+}
+
+nlohmann::json KRB5KerberosSerializer::serialize_address(const krb5_address& address)
+{
+    return json_value(address);
+}
+
+nlohmann::json KRB5KerberosSerializer::serialize_authdata(const krb5_authdata& authdata)
+{
+    return json_value(authdata);
+}
+
+nlohmann::json KRB5KerberosSerializer::serialize_creds(const krb5_creds& creds)
+{
+    return json_value(creds);
+}
+
+void KRB5KerberosSerializer::serialize_principal_data(const krb5_principal_data& principal_data,
+                                                      KRB5KerberosJsonWriter* writer)
+{
+    write_json(writer, principal_data);
+}
+
+void KRB5KerberosSerializer::serialize_data(const krb5_data& data, KRB5KerberosJsonWriter* writer)
+{
+    write_json(writer, data);
+}
+
+void KRB5KerberosSerializer::serialize_keyblock(const krb5_keyblock& keyblock, KRB5KerberosJsonWriter* writer)
+{
+    write_json(writer, keyblock);
+}
+
+void KRB5KerberosSerializer::serialize_times(const krb5_ticket_times& times, KRB5KerberosJsonWriter* writer)
+{
+    write_json(writer, times);
+}
+
+void KRB5KerberosSerializer::serialize_address(const krb5_address& address, KRB5KerberosJsonWriter* writer)
+{
+    write_json(writer, address);
+}
+
+void KRB5KerberosSerializer::serialize_authdata(const krb5_authdata& authdata, KRB5KerberosJsonWriter* writer)
+{
+    write_json(writer, authdata);
+}
+
+void KRB5KerberosSerializer::serialize_creds(const krb5_creds& creds, KRB5KerberosJsonWriter* writer)
+{
+    write_json(writer, creds);
+}
+
+bool KRB5KerberosSerializer::deserialize_principal_data(const nlohmann::json& j, krb5_principal_data* principal_data)
+{
+    return replace_json(j, principal_data);
 }
 
 bool KRB5KerberosSerializer::deserialize_data(const nlohmann::json& j, krb5_data* data)
 {
-    if (!data || !j.contains("magic") || !j.contains("length") || !j.contains("data"))
+    return replace_json(j, data);
+}
+
+bool KRB5KerberosSerializer::deserialize_keyblock(const nlohmann::json& j, krb5_keyblock* keyblock)
+{
+    return replace_json(j, keyblock);
+}
+
+bool KRB5KerberosSerializer::deserialize_times(const nlohmann::json& j, krb5_ticket_times* times)
+{
+    return replace_json(j, times);
+}
+
+bool KRB5KerberosSerializer::deserialize_address(const nlohmann::json& j, krb5_address* address)
+{
+    return replace_json(j, address);
+}
+
+bool KRB5KerberosSerializer::deserialize_authdata(const nlohmann::json& j, krb5_authdata* authdata)
+{
+    return replace_json(j, authdata);
+}
+
+bool KRB5KerberosSerializer::deserialize_creds(const nlohmann::json& j, krb5_creds* creds, krb5_context ctx)
+{
+    HeapSink heap;
+    auto success = false;
+    if (!creds)
     {
         return false;
     }
-    if (data->data && data->length > 0)
+    krb5_free_cred_contents(ctx, creds);
+    std::memset(reinterpret_cast<void*>(creds), 0, sizeof(krb5_creds));
+    try
     {
-        std::memset(reinterpret_cast<void*>(data->data), 0, data->length);
-        SAFE_FREE(data->data);
+        success = read_json(heap, j, creds);
     }
-    data->magic = j["magic"];
-    data->length = j["length"];
-    const auto decoded = encryption::Base64::base64_decode(j["data"].get<std::string>());
-    data->data = reinterpret_cast<char*>(calloc(decoded.size(), sizeof(char)));
-    std::memcpy(data->data, decoded.c_str(), decoded.size());
-    return true;
+    catch (...)
+    {
+        krb5_free_cred_contents(ctx, creds);
+        std::memset(reinterpret_cast<void*>(creds), 0, sizeof(krb5_creds));
+        throw;
+    }
+    if (!success)
+    {
+        krb5_free_cred_contents(ctx, creds);
+        std::memset(reinterpret_cast<void*>(creds), 0, sizeof(krb5_creds));
+    }
+    return success;
 }
 
-bool KRB5KerberosSerializer::deserialize_keyblock(const nlohmann::json& j, krb5_keyblock* keyblock)
+void KRB5KerberosSerializer::serialize_creds_binary(const krb5_creds& creds, std::string* out)
 {
-    if (!keyblock || !j.contains("magic") || !j.contains("enctype") || !j.contains("length") || !j.contains("contents"))
+    KRB5KerberosByteWriter writer(out);
+    writer.write_u8(CREDS_BINARY_VERSION);
+    write_binary(writer, creds);
+}
+
+std::string KRB5KerberosSerializer::serialize_creds_binary(const krb5_creds& creds)
+{
+    std::string out;
+    out.reserve(creds.ticket.length + 512);
+    serialize_creds_binary(creds, &out);
+    return out;
+}
+
+bool KRB5KerberosSerializer::deserialize_creds_binary(std::string_view data, krb5_creds* creds, krb5_context ctx)
+{
+    HeapSink heap;
+    if (!creds)
     {
         return false;
     }
-    if (keyblock->contents && keyblock->length > 0)
+    krb5_free_cred_contents(ctx, creds);
+    std::memset(reinterpret_cast<void*>(creds), 0, sizeof(krb5_creds));
+    if (!read_binary_creds(heap, data, creds))
     {
-        std::memset(reinterpret_cast<void*>(keyblock->contents), 0, keyblock->length);
-        SAFE_FREE(keyblock->contents);
+        krb5_free_cred_contents(ctx, creds);
+        std::memset(reinterpret_cast<void*>(creds), 0, sizeof(krb5_creds));
+        return false;
     }
-    keyblock->magic = j["magic"];
-    keyblock->enctype = j["enctype"];
-    keyblock->length = j["length"];
-    const auto decoded = encryption::Base64::base64_decode(j["contents"].get<std::string>());
-    keyblock->contents = reinterpret_cast<krb5_octet*>(calloc(decoded.size(), sizeof(krb5_octet)));
-    std::memcpy(keyblock->contents, decoded.c_str(), decoded.size());
     return true;
 }
 
-bool KRB5KerberosSerializer::deserialize_times(const nlohmann::json& j, krb5_ticket_times* times)
+std::string KRB5KerberosSerializer::serialize_ticket_binary(
+    KerberosTicket::Type type,
+    std::string_view name,
+    const std::chrono::time_point<std::chrono::system_clock>& expiration,
+    const krb5_creds& creds)
 {
-    if (!times || !j.contains("authtime") || !j.contains("starttime") || !j.contains("endtime")
-        || !j.contains("renew_till"))
+    std::string out;
+    out.reserve(creds.ticket.length + name.size() + 512);
+    KRB5KerberosByteWriter writer(&out);
+    writer.write_bytes(TICKET_BINARY_MAGIC, sizeof(TICKET_BINARY_MAGIC));
+    writer.write_u8(TICKET_BINARY_VERSION);
+    writer.write_u8(static_cast<std::uint8_t>(type));
+    writer.write_counted(name);
+    writer.write_u64(std::chrono::duration_cast<std::chrono::seconds>(expiration.time_since_epoch()).count());
+    // Length prefix the creds so readers can skip them without parsing
+    const auto length_offset = out.size();
+    writer.write_u32(0);
+    serialize_creds_binary(creds, &out);
+    const auto length = static_cast<std::uint32_t>(out.size() - length_offset - sizeof(std::uint32_t));
+    std::string length_bytes;
+    KRB5KerberosByteWriter(&length_bytes).write_u32(length);
+    out.replace(length_offset, length_bytes.size(), length_bytes);
+    return out;
+}
+
+bool KRB5KerberosSerializer::split_ticket_binary(std::string_view data,
+                                                 KerberosTicket::Type type,
+                                                 std::string_view* name,
+                                                 std::chrono::time_point<std::chrono::system_clock>* expiration,
+                                                 std::string_view* creds)
+{
+    KRB5KerberosByteReader reader(data);
+    std::string_view magic;
+    std::uint8_t version, ticket_type;
+    std::uint64_t expiration_seconds;
+    if (!reader.read_bytes(sizeof(TICKET_BINARY_MAGIC), &magic)
+        || magic != std::string_view(TICKET_BINARY_MAGIC, sizeof(TICKET_BINARY_MAGIC)) || !reader.read_u8(&version)
+        || version != TICKET_BINARY_VERSION || !reader.read_u8(&ticket_type)
+        || ticket_type != static_cast<std::uint8_t>(type) || !reader.read_counted(name)
+        || !reader.read_u64(&expiration_seconds) || !reader.read_counted(creds) || reader.remaining() != 0)
     {
         return false;
     }
-    times->authtime = j["authtime"];
-    times->starttime = j["starttime"];
-    times->endtime = j["endtime"];
-    times->renew_till = j["renew_till"];
+    *expiration = std::chrono::time_point<std::chrono::system_clock>(
+        std::chrono::seconds(static_cast<std::int64_t>(expiration_seconds)));
     return true;
 }
 
-bool KRB5KerberosSerializer::deserialize_address(const nlohmann::json& j, krb5_address* address)
+bool KRB5KerberosSerializer::deserialize_ticket_binary(std::string_view data,
+                                                       KerberosTicket::Type type,
+                                                       std::string* name,
+                                                       std::chrono::time_point<std::chrono::system_clock>* expiration,
+                                                       krb5_creds* creds,
+                                                       krb5_context ctx)
 {
-    if (!address || !j.contains("magic") || !j.contains("addrtype") || !j.contains("length") || !j.contains("contents"))
+    std::string_view name_view, creds_view;
+    std::chrono::time_point<std::chrono::system_clock> expiration_value;
+    if (!split_ticket_binary(data, type, &name_view, &expiration_value, &creds_view)
+        || !deserialize_creds_binary(creds_view, creds, ctx))
     {
         return false;
     }
-    if (address->contents && address->length > 0)
-    {
-        std::memset(reinterpret_cast<void*>(address->contents), 0, address->length);
-        SAFE_FREE(address->contents);
-    }
-    address->magic = j["magic"];
-    address->addrtype = j["addrtype"];
-    address->length = j["length"];
-    const auto decoded = encryption::Base64::base64_decode(j["contents"].get<std::string>());
-    address->contents = reinterpret_cast<krb5_octet*>(calloc(decoded.size(), sizeof(krb5_octet)));
-    std::memcpy(address->contents, decoded.c_str(), decoded.size());
+    *name = std::string(name_view);
+    *expiration = expiration_value;
     return true;
 }
 
-bool KRB5KerberosSerializer::deserialize_authdata(const nlohmann::json& j, krb5_authdata* authdata)
+bool KRB5KerberosSerializer::deserialize_creds_text(std::string_view text, krb5_creds* creds, krb5_context ctx)
 {
-    if (!authdata || !j.contains("magic") || !j.contains("ad_type") || !j.contains("length") || !j.contains("contents"))
+    if (!creds)
     {
         return false;
     }
-    if (authdata->contents && authdata->length > 0)
+    krb5_free_cred_contents(ctx, creds);
+    std::memset(reinterpret_cast<void*>(creds), 0, sizeof(krb5_creds));
+    TextReader<krb5_creds> reader(creds);
+    if (!text_document(text,
+                       [&reader](std::string_view key, ondemand::value& field) { return reader.field(key, field); })
+        || !reader.finish())
     {
-        std::memset(reinterpret_cast<void*>(authdata->contents), 0, authdata->length);
-        SAFE_FREE(authdata->contents);
+        krb5_free_cred_contents(ctx, creds);
+        std::memset(reinterpret_cast<void*>(creds), 0, sizeof(krb5_creds));
+        return false;
     }
-    authdata->magic = j["magic"];
-    authdata->ad_type = j["ad_type"];
-    authdata->length = j["length"];
-    const auto decoded = encryption::Base64::base64_decode(j["contents"].get<std::string>());
-    authdata->contents = reinterpret_cast<krb5_octet*>(calloc(decoded.size(), sizeof(krb5_octet)));
-    std::memcpy(authdata->contents, decoded.c_str(), decoded.size());
     return true;
 }
 
-void KRB5KerberosSerializer::cleanup_creds(krb5_creds* creds)
+bool KRB5KerberosSerializer::deserialize_ticket_text(std::string_view text,
+                                                     KerberosTicket::Type type,
+                                                     std::string* name,
+                                                     std::chrono::time_point<std::chrono::system_clock>* expiration,
+                                                     krb5_creds* creds,
+                                                     krb5_context ctx)
 {
-    if (creds->client)
+    const auto is_tgt = type == KerberosTicket::Type::TicketGrantingTicket;
+    const std::string_view name_key = is_tgt ? "tgt_user" : "service";
+    const std::string_view creds_key = is_tgt ? "tgt_ticket" : "service_ticket";
+    const std::string_view expiration_key = is_tgt ? "tgt_expiration" : "service_ticket_expiration";
+    if (!creds)
     {
-        SAFE_FREE(creds->client->data);
-        SAFE_FREE(creds->client);
+        return false;
     }
-    if (creds->server)
+    krb5_free_cred_contents(ctx, creds);
+    std::memset(reinterpret_cast<void*>(creds), 0, sizeof(krb5_creds));
+
+    std::uint32_t seen = 0;
+    std::string_view name_value;
+    std::int64_t expiration_seconds = 0;
+    const auto success = text_document(text, [&](std::string_view key, ondemand::value& field) {
+        if (key == name_key)
+        {
+            seen |= TEXT_NAME;
+            return !field.get_string().get(name_value);
+        }
+        if (key == creds_key)
+        {
+            if (mark_seen(&seen, TEXT_CREDS))
+            {
+                krb5_free_cred_contents(ctx, creds);
+                std::memset(reinterpret_cast<void*>(creds), 0, sizeof(krb5_creds));
+            }
+            return text_value(field, creds);
+        }
+        if (key == expiration_key)
+        {
+            seen |= TEXT_EXPIRATION;
+            return text_number(field, &expiration_seconds);
+        }
+        return true;
+    });
+    if (!success || seen != (TEXT_NAME | TEXT_CREDS | TEXT_EXPIRATION))
     {
-        SAFE_FREE(creds->server->data);
-        SAFE_FREE(creds->server);
+        krb5_free_cred_contents(ctx, creds);
+        std::memset(reinterpret_cast<void*>(creds), 0, sizeof(krb5_creds));
+        return false;
     }
-    if (creds->keyblock.contents)
+    *name = std::string(name_value);
+    *expiration = std::chrono::time_point<std::chrono::system_clock>(std::chrono::seconds(expiration_seconds));
+    return true;
+}
+
+bool KRB5KerberosSerializer::peek_ticket_text(std::string_view text,
+                                              KerberosTicket::Type type,
+                                              KRB5KerberosTicketHeader* header)
+{
+    const auto is_tgt = type == KerberosTicket::Type::TicketGrantingTicket;
+    const std::string_view name_key = is_tgt ? "tgt_user" : "service";
+    const std::string_view creds_key = is_tgt ? "tgt_ticket" : "service_ticket";
+    const std::string_view expiration_key = is_tgt ? "tgt_expiration" : "service_ticket_expiration";
+    if (!header)
     {
-        SAFE_FREE(creds->keyblock.contents);
+        return false;
     }
-    if (creds->addresses)
-    {
-        auto curr_addr = creds->addresses;
-        while (*curr_addr)
+    *header = KRB5KerberosTicketHeader{};
+
+    std::uint32_t seen = 0;
+    std::string_view name;
+    std::int64_t expiration_seconds = 0;
+    const auto success = text_document(text, [&](std::string_view key, ondemand::value& field) {
+        if (key == name_key)
         {
-            SAFE_FREE(*curr_addr);
-            ++curr_addr;
+            seen |= TEXT_NAME;
+            return !field.get_string().get(name);
         }
-        SAFE_FREE(creds->addresses);
-    }
-    if (creds->ticket.data)
+        if (key == expiration_key)
+        {
+            seen |= TEXT_EXPIRATION;
+            return text_number(field, &expiration_seconds);
+        }
+        if (key != creds_key)
+        {
+            return true;
+        }
+        // Only the last creds count, keeping none of what earlier ones held
+        if (mark_seen(&seen, TEXT_CREDS))
+        {
+            seen &= ~(TEXT_CLIENT | TEXT_SERVER | TEXT_TIMES | TEXT_TICKET_FLAGS);
+            header->client.clear();
+            header->server.clear();
+            header->times = {};
+            header->ticket_flags = 0;
+        }
+        // Everything else in the creds, blobs included, is skipped by the parser without being decoded
+        return text_object(field, [&](std::string_view field_key, ondemand::value& creds_field) {
+            if (field_key == "client")
+            {
+                seen |= TEXT_CLIENT;
+                return peek_text_principal(creds_field, &header->client);
+            }
+            if (field_key == "server")
+            {
+                seen |= TEXT_SERVER;
+                return peek_text_principal(creds_field, &header->server);
+            }
+            if (field_key == "times")
+            {
+                seen |= TEXT_TIMES;
+                header->times = {};
+                return text_value(creds_field, &header->times);
+            }
+            if (field_key == "ticket_flags")
+            {
+                seen |= TEXT_TICKET_FLAGS;
+                return text_number(creds_field, &header->ticket_flags);
+            }
+            return true;
+        });
+    });
+    const auto required = TEXT_NAME | TEXT_EXPIRATION | TEXT_CREDS | TEXT_TIMES | TEXT_TICKET_FLAGS;
+    if (!success || (seen & required) != required)
     {
-        SAFE_FREE(creds->ticket.data);
+        return false;
     }
-    if (creds->second_ticket.data)
+    header->name = std::string(name);
+    header->expiration = std::chrono::time_point<std::chrono::system_clock>(std::chrono::seconds(expiration_seconds));
+    return true;
+}
+
+bool KRB5KerberosSerializer::peek_ticket_binary(std::string_view data,
+                                                KerberosTicket::Type type,
+                                                KRB5KerberosTicketHeader* header)
+{
+    std::string_view name, creds;
+    std::chrono::time_point<std::chrono::system_clock> expiration;
+    if (!header || !split_ticket_binary(data, type, &name, &expiration, &creds))
     {
-        SAFE_FREE(creds->second_ticket.data);
+        return false;
     }
-    if (creds->authdata)
+    *header = KRB5KerberosTicketHeader{};
+
+    // The creds start with every field the header needs, reading stops right after the ticket flags
+    KRB5KerberosByteReader reader(creds);
+    std::uint8_t version, present, is_skey;
+    std::uint32_t magic;
+    std::string_view keyblock;
+    if (!reader.read_u8(&version) || version != CREDS_BINARY_VERSION || !reader.read_u32(&magic)
+        || !reader.read_u8(&present)
+        || ((present & CREDS_HAS_CLIENT) && !peek_binary_principal(reader, &header->client))
+        || ((present & CREDS_HAS_SERVER) && !peek_binary_principal(reader, &header->server))
+        || !reader.read_u32(&magic) || !reader.read_u32(&magic) || !reader.read_counted(&keyblock)
+        || !read_i32(reader, &header->times.authtime) || !read_i32(reader, &header->times.starttime)
+        || !read_i32(reader, &header->times.endtime) || !read_i32(reader, &header->times.renew_till)
+        || !reader.read_u8(&is_skey) || !read_i32(reader, &header->ticket_flags))
     {
-        auto curr_authdata = creds->authdata;
-        while (*curr_authdata)
-        {
-            SAFE_FREE(*curr_authdata);
-            ++curr_authdata;
-        }
-        SAFE_FREE(creds->authdata);
+        return false;
     }
+    header->name = std::string(name);
+    header->expiration = expiration;
+    return true;
 }
 
-bool KRB5KerberosSerializer::deserialize_creds(const nlohmann::json& j, krb5_creds* creds, krb5_context ctx)
+krb5_creds* KRB5KerberosSerializer::deserialize_creds_contiguous(const nlohmann::json& j)
+{
+    return build_contiguous_creds([&j](auto& sink, krb5_creds* creds) { return read_json(sink, j, creds); });
+}
+
+krb5_creds* KRB5KerberosSerializer::deserialize_creds_binary_contiguous(std::string_view data)
 {
-    if (!creds || !j.contains("magic") || !j.contains("keyblock") || !j.contains("times") || !j.contains("is_skey")
-        || !j.contains("ticket_flags") || !j.contains("ticket") || !j.contains("second_ticket"))
+    return build_contiguous_creds(
+        [data](auto& sink, krb5_creds* creds) { return read_binary_creds(sink, data, creds); });
+}
+
+void KRB5KerberosSerializer::free_creds_contiguous(krb5_creds* creds)
+{
+    if (!creds)
     {
-        return false;
+        return;
     }
-    creds->magic = j["magic"];
-    if (creds->client)
+    auto block = reinterpret_cast<char*>(creds) - CONTIGUOUS_HEADER_SIZE;
+    zeroize(block, reinterpret_cast<ContiguousHeader*>(block)->size);
+    free(block);
+}
+
+void KRB5KerberosSerializer::serialize_ccache_creds(const krb5_creds& creds, std::string* out)
+{
+    KRB5KerberosByteWriter writer(out);
+    const krb5_principal_data empty_principal{};
+    write_ccache_principal(writer, creds.client ? *creds.client : empty_principal);
+    write_ccache_principal(writer, creds.server ? *creds.server : empty_principal);
+    writer.write_u16(static_cast<std::uint16_t>(creds.keyblock.enctype));
+    writer.write_counted(creds.keyblock.contents, creds.keyblock.length);
+    writer.write_u32(creds.times.authtime);
+    writer.write_u32(creds.times.starttime);
+    writer.write_u32(creds.times.endtime);
+    writer.write_u32(creds.times.renew_till);
+    writer.write_u8(creds.is_skey ? 1 : 0);
+    writer.write_u32(creds.ticket_flags);
+    std::uint32_t count = 0;
+    while (creds.addresses && creds.addresses[count])
     {
-        krb5_free_principal(ctx, creds->client);
+        ++count;
     }
-    creds->client = nullptr;
-    if (j.contains("client"))
+    writer.write_u32(count);
+    for (std::uint32_t i = 0; i < count; ++i)
     {
-        creds->client = reinterpret_cast<krb5_principal_data*>(calloc(1, sizeof(krb5_principal_data)));
-        if (!KRB5KerberosSerializer::deserialize_principal_data(j["client"], creds->client))
-        {
-            cleanup_creds(creds);
-            return false;
-        }
+        writer.write_u16(static_cast<std::uint16_t>(creds.addresses[i]->addrtype));
+        writer.write_counted(creds.addresses[i]->contents, creds.addresses[i]->length);
     }
-    if (creds->server)
+    count = 0;
+    while (creds.authdata && creds.authdata[count])
     {
-        krb5_free_principal(ctx, creds->server);
+        ++count;
     }
-    creds->server = nullptr;
-    if (j.contains("server"))
+    writer.write_u32(count);
+    for (std::uint32_t i = 0; i < count; ++i)
     {
-        creds->server = reinterpret_cast<krb5_principal_data*>(calloc(1, sizeof(krb5_principal_data)));
-        if (!KRB5KerberosSerializer::deserialize_principal_data(j["server"], creds->server))
-        {
-            cleanup_creds(creds);
-            return false;
-        }
+        writer.write_u16(static_cast<std::uint16_t>(creds.authdata[i]->ad_type));
+        writer.write_counted(creds.authdata[i]->contents, creds.authdata[i]->length);
     }
-    if (!KRB5KerberosSerializer::deserialize_keyblock(j["keyblock"], &creds->keyblock))
+    writer.write_counted(creds.ticket.data, creds.ticket.length);
+    writer.write_counted(creds.second_ticket.data, creds.second_ticket.length);
+}
+
+bool KRB5KerberosSerializer::deserialize_ccache_creds(std::string_view data, krb5_creds* creds, krb5_context ctx)
+{
+    if (!creds)
     {
-        cleanup_creds(creds);
         return false;
     }
-    if (!KRB5KerberosSerializer::deserialize_times(j["times"], &creds->times))
+    krb5_free_cred_contents(ctx, creds);
+    std::memset(reinterpret_cast<void*>(creds), 0, sizeof(krb5_creds));
+    KRB5KerberosByteReader reader(data);
+    if (!read_ccache_creds(reader, creds, CCACHE_VERSION_4) || reader.remaining() != 0)
     {
-        cleanup_creds(creds);
+        krb5_free_cred_contents(ctx, creds);
+        std::memset(reinterpret_cast<void*>(creds), 0, sizeof(krb5_creds));
         return false;
     }
-    creds->is_skey = j["is_skey"];
-    creds->ticket_flags = j["ticket_flags"];
-    if (creds->addresses)
-    {
-        krb5_free_addresses(ctx, creds->addresses);
-    }
-    creds->addresses = nullptr;
-    if (j.contains("addresses"))
+    return true;
+}
+
+std::string KRB5KerberosSerializer::serialize_ccache(const krb5_principal_data& default_principal,
+                                                     const std::vector<const krb5_creds*>& creds)
+{
+    std::string out;
+    KRB5KerberosByteWriter writer(&out);
+    writer.write_u16(CCACHE_VERSION_4);
+    // No header fields, libkrb5 only writes the kdc time offset when one was negotiated
+    writer.write_u16(0);
+    write_ccache_principal(writer, default_principal);
+    for (const auto curr_creds : creds)
     {
-        const std::vector<nlohmann::json> j_addresses = j["addresses"];
-        creds->addresses = reinterpret_cast<krb5_address**>(calloc(j_addresses.size() + 1, sizeof(krb5_address*)));
-        creds->addresses[j_addresses.size()] = nullptr;
-        for (auto i = 0; i < j_addresses.size(); ++i)
+        if (curr_creds)
         {
-            creds->addresses[i] = reinterpret_cast<krb5_address*>(calloc(1, sizeof(krb5_address)));
-            if (!KRB5KerberosSerializer::deserialize_address(j_addresses[i], creds->addresses[i]))
-            {
-                cleanup_creds(creds);
-                return false;
-            }
+            serialize_ccache_creds(*curr_creds, &out);
         }
     }
-    if (!KRB5KerberosSerializer::deserialize_data(j["ticket"], &creds->ticket)
-        || !KRB5KerberosSerializer::deserialize_data(j["second_ticket"], &creds->second_ticket))
+    return out;
+}
+
+bool KRB5KerberosSerializer::deserialize_ccache(std::string_view data,
+                                                krb5_principal* default_principal,
+                                                std::vector<krb5_creds>* creds,
+                                                krb5_context ctx)
+{
+    if (!default_principal || !creds)
+    {
+        return false;
+    }
+    KRB5KerberosByteReader reader(data);
+    std::uint16_t version, header_length;
+    if (!reader.read_u16(&version) || (version != CCACHE_VERSION_3 && version != CCACHE_VERSION_4))
+    {
+        return false;
+    }
+    if (version == CCACHE_VERSION_4 && (!reader.read_u16(&header_length) || !reader.skip(header_length)))
     {
-        cleanup_creds(creds);
         return false;
     }
-    if (creds->authdata)
+    *default_principal = nullptr;
+    if (!read_ccache_principal(reader, default_principal))
     {
-        krb5_free_authdata(ctx, creds->authdata);
+        krb5_free_principal(ctx, *default_principal);
+        *default_principal = nullptr;
+        return false;
     }
-    creds->authdata = nullptr;
-    if (j.contains("authdata"))
+    const auto first_creds = creds->size();
+    while (reader.remaining() > 0)
     {
-        const std::vector<nlohmann::json> j_authdata = j["authdata"];
-        creds->authdata = reinterpret_cast<krb5_authdata**>(calloc(j_authdata.size() + 1, sizeof(krb5_authdata*)));
-        creds->authdata[j_authdata.size()] = nullptr;
-        for (auto i = 0; i < j_authdata.size(); ++i)
+        auto& curr_creds = creds->emplace_back();
+        std::memset(reinterpret_cast<void*>(&curr_creds), 0, sizeof(krb5_creds));
+        if (!read_ccache_creds(reader, &curr_creds, version))
         {
-            creds->authdata[i] = reinterpret_cast<krb5_authdata*>(calloc(1, sizeof(krb5_authdata)));
-            if (!KRB5KerberosSerializer::deserialize_authdata(j_authdata[i], creds->authdata[i]))
+            for (auto i = first_creds; i < creds->size(); ++i)
             {
-                cleanup_creds(creds);
-                return false;
+                krb5_free_cred_contents(ctx, &(*creds)[i]);
             }
+            creds->resize(first_creds);
+            krb5_free_principal(ctx, *default_principal);
+            *default_principal = nullptr;
+            return false;
         }
     }
     return true;
 }
+
+bool KRB5KerberosSerializer::is_ccache_config_creds(const krb5_creds& creds)
+{
+    return creds.server && creds.server->realm.data
+           && std::string_view(creds.server->realm.data, creds.server->realm.length) == CCACHE_CONFIG_REALM;
+}
 } // namespace octo::kerberos::krb5
@@ -11,7 +11,8 @@
 
 #include "octo-kerberos-cpp/krb5/krb5-kerberos-service-ticket.hpp"
 #include "octo-kerberos-cpp/krb5/krb5-kerberos-serializer.hpp"
-#include <octo-encryption-cpp/base64.hpp>
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-slab-pool.hpp"
+#include <cassert>
 #include <fmt/format.h>
 
 namespace octo::kerberos::krb5
@@ -19,29 +20,30 @@ namespace octo::kerberos::krb5
 KRB5KerberosServiceTicket::KRB5KerberosServiceTicket(
     std::string service, const std::chrono::time_point<std::chrono::system_clock>& service_ticket_expiration)
     : service_(std::move(service)),
-      service_ticket_(nullptr),
       service_ticket_expiration_(service_ticket_expiration),
-      ctx_(nullptr)
+      ctx_(nullptr),
+      contiguous_(false)
 {
 }
 
-KRB5KerberosServiceTicket::~KRB5KerberosServiceTicket()
+encryption::SecureString KRB5KerberosServiceTicket::ticket() const
 {
-    if (service_ticket_)
-    {
-        krb5_free_creds(ctx_, service_ticket_);
-    }
+    return {std::string(ticket_view())};
 }
 
-encryption::SecureString KRB5KerberosServiceTicket::ticket() const
+encryption::SecureString KRB5KerberosServiceTicket::encoded_ticket() const
 {
-    return {std::string(service_ticket_->ticket.data, service_ticket_->ticket.length)};
+    return {std::string(encoded_ticket_view())};
 }
 
-encryption::SecureString KRB5KerberosServiceTicket::encoded_ticket() const
+std::string_view KRB5KerberosServiceTicket::ticket_view() const
 {
-    return {
-        encryption::Base64::base64_encode(std::string(service_ticket_->ticket.data, service_ticket_->ticket.length))};
+    return {service_ticket_->ticket.data, service_ticket_->ticket.length};
+}
+
+std::string_view KRB5KerberosServiceTicket::encoded_ticket_view() const
+{
+    return service_ticket_.encoded_ticket();
 }
 
 std::string KRB5KerberosServiceTicket::ticket_purpose() const
@@ -59,6 +61,22 @@ const std::chrono::time_point<std::chrono::system_clock>& KRB5KerberosServiceTic
     return service_ticket_expiration_;
 }
 
+void* KRB5KerberosServiceTicket::operator new([[maybe_unused]] std::size_t size)
+{
+    assert(size == sizeof(KRB5KerberosServiceTicket));
+    return KRB5KerberosSlabPool::of<KRB5KerberosServiceTicket>().allocate();
+}
+
+void KRB5KerberosServiceTicket::operator delete(void* ptr) noexcept
+{
+    KRB5KerberosSlabPool::of<KRB5KerberosServiceTicket>().deallocate(ptr);
+}
+
+std::unique_ptr<KerberosTicket> KRB5KerberosServiceTicket::clone() const
+{
+    return std::make_unique<KRB5KerberosServiceTicket>(*this);
+}
+
 nlohmann::json KRB5KerberosServiceTicket::serialize() const
 {
     nlohmann::json j;
@@ -69,6 +87,31 @@ nlohmann::json KRB5KerberosServiceTicket::serialize() const
     return j;
 }
 
+void KRB5KerberosServiceTicket::serialize_to(KRB5KerberosJsonWriter* writer) const
+{
+    writer->begin_object();
+    writer->key("service");
+    writer->value_string(service_);
+    writer->key("service_ticket");
+    KRB5KerberosSerializer::serialize_creds(*service_ticket_, writer);
+    writer->key("service_ticket_expiration");
+    writer->value_int(
+        std::chrono::duration_cast<std::chrono::seconds>(service_ticket_expiration_.time_since_epoch()).count());
+    writer->end_object();
+}
+
+void KRB5KerberosServiceTicket::serialize_to(std::string* out) const
+{
+    KRB5KerberosJsonWriter writer(out);
+    serialize_to(&writer);
+}
+
+void KRB5KerberosServiceTicket::serialize_to(std::ostream& out) const
+{
+    KRB5KerberosJsonWriter writer(out);
+    serialize_to(&writer);
+}
+
 bool KRB5KerberosServiceTicket::deserialize(const nlohmann::json& json)
 {
     if (!json.contains("service") || !json.contains("service_ticket") || !json.contains("service_ticket_expiration"))
@@ -76,20 +119,80 @@ bool KRB5KerberosServiceTicket::deserialize(const nlohmann::json& json)
         return false;
     }
     service_ = json["service"];
-    if (service_ticket_)
+    if (contiguous_)
     {
-        krb5_free_creds(ctx_, service_ticket_);
+        service_ticket_ =
+            KRB5KerberosCredsPtr::adopt(KRB5KerberosSerializer::deserialize_creds_contiguous(json["service_ticket"]),
+                                        ctx_,
+                                        KRB5KerberosCreds::Allocation::Contiguous);
+        if (!service_ticket_)
+        {
+            return false;
+        }
     }
-    service_ticket_ = reinterpret_cast<krb5_creds*>(calloc(1, sizeof(krb5_creds)));
-    if (!KRB5KerberosSerializer::deserialize_creds(json["service_ticket"], service_ticket_, ctx_))
+    else
     {
-        return false;
+        auto service_ticket = service_ticket_.replace(ctx_);
+        if (!service_ticket
+            || !KRB5KerberosSerializer::deserialize_creds(json["service_ticket"], service_ticket, ctx_))
+        {
+            return false;
+        }
     }
     service_ticket_expiration_ =
         std::chrono::time_point<std::chrono::system_clock>(std::chrono::seconds(json["service_ticket_expiration"]));
     return true;
 }
 
+bool KRB5KerberosServiceTicket::deserialize_text(std::string_view text)
+{
+    if (contiguous_)
+    {
+        // The contiguous layout is measured before it is filled, which needs the whole document at hand
+        const auto json = nlohmann::json::parse(text, nullptr, false);
+        return !json.is_discarded() && deserialize(json);
+    }
+    auto service_ticket = service_ticket_.replace(ctx_);
+    return service_ticket
+           && KRB5KerberosSerializer::deserialize_ticket_text(
+               text, KerberosTicket::Type::ServiceTicket, &service_, &service_ticket_expiration_, service_ticket, ctx_);
+}
+
+std::string KRB5KerberosServiceTicket::serialize_binary() const
+{
+    return KRB5KerberosSerializer::serialize_ticket_binary(
+        KerberosTicket::Type::ServiceTicket, service_, service_ticket_expiration_, *service_ticket_);
+}
+
+bool KRB5KerberosServiceTicket::deserialize_binary(std::string_view data)
+{
+    if (contiguous_)
+    {
+        std::string_view service, creds;
+        std::chrono::time_point<std::chrono::system_clock> expiration;
+        if (!KRB5KerberosSerializer::split_ticket_binary(
+                data, KerberosTicket::Type::ServiceTicket, &service, &expiration, &creds))
+        {
+            return false;
+        }
+        service_ticket_ =
+            KRB5KerberosCredsPtr::adopt(KRB5KerberosSerializer::deserialize_creds_binary_contiguous(creds),
+                                        ctx_,
+                                        KRB5KerberosCreds::Allocation::Contiguous);
+        if (!service_ticket_)
+        {
+            return false;
+        }
+        service_ = std::string(service);
+        service_ticket_expiration_ = expiration;
+        return true;
+    }
+    auto service_ticket = service_ticket_.replace(ctx_);
+    return service_ticket
+           && KRB5KerberosSerializer::deserialize_ticket_binary(
+               data, KerberosTicket::Type::ServiceTicket, &service_, &service_ticket_expiration_, service_ticket, ctx_);
+}
+
 std::string KRB5KerberosServiceTicket::service() const
 {
     return service_;
@@ -99,4 +202,9 @@ krb5_context KRB5KerberosServiceTicket::krb_context() const
 {
     return ctx_;
 }
+
+const krb5_creds& KRB5KerberosServiceTicket::krb_creds() const
+{
+    return *service_ticket_;
+}
 } // namespace octo::kerberos::krb5
@@ -0,0 +1,261 @@
+/**
+ * @file krb5-kerberos-slab-pool.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-slab-pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace octo::kerberos::krb5
+{
+struct KRB5KerberosSlabPool::Block
+{
+    Block* next;
+};
+
+namespace
+{
+std::atomic<KRB5KerberosSlabPool*> pools[KRB5KerberosSlabPool::MAX_POOLS];
+std::atomic<std::size_t> pool_count(0);
+
+// Called through a volatile pointer so the wipe of a block about to be reused is not optimized away
+void zeroize(void* block, std::size_t size)
+{
+    static void* (*const volatile memset_function)(void*, int, std::size_t) = std::memset;
+    memset_function(block, 0, size);
+}
+} // namespace
+
+#ifndef KRB5_KERBEROS_DISABLE_SLAB_POOL
+namespace
+{
+// Set once the cache of an exiting thread is gone, blocks released after that go straight to the depot
+thread_local bool is_thread_cache_destroyed = false;
+} // namespace
+
+struct KRB5KerberosSlabPool::ThreadCache
+{
+    Block* heads[MAX_POOLS] = {};
+    std::size_t counts[MAX_POOLS] = {};
+
+    ~ThreadCache();
+};
+
+KRB5KerberosSlabPool::ThreadCache::~ThreadCache()
+{
+    is_thread_cache_destroyed = true;
+    for (std::size_t id = 0; id < MAX_POOLS; ++id)
+    {
+        if (!heads[id])
+        {
+            continue;
+        }
+        auto tail = heads[id];
+        while (tail->next)
+        {
+            tail = tail->next;
+        }
+        pools[id].load(std::memory_order_acquire)->give_batch(heads[id], tail, counts[id]);
+    }
+}
+
+KRB5KerberosSlabPool::ThreadCache* KRB5KerberosSlabPool::thread_cache()
+{
+    if (is_thread_cache_destroyed)
+    {
+        return nullptr;
+    }
+    static thread_local ThreadCache cache;
+    return &cache;
+}
+#endif
+
+KRB5KerberosSlabPool::KRB5KerberosSlabPool(std::size_t block_size)
+    : block_size_((std::max(block_size, sizeof(Block)) + alignof(std::max_align_t) - 1)
+                  / alignof(std::max_align_t) * alignof(std::max_align_t)),
+      id_(MAX_POOLS),
+      depot_(nullptr),
+      depot_blocks_(0),
+      slabs_(0)
+{
+}
+
+KRB5KerberosSlabPool* KRB5KerberosSlabPool::create(std::size_t block_size)
+{
+    // Never destroyed, tickets may still be released by static destructors or exiting threads
+    auto pool = new KRB5KerberosSlabPool(block_size);
+    const auto id = pool_count.fetch_add(1, std::memory_order_relaxed);
+    if (id < MAX_POOLS)
+    {
+        pool->id_ = id;
+        pools[id].store(pool, std::memory_order_release);
+    }
+    return pool;
+}
+
+KRB5KerberosSlabPool::Block* KRB5KerberosSlabPool::take_batch(std::size_t* count)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (depot_)
+    {
+        auto head = depot_;
+        auto tail = head;
+        *count = 1;
+        while (tail->next && *count < SLAB_BLOCKS)
+        {
+            tail = tail->next;
+            ++*count;
+        }
+        depot_ = tail->next;
+        depot_blocks_ -= *count;
+        tail->next = nullptr;
+        return head;
+    }
+    auto slab = static_cast<char*>(::operator new(block_size_ * SLAB_BLOCKS, std::nothrow));
+    if (!slab)
+    {
+        *count = 0;
+        return nullptr;
+    }
+    std::memset(slab, 0, block_size_ * SLAB_BLOCKS);
+    for (std::size_t i = 0; i + 1 < SLAB_BLOCKS; ++i)
+    {
+        reinterpret_cast<Block*>(slab + i * block_size_)->next = reinterpret_cast<Block*>(slab + (i + 1) * block_size_);
+    }
+    ++slabs_;
+    *count = SLAB_BLOCKS;
+    return reinterpret_cast<Block*>(slab);
+}
+
+void KRB5KerberosSlabPool::give_batch(Block* head, Block* tail, std::size_t count)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    tail->next = depot_;
+    depot_ = head;
+    depot_blocks_ += count;
+}
+
+void* KRB5KerberosSlabPool::allocate()
+{
+    auto block = allocate(std::nothrow);
+    if (!block)
+    {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void* KRB5KerberosSlabPool::allocate(const std::nothrow_t&) noexcept
+{
+#ifdef KRB5_KERBEROS_DISABLE_SLAB_POOL
+    auto block = ::operator new(block_size_, std::nothrow);
+    if (block)
+    {
+        std::memset(block, 0, block_size_);
+    }
+    return block;
+#else
+    Block* block;
+    auto cache = id_ < MAX_POOLS ? thread_cache() : nullptr;
+    if (cache)
+    {
+        auto& head = cache->heads[id_];
+        if (!head)
+        {
+            head = take_batch(&cache->counts[id_]);
+            if (!head)
+            {
+                return nullptr;
+            }
+        }
+        block = head;
+        head = block->next;
+        --cache->counts[id_];
+    }
+    else
+    {
+        std::size_t count;
+        block = take_batch(&count);
+        if (!block)
+        {
+            return nullptr;
+        }
+        if (block->next)
+        {
+            auto tail = block->next;
+            while (tail->next)
+            {
+                tail = tail->next;
+            }
+            give_batch(block->next, tail, count - 1);
+        }
+    }
+    // Free blocks are zeroed apart from the link
+    block->next = nullptr;
+    return block;
+#endif
+}
+
+void KRB5KerberosSlabPool::deallocate(void* block) noexcept
+{
+    if (!block)
+    {
+        return;
+    }
+    zeroize(block, block_size_);
+#ifdef KRB5_KERBEROS_DISABLE_SLAB_POOL
+    ::operator delete(block);
+#else
+    auto free_block = static_cast<Block*>(block);
+    auto cache = id_ < MAX_POOLS ? thread_cache() : nullptr;
+    if (!cache)
+    {
+        free_block->next = nullptr;
+        give_batch(free_block, free_block, 1);
+        return;
+    }
+    auto& head = cache->heads[id_];
+    auto& count = cache->counts[id_];
+    free_block->next = head;
+    head = free_block;
+    if (++count <= THREAD_CACHE_BLOCKS)
+    {
+        return;
+    }
+    // Keep the most recently released half, they are the likeliest to still be in cache
+    auto tail = head;
+    for (std::size_t i = 1; i < THREAD_CACHE_BLOCKS / 2; ++i)
+    {
+        tail = tail->next;
+    }
+    auto spilled = tail->next;
+    tail->next = nullptr;
+    auto spilled_tail = spilled;
+    while (spilled_tail->next)
+    {
+        spilled_tail = spilled_tail->next;
+    }
+    give_batch(spilled, spilled_tail, count - THREAD_CACHE_BLOCKS / 2);
+    count = THREAD_CACHE_BLOCKS / 2;
+#endif
+}
+
+std::size_t KRB5KerberosSlabPool::block_size() const
+{
+    return block_size_;
+}
+
+std::size_t KRB5KerberosSlabPool::slabs() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slabs_;
+}
+} // namespace octo::kerberos::krb5
@@ -11,25 +11,36 @@
 
 #include "octo-kerberos-cpp/krb5/krb5-kerberos-tgt-ticket.hpp"
 #include "octo-kerberos-cpp/krb5/krb5-kerberos-serializer.hpp"
-#include <octo-encryption-cpp/base64.hpp>
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-slab-pool.hpp"
+#include <cassert>
 #include <fmt/format.h>
 
 namespace octo::kerberos::krb5
 {
 KRB5KerberosTGTTicket::KRB5KerberosTGTTicket(std::string tgt_user,
                                              const std::chrono::time_point<std::chrono::system_clock>& tgt_expiration)
-    : tgt_user_(std::move(tgt_user)), tgt_ticket_({}), tgt_expiration_(tgt_expiration), ctx_(nullptr)
+    : tgt_user_(std::move(tgt_user)), tgt_expiration_(tgt_expiration), ctx_(nullptr)
 {
 }
 
 encryption::SecureString KRB5KerberosTGTTicket::ticket() const
 {
-    return {std::string(tgt_ticket_.ticket.data, tgt_ticket_.ticket.length)};
+    return {std::string(ticket_view())};
 }
 
 encryption::SecureString KRB5KerberosTGTTicket::encoded_ticket() const
 {
-    return {encryption::Base64::base64_encode(std::string(tgt_ticket_.ticket.data, tgt_ticket_.ticket.length))};
+    return {std::string(encoded_ticket_view())};
+}
+
+std::string_view KRB5KerberosTGTTicket::ticket_view() const
+{
+    return {tgt_ticket_->ticket.data, tgt_ticket_->ticket.length};
+}
+
+std::string_view KRB5KerberosTGTTicket::encoded_ticket_view() const
+{
+    return tgt_ticket_.encoded_ticket();
 }
 
 std::string KRB5KerberosTGTTicket::ticket_purpose() const
@@ -47,15 +58,55 @@ const std::chrono::time_point<std::chrono::system_clock>& KRB5KerberosTGTTicket:
     return tgt_expiration_;
 }
 
+void* KRB5KerberosTGTTicket::operator new([[maybe_unused]] std::size_t size)
+{
+    assert(size == sizeof(KRB5KerberosTGTTicket));
+    return KRB5KerberosSlabPool::of<KRB5KerberosTGTTicket>().allocate();
+}
+
+void KRB5KerberosTGTTicket::operator delete(void* ptr) noexcept
+{
+    KRB5KerberosSlabPool::of<KRB5KerberosTGTTicket>().deallocate(ptr);
+}
+
+std::unique_ptr<KerberosTicket> KRB5KerberosTGTTicket::clone() const
+{
+    return std::make_unique<KRB5KerberosTGTTicket>(*this);
+}
+
 nlohmann::json KRB5KerberosTGTTicket::serialize() const
 {
     nlohmann::json j;
     j["tgt_user"] = tgt_user_;
-    j["tgt_ticket"] = KRB5KerberosSerializer::serialize_creds(tgt_ticket_);
+    j["tgt_ticket"] = KRB5KerberosSerializer::serialize_creds(*tgt_ticket_);
     j["tgt_expiration"] = std::chrono::duration_cast<std::chrono::seconds>(tgt_expiration_.time_since_epoch()).count();
     return j;
 }
 
+void KRB5KerberosTGTTicket::serialize_to(KRB5KerberosJsonWriter* writer) const
+{
+    writer->begin_object();
+    writer->key("tgt_expiration");
+    writer->value_int(std::chrono::duration_cast<std::chrono::seconds>(tgt_expiration_.time_since_epoch()).count());
+    writer->key("tgt_ticket");
+    KRB5KerberosSerializer::serialize_creds(*tgt_ticket_, writer);
+    writer->key("tgt_user");
+    writer->value_string(tgt_user_);
+    writer->end_object();
+}
+
+void KRB5KerberosTGTTicket::serialize_to(std::string* out) const
+{
+    KRB5KerberosJsonWriter writer(out);
+    serialize_to(&writer);
+}
+
+void KRB5KerberosTGTTicket::serialize_to(std::ostream& out) const
+{
+    KRB5KerberosJsonWriter writer(out);
+    serialize_to(&writer);
+}
+
 bool KRB5KerberosTGTTicket::deserialize(const nlohmann::json& json)
 {
     if (!json.contains("tgt_user") || !json.contains("tgt_ticket") || !json.contains("tgt_expiration"))
@@ -63,7 +114,8 @@ bool KRB5KerberosTGTTicket::deserialize(const nlohmann::json& json)
         return false;
     }
     tgt_user_ = json["tgt_user"];
-    if (!KRB5KerberosSerializer::deserialize_creds(json["tgt_ticket"], &tgt_ticket_, ctx_))
+    auto tgt_ticket = tgt_ticket_.replace(ctx_);
+    if (!tgt_ticket || !KRB5KerberosSerializer::deserialize_creds(json["tgt_ticket"], tgt_ticket, ctx_))
     {
         return false;
     }
@@ -71,6 +123,28 @@ bool KRB5KerberosTGTTicket::deserialize(const nlohmann::json& json)
     return true;
 }
 
+bool KRB5KerberosTGTTicket::deserialize_text(std::string_view text)
+{
+    auto tgt_ticket = tgt_ticket_.replace(ctx_);
+    return tgt_ticket
+           && KRB5KerberosSerializer::deserialize_ticket_text(
+               text, KerberosTicket::Type::TicketGrantingTicket, &tgt_user_, &tgt_expiration_, tgt_ticket, ctx_);
+}
+
+std::string KRB5KerberosTGTTicket::serialize_binary() const
+{
+    return KRB5KerberosSerializer::serialize_ticket_binary(
+        KerberosTicket::Type::TicketGrantingTicket, tgt_user_, tgt_expiration_, *tgt_ticket_);
+}
+
+bool KRB5KerberosTGTTicket::deserialize_binary(std::string_view data)
+{
+    auto tgt_ticket = tgt_ticket_.replace(ctx_);
+    return tgt_ticket
+           && KRB5KerberosSerializer::deserialize_ticket_binary(
+               data, KerberosTicket::Type::TicketGrantingTicket, &tgt_user_, &tgt_expiration_, tgt_ticket, ctx_);
+}
+
 std::string KRB5KerberosTGTTicket::tgt_user() const
 {
     return tgt_user_;
@@ -80,4 +154,9 @@ krb5_context KRB5KerberosTGTTicket::krb_context() const
 {
     return ctx_;
 }
+
+const krb5_creds& KRB5KerberosTGTTicket::krb_creds() const
+{
+    return *tgt_ticket_;
+}
 } // namespace octo::kerberos::krb5
@@ -0,0 +1,116 @@
+/**
+ * @file krb5-kerberos-thread-pool.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-thread-pool.hpp"
+#include <algorithm>
+
+namespace octo::kerberos::krb5
+{
+KRB5KerberosThreadPool::KRB5KerberosThreadPool(std::size_t threads)
+    : job_(nullptr),
+      count_(0),
+      chunk_size_(1),
+      next_(0),
+      active_workers_(0),
+      generation_(0),
+      is_stopping_(false)
+{
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threads - 1);
+    for (std::size_t i = 1; i < threads; ++i)
+    {
+        workers_.emplace_back(&KRB5KerberosThreadPool::worker_loop, this);
+    }
+}
+
+KRB5KerberosThreadPool::~KRB5KerberosThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_stopping_ = true;
+    }
+    wake_cv_.notify_all();
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void KRB5KerberosThreadPool::worker_loop()
+{
+    std::uint64_t generation = 0;
+    while (true)
+    {
+        const Job* job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_cv_.wait(lock, [this, generation]() { return is_stopping_ || generation_ != generation; });
+            if (is_stopping_)
+            {
+                return;
+            }
+            generation = generation_;
+            job = job_;
+        }
+        run_chunks(*job);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--active_workers_ == 0)
+        {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void KRB5KerberosThreadPool::run_chunks(const Job& job)
+{
+    for (auto begin = next_.fetch_add(chunk_size_); begin < count_; begin = next_.fetch_add(chunk_size_))
+    {
+        job(begin, std::min(begin + chunk_size_, count_));
+    }
+}
+
+std::size_t KRB5KerberosThreadPool::threads() const
+{
+    return workers_.size() + 1;
+}
+
+void KRB5KerberosThreadPool::parallel_for(std::size_t count, std::size_t chunk_size, const Job& job)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    chunk_size = std::max<std::size_t>(chunk_size, 1);
+    if (workers_.empty() || count <= chunk_size)
+    {
+        job(0, count);
+        return;
+    }
+    std::lock_guard<std::mutex> loop_lock(loop_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &job;
+        count_ = count;
+        chunk_size_ = chunk_size;
+        next_ = 0;
+        active_workers_ = workers_.size();
+        ++generation_;
+    }
+    wake_cv_.notify_all();
+    run_chunks(job);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() { return active_workers_ == 0; });
+    job_ = nullptr;
+}
+} // namespace octo::kerberos::krb5
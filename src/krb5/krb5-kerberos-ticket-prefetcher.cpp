@@ -0,0 +1,308 @@
+/**
+ * @file krb5-kerberos-ticket-prefetcher.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-ticket-prefetcher.hpp"
+
+namespace octo::kerberos::krb5
+{
+KRB5KerberosTicketPrefetcher::KRB5KerberosTicketPrefetcher(KRB5KerberosTicketPrefetcher::Settings settings,
+                                                           const KRB5KerberosTGTTicket& tgt)
+    : settings_(std::move(settings)),
+      logger_("KRB5KerberosTicketPrefetcher"),
+      tgt_(tgt),
+      next_id_(0),
+      is_running_(false),
+      hits_(0),
+      stale_hits_(0),
+      misses_(0),
+      refreshes_(0),
+      refresh_failures_(0),
+      evictions_(0),
+      timers_([this](KRB5KerberosTimerWheel::Handle timer, std::uint64_t id) { on_timer(timer, id); },
+              std::chrono::milliseconds(DEFAULT_KERBEROS_TIMER_WHEEL_TICK_MS),
+              settings_.refresh_margin)
+{
+}
+
+KRB5KerberosTicketPrefetcher::~KRB5KerberosTicketPrefetcher()
+{
+    stop();
+}
+
+void KRB5KerberosTicketPrefetcher::refresh_loop()
+{
+    while (true)
+    {
+        std::uint64_t id;
+        {
+            std::unique_lock<std::mutex> lock(refresh_mutex_);
+            refresh_cv_.wait(lock, [this]() { return !is_running_ || !refresh_queue_.empty(); });
+            if (!is_running_)
+            {
+                return;
+            }
+            id = refresh_queue_.front();
+            refresh_queue_.pop_front();
+        }
+
+        std::string service;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            const auto it = entries_.find(id);
+            if (it == entries_.end() || it->second.phase != Phase::Refreshing)
+            {
+                continue;
+            }
+            service = it->second.service;
+        }
+
+        // The cached ticket keeps being served while the replacement is fetched. The refresh authenticator stores the
+        // tgt in its ccache before its first exchange, and again once update_tgt replaced it
+        const auto krb5_tgt = tgt();
+        auto ticket = refresh_authenticator_->generate_service_ticket(
+            &krb5_tgt, service, settings_.service_ticket_lifetime);
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        const auto it = entries_.find(id);
+        if (it == entries_.end() || it->second.phase != Phase::Refreshing)
+        {
+            continue;
+        }
+        if (ticket)
+        {
+            refreshes_.fetch_add(1, std::memory_order_relaxed);
+            store(service, std::move(ticket));
+            continue;
+        }
+        refresh_failures_.fetch_add(1, std::memory_order_relaxed);
+        logger_.warning(settings_.authenticator.session_id)
+            .formatted("Failed refreshing the service ticket of [{}], serving the cached one until it expires",
+                       service);
+        schedule(&it->second, it->second.ticket->ticket_expiration_time(), Phase::Expiring);
+    }
+}
+
+void KRB5KerberosTicketPrefetcher::on_timer(KRB5KerberosTimerWheel::Handle timer, std::uint64_t id)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const auto it = entries_.find(id);
+    // A timer that fired while being replaced is stale
+    if (it == entries_.end() || it->second.timer != timer)
+    {
+        return;
+    }
+    auto& entry = it->second;
+    entry.timer = 0;
+    const auto expiration = entry.ticket->ticket_expiration_time();
+    if (entry.phase == Phase::Fresh && is_running_
+        && entry.accesses.load(std::memory_order_relaxed) >= settings_.hot_threshold)
+    {
+        entry.phase = Phase::Refreshing;
+        {
+            std::lock_guard<std::mutex> refresh_lock(refresh_mutex_);
+            refresh_queue_.push_back(id);
+        }
+        refresh_cv_.notify_one();
+        return;
+    }
+    if (entry.phase == Phase::Expiring || expiration <= std::chrono::system_clock::now())
+    {
+        index_.erase(entry.service);
+        entries_.erase(it);
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    schedule(&entry, expiration, Phase::Expiring);
+}
+
+void KRB5KerberosTicketPrefetcher::store(const std::string& service, KRB5KerberosServiceTicketUniquePtr ticket)
+{
+    Entry* entry;
+    const auto it = index_.find(service);
+    if (it != index_.end())
+    {
+        entry = &entries_.find(it->second)->second;
+    }
+    else
+    {
+        const auto id = next_id_++;
+        entry = &entries_[id];
+        entry->id = id;
+        entry->service = service;
+        entry->phase = Phase::Fresh;
+        entry->timer = 0;
+        index_.emplace(entry->service, id);
+    }
+
+    if (!entry->ticket || ticket->ticket_expiration_time() > entry->ticket->ticket_expiration_time())
+    {
+        entry->ticket = std::move(ticket);
+        entry->accesses.store(0, std::memory_order_relaxed);
+        schedule(entry, entry->ticket->ticket_expiration_time() - settings_.refresh_margin, Phase::Fresh);
+    }
+    else if (entry->phase == Phase::Refreshing)
+    {
+        // The kdc handed out nothing newer, refreshing again would not help
+        schedule(entry, entry->ticket->ticket_expiration_time(), Phase::Expiring);
+    }
+}
+
+void KRB5KerberosTicketPrefetcher::schedule(KRB5KerberosTicketPrefetcher::Entry* entry,
+                                            const std::chrono::time_point<std::chrono::system_clock>& deadline,
+                                            KRB5KerberosTicketPrefetcher::Phase phase)
+{
+    if (entry->timer)
+    {
+        (void)timers_.cancel(entry->timer);
+    }
+    entry->timer = timers_.schedule(deadline, entry->id);
+    entry->phase = phase;
+}
+
+KRB5KerberosTGTTicket KRB5KerberosTicketPrefetcher::tgt() const
+{
+    // Copies share the creds, see KRB5KerberosCredsPtr
+    std::lock_guard<std::mutex> lock(tgt_mutex_);
+    return tgt_;
+}
+
+bool KRB5KerberosTicketPrefetcher::start()
+{
+    std::lock_guard<std::mutex> lock(refresh_mutex_);
+    if (is_running_)
+    {
+        return true;
+    }
+    refresh_authenticator_ = std::make_unique<KRB5KerberosAuthenticator>(settings_.authenticator);
+    if (!refresh_authenticator_->initialize_authenticator())
+    {
+        logger_.error(settings_.authenticator.session_id).formatted("Failed initializing the refresh authenticator");
+        refresh_authenticator_.reset();
+        return false;
+    }
+    is_running_ = true;
+    refresh_thread_ = std::thread(&KRB5KerberosTicketPrefetcher::refresh_loop, this);
+    timers_.start();
+    return true;
+}
+
+void KRB5KerberosTicketPrefetcher::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(refresh_mutex_);
+        if (!is_running_.exchange(false))
+        {
+            return;
+        }
+        refresh_queue_.clear();
+    }
+    refresh_cv_.notify_all();
+    timers_.stop();
+    if (refresh_thread_.joinable())
+    {
+        refresh_thread_.join();
+    }
+    refresh_authenticator_.reset();
+
+    // Entries whose refresh was dropped are left to expire
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (auto& [id, entry] : entries_)
+    {
+        if (entry.phase == Phase::Refreshing)
+        {
+            entry.phase = Phase::Expiring;
+        }
+    }
+}
+
+bool KRB5KerberosTicketPrefetcher::is_running() const
+{
+    return is_running_;
+}
+
+KRB5KerberosServiceTicketUniquePtr KRB5KerberosTicketPrefetcher::get(KRB5KerberosAuthenticator* authenticator,
+                                                                     const std::string& service)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        const auto it = index_.find(service);
+        if (it != index_.end())
+        {
+            auto& entry = entries_.find(it->second)->second;
+            if (entry.ticket->ticket_expiration_time() > std::chrono::system_clock::now())
+            {
+                entry.accesses.fetch_add(1, std::memory_order_relaxed);
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                if (entry.phase == Phase::Refreshing)
+                {
+                    stale_hits_.fetch_add(1, std::memory_order_relaxed);
+                }
+                return std::make_unique<KRB5KerberosServiceTicket>(*entry.ticket);
+            }
+        }
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    if (!authenticator)
+    {
+        return nullptr;
+    }
+    const auto krb5_tgt = tgt();
+    auto ticket = authenticator->generate_service_ticket(&krb5_tgt, service, settings_.service_ticket_lifetime);
+    if (!ticket)
+    {
+        return nullptr;
+    }
+    auto copy = std::make_unique<KRB5KerberosServiceTicket>(*ticket);
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    store(service, std::move(ticket));
+    return copy;
+}
+
+void KRB5KerberosTicketPrefetcher::update_tgt(const KRB5KerberosTGTTicket& tgt)
+{
+    std::lock_guard<std::mutex> lock(tgt_mutex_);
+    tgt_ = tgt;
+}
+
+void KRB5KerberosTicketPrefetcher::erase(const std::string& service)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const auto it = index_.find(service);
+    if (it == index_.end())
+    {
+        return;
+    }
+    const auto entry = entries_.find(it->second);
+    if (entry->second.timer)
+    {
+        (void)timers_.cancel(entry->second.timer);
+    }
+    index_.erase(it);
+    entries_.erase(entry);
+}
+
+std::size_t KRB5KerberosTicketPrefetcher::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return entries_.size();
+}
+
+KRB5KerberosTicketPrefetcher::Statistics KRB5KerberosTicketPrefetcher::statistics() const
+{
+    return Statistics{hits_.load(std::memory_order_relaxed),
+                      stale_hits_.load(std::memory_order_relaxed),
+                      misses_.load(std::memory_order_relaxed),
+                      refreshes_.load(std::memory_order_relaxed),
+                      refresh_failures_.load(std::memory_order_relaxed),
+                      evictions_.load(std::memory_order_relaxed)};
+}
+} // namespace octo::kerberos::krb5
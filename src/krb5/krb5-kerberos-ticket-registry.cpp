@@ -0,0 +1,435 @@
+/**
+ * @file krb5-kerberos-ticket-registry.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-ticket-registry.hpp"
+#include <algorithm>
+
+#if defined(KRB5_KERBEROS_CPU_X86)
+#include <immintrin.h>
+#elif defined(KRB5_KERBEROS_CPU_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+using octo::kerberos::krb5::KRB5KerberosCpuDispatch;
+using octo::kerberos::krb5::KRB5KerberosTicketRegistry;
+typedef KRB5KerberosTicketRegistry::Handle Handle;
+
+// Flips the sign bit so unsigned timestamps order correctly under the signed vector compares
+constexpr const std::uint32_t SIGN_BIT = 0x80000000u;
+
+struct Columns
+{
+    const std::uint32_t* endtimes;
+    const std::uint32_t* renew_tills;
+    const std::uint32_t* flags;
+    const Handle* handles;
+    std::size_t count;
+};
+
+/**
+ * Every implementation only scans whole vectors and returns how many slots it consumed, the scalar scanner finishes
+ * what is left. Expiring matches endtime < before, renewable additionally requires the renewable flag and
+ * renew_till > now.
+ */
+struct Scanner
+{
+    KRB5KerberosTicketRegistry::Implementation implementation;
+    std::size_t (*expiring_blocks)(const Columns& columns, std::uint32_t before, std::vector<Handle>* handles);
+    std::size_t (*renewable_blocks)(const Columns& columns,
+                                    std::uint32_t now,
+                                    std::uint32_t before,
+                                    std::vector<Handle>* handles);
+};
+
+std::size_t expiring_blocks_scalar(const Columns&, std::uint32_t, std::vector<Handle>*)
+{
+    return 0;
+}
+
+std::size_t renewable_blocks_scalar(const Columns&, std::uint32_t, std::uint32_t, std::vector<Handle>*)
+{
+    return 0;
+}
+
+void expiring_scalar(const Columns& columns, std::size_t i, std::uint32_t before, std::vector<Handle>* handles)
+{
+    for (; i < columns.count; ++i)
+    {
+        if (columns.endtimes[i] < before)
+        {
+            handles->push_back(columns.handles[i]);
+        }
+    }
+}
+
+void renewable_scalar(
+    const Columns& columns, std::size_t i, std::uint32_t now, std::uint32_t before, std::vector<Handle>* handles)
+{
+    for (; i < columns.count; ++i)
+    {
+        if ((columns.flags[i] & TKT_FLG_RENEWABLE) && columns.endtimes[i] < before && columns.renew_tills[i] > now)
+        {
+            handles->push_back(columns.handles[i]);
+        }
+    }
+}
+
+#if defined(KRB5_KERBEROS_CPU_X86) || defined(KRB5_KERBEROS_CPU_NEON)
+// Bit i of mask selects block[i]
+inline void append_matches(unsigned mask, const Handle* block, std::vector<Handle>* handles)
+{
+    while (mask)
+    {
+        handles->push_back(block[__builtin_ctz(mask)]);
+        mask &= mask - 1;
+    }
+}
+#endif
+
+#if defined(KRB5_KERBEROS_CPU_X86)
+// 4 slots per compare
+__attribute__((target("sse2"))) std::size_t expiring_blocks_sse2(const Columns& columns,
+                                                                 std::uint32_t before,
+                                                                 std::vector<Handle>* handles)
+{
+    const auto bias = _mm_set1_epi32(static_cast<int>(SIGN_BIT));
+    const auto limit = _mm_set1_epi32(static_cast<int>(before ^ SIGN_BIT));
+    std::size_t i = 0;
+    for (; i + 4 <= columns.count; i += 4)
+    {
+        const auto endtimes =
+            _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.endtimes + i)), bias);
+        const auto matches = _mm_cmpgt_epi32(limit, endtimes);
+        append_matches(_mm_movemask_ps(_mm_castsi128_ps(matches)), columns.handles + i, handles);
+    }
+    return i;
+}
+
+__attribute__((target("sse2"))) std::size_t renewable_blocks_sse2(const Columns& columns,
+                                                                  std::uint32_t now,
+                                                                  std::uint32_t before,
+                                                                  std::vector<Handle>* handles)
+{
+    const auto bias = _mm_set1_epi32(static_cast<int>(SIGN_BIT));
+    const auto limit = _mm_set1_epi32(static_cast<int>(before ^ SIGN_BIT));
+    const auto current = _mm_set1_epi32(static_cast<int>(now ^ SIGN_BIT));
+    const auto renewable = _mm_set1_epi32(TKT_FLG_RENEWABLE);
+    std::size_t i = 0;
+    for (; i + 4 <= columns.count; i += 4)
+    {
+        const auto endtimes =
+            _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.endtimes + i)), bias);
+        const auto renew_tills =
+            _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.renew_tills + i)), bias);
+        const auto flags = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.flags + i));
+        const auto matches = _mm_and_si128(
+            _mm_and_si128(_mm_cmpgt_epi32(limit, endtimes), _mm_cmpgt_epi32(renew_tills, current)),
+            _mm_cmpeq_epi32(_mm_and_si128(flags, renewable), renewable));
+        append_matches(_mm_movemask_ps(_mm_castsi128_ps(matches)), columns.handles + i, handles);
+    }
+    return i;
+}
+
+// 8 slots per compare
+__attribute__((target("avx2"))) std::size_t expiring_blocks_avx2(const Columns& columns,
+                                                                 std::uint32_t before,
+                                                                 std::vector<Handle>* handles)
+{
+    const auto bias = _mm256_set1_epi32(static_cast<int>(SIGN_BIT));
+    const auto limit = _mm256_set1_epi32(static_cast<int>(before ^ SIGN_BIT));
+    std::size_t i = 0;
+    for (; i + 8 <= columns.count; i += 8)
+    {
+        const auto endtimes =
+            _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.endtimes + i)), bias);
+        const auto matches = _mm256_cmpgt_epi32(limit, endtimes);
+        append_matches(_mm256_movemask_ps(_mm256_castsi256_ps(matches)), columns.handles + i, handles);
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) std::size_t renewable_blocks_avx2(const Columns& columns,
+                                                                  std::uint32_t now,
+                                                                  std::uint32_t before,
+                                                                  std::vector<Handle>* handles)
+{
+    const auto bias = _mm256_set1_epi32(static_cast<int>(SIGN_BIT));
+    const auto limit = _mm256_set1_epi32(static_cast<int>(before ^ SIGN_BIT));
+    const auto current = _mm256_set1_epi32(static_cast<int>(now ^ SIGN_BIT));
+    const auto renewable = _mm256_set1_epi32(TKT_FLG_RENEWABLE);
+    std::size_t i = 0;
+    for (; i + 8 <= columns.count; i += 8)
+    {
+        const auto endtimes =
+            _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.endtimes + i)), bias);
+        const auto renew_tills =
+            _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.renew_tills + i)), bias);
+        const auto flags = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.flags + i));
+        const auto matches = _mm256_and_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi32(limit, endtimes), _mm256_cmpgt_epi32(renew_tills, current)),
+            _mm256_cmpeq_epi32(_mm256_and_si256(flags, renewable), renewable));
+        append_matches(_mm256_movemask_ps(_mm256_castsi256_ps(matches)), columns.handles + i, handles);
+    }
+    return i;
+}
+#elif defined(KRB5_KERBEROS_CPU_NEON)
+constexpr const std::uint32_t LANE_BITS[4] = {1, 2, 4, 8};
+
+// 4 slots per compare, NEON compares unsigned lanes directly
+std::size_t expiring_blocks_neon(const Columns& columns, std::uint32_t before, std::vector<Handle>* handles)
+{
+    const auto lanes = vld1q_u32(LANE_BITS);
+    const auto limit = vdupq_n_u32(before);
+    std::size_t i = 0;
+    for (; i + 4 <= columns.count; i += 4)
+    {
+        const auto matches = vcltq_u32(vld1q_u32(columns.endtimes + i), limit);
+        append_matches(vaddvq_u32(vandq_u32(matches, lanes)), columns.handles + i, handles);
+    }
+    return i;
+}
+
+std::size_t renewable_blocks_neon(const Columns& columns,
+                                  std::uint32_t now,
+                                  std::uint32_t before,
+                                  std::vector<Handle>* handles)
+{
+    const auto lanes = vld1q_u32(LANE_BITS);
+    const auto limit = vdupq_n_u32(before);
+    const auto current = vdupq_n_u32(now);
+    const auto renewable = vdupq_n_u32(TKT_FLG_RENEWABLE);
+    std::size_t i = 0;
+    for (; i + 4 <= columns.count; i += 4)
+    {
+        const auto matches = vandq_u32(vandq_u32(vcltq_u32(vld1q_u32(columns.endtimes + i), limit),
+                                                 vcgtq_u32(vld1q_u32(columns.renew_tills + i), current)),
+                                       vtstq_u32(vld1q_u32(columns.flags + i), renewable));
+        append_matches(vaddvq_u32(vandq_u32(matches, lanes)), columns.handles + i, handles);
+    }
+    return i;
+}
+#endif
+
+constexpr const Scanner SCALAR_SCANNER{KRB5KerberosTicketRegistry::Implementation::Scalar, expiring_blocks_scalar,
+                                       renewable_blocks_scalar};
+#if defined(KRB5_KERBEROS_CPU_X86)
+constexpr const Scanner SSE2_SCANNER{KRB5KerberosTicketRegistry::Implementation::SSE2, expiring_blocks_sse2,
+                                     renewable_blocks_sse2};
+constexpr const Scanner AVX2_SCANNER{KRB5KerberosTicketRegistry::Implementation::AVX2, expiring_blocks_avx2,
+                                     renewable_blocks_avx2};
+#elif defined(KRB5_KERBEROS_CPU_NEON)
+constexpr const Scanner NEON_SCANNER{KRB5KerberosTicketRegistry::Implementation::NEON, expiring_blocks_neon,
+                                     renewable_blocks_neon};
+#endif
+
+constexpr const Scanner* const SCANNERS[] = {
+#if defined(KRB5_KERBEROS_CPU_X86)
+    &AVX2_SCANNER,
+    &SSE2_SCANNER,
+#elif defined(KRB5_KERBEROS_CPU_NEON)
+    &NEON_SCANNER,
+#endif
+    &SCALAR_SCANNER};
+
+KRB5KerberosCpuDispatch<Scanner>& dispatch()
+{
+    static KRB5KerberosCpuDispatch<Scanner> scanners(SCANNERS);
+    return scanners;
+}
+
+// krb5 timestamps are unsigned 32 bit seconds, times outside the range are clamped
+[[nodiscard]] std::uint32_t to_timestamp(const std::chrono::time_point<std::chrono::system_clock>& time)
+{
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+    return static_cast<std::uint32_t>(std::clamp<std::int64_t>(seconds, 0, UINT32_MAX));
+}
+
+[[nodiscard]] std::chrono::time_point<std::chrono::system_clock> from_timestamp(std::uint32_t timestamp)
+{
+    return std::chrono::time_point<std::chrono::system_clock>(std::chrono::seconds(timestamp));
+}
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+KRB5KerberosTicketRegistry::Implementation KRB5KerberosTicketRegistry::implementation()
+{
+    return dispatch().implementation();
+}
+
+const char* KRB5KerberosTicketRegistry::implementation_name(KRB5KerberosTicketRegistry::Implementation implementation)
+{
+    return KRB5KerberosCpu::implementation_name(implementation);
+}
+
+bool KRB5KerberosTicketRegistry::set_implementation(KRB5KerberosTicketRegistry::Implementation implementation)
+{
+    return dispatch().set_implementation(implementation);
+}
+
+KRB5KerberosTicketRegistry::Handle KRB5KerberosTicketRegistry::add(std::uint32_t endtime,
+                                                                   std::uint32_t renew_till,
+                                                                   std::uint32_t flags)
+{
+    Handle handle;
+    if (!free_handles_.empty())
+    {
+        handle = free_handles_.back();
+        free_handles_.pop_back();
+    }
+    else
+    {
+        handle = static_cast<Handle>(slots_.size());
+        slots_.push_back(NO_SLOT);
+    }
+    slots_[handle] = static_cast<std::uint32_t>(handles_.size());
+    endtimes_.push_back(endtime);
+    renew_tills_.push_back(renew_till);
+    flags_.push_back(flags);
+    handles_.push_back(handle);
+    return handle;
+}
+
+KRB5KerberosTicketRegistry::Handle KRB5KerberosTicketRegistry::add(const krb5_creds& creds)
+{
+    return add(static_cast<std::uint32_t>(creds.times.endtime),
+               static_cast<std::uint32_t>(creds.times.renew_till),
+               static_cast<std::uint32_t>(creds.ticket_flags));
+}
+
+KRB5KerberosTicketRegistry::Handle KRB5KerberosTicketRegistry::add(
+    const std::chrono::time_point<std::chrono::system_clock>& endtime,
+    const std::chrono::time_point<std::chrono::system_clock>& renew_till,
+    krb5_flags flags)
+{
+    return add(to_timestamp(endtime), to_timestamp(renew_till), static_cast<std::uint32_t>(flags));
+}
+
+bool KRB5KerberosTicketRegistry::update(Handle handle,
+                                        std::uint32_t endtime,
+                                        std::uint32_t renew_till,
+                                        std::uint32_t flags)
+{
+    if (!contains(handle))
+    {
+        return false;
+    }
+    const auto slot = slots_[handle];
+    endtimes_[slot] = endtime;
+    renew_tills_[slot] = renew_till;
+    flags_[slot] = flags;
+    return true;
+}
+
+bool KRB5KerberosTicketRegistry::update(Handle handle, const krb5_creds& creds)
+{
+    return update(handle,
+                  static_cast<std::uint32_t>(creds.times.endtime),
+                  static_cast<std::uint32_t>(creds.times.renew_till),
+                  static_cast<std::uint32_t>(creds.ticket_flags));
+}
+
+bool KRB5KerberosTicketRegistry::update(Handle handle,
+                                        const std::chrono::time_point<std::chrono::system_clock>& endtime,
+                                        const std::chrono::time_point<std::chrono::system_clock>& renew_till,
+                                        krb5_flags flags)
+{
+    return update(handle, to_timestamp(endtime), to_timestamp(renew_till), static_cast<std::uint32_t>(flags));
+}
+
+bool KRB5KerberosTicketRegistry::erase(Handle handle)
+{
+    if (!contains(handle))
+    {
+        return false;
+    }
+    // The last ticket takes the freed slot
+    const auto slot = slots_[handle];
+    const auto last = handles_.size() - 1;
+    endtimes_[slot] = endtimes_[last];
+    renew_tills_[slot] = renew_tills_[last];
+    flags_[slot] = flags_[last];
+    handles_[slot] = handles_[last];
+    slots_[handles_[slot]] = slot;
+    endtimes_.pop_back();
+    renew_tills_.pop_back();
+    flags_.pop_back();
+    handles_.pop_back();
+    slots_[handle] = NO_SLOT;
+    free_handles_.push_back(handle);
+    return true;
+}
+
+bool KRB5KerberosTicketRegistry::find(Handle handle, Entry* entry) const
+{
+    if (!contains(handle))
+    {
+        return false;
+    }
+    const auto slot = slots_[handle];
+    entry->endtime = from_timestamp(endtimes_[slot]);
+    entry->renew_till = from_timestamp(renew_tills_[slot]);
+    entry->flags = static_cast<krb5_flags>(flags_[slot]);
+    return true;
+}
+
+bool KRB5KerberosTicketRegistry::contains(Handle handle) const
+{
+    return handle < slots_.size() && slots_[handle] != NO_SLOT;
+}
+
+std::size_t KRB5KerberosTicketRegistry::size() const
+{
+    return handles_.size();
+}
+
+void KRB5KerberosTicketRegistry::reserve(std::size_t size)
+{
+    endtimes_.reserve(size);
+    renew_tills_.reserve(size);
+    flags_.reserve(size);
+    handles_.reserve(size);
+    slots_.reserve(size);
+}
+
+void KRB5KerberosTicketRegistry::clear()
+{
+    endtimes_.clear();
+    renew_tills_.clear();
+    flags_.clear();
+    handles_.clear();
+    slots_.clear();
+    free_handles_.clear();
+}
+
+void KRB5KerberosTicketRegistry::expiring(const std::chrono::time_point<std::chrono::system_clock>& before,
+                                          std::vector<Handle>* handles) const
+{
+    const Columns columns{endtimes_.data(), renew_tills_.data(), flags_.data(), handles_.data(), handles_.size()};
+    const auto limit = to_timestamp(before);
+    const auto consumed = dispatch().kernels().expiring_blocks(columns, limit, handles);
+    expiring_scalar(columns, consumed, limit, handles);
+}
+
+void KRB5KerberosTicketRegistry::renewable(const std::chrono::time_point<std::chrono::system_clock>& now,
+                                           const std::chrono::time_point<std::chrono::system_clock>& before,
+                                           std::vector<Handle>* handles) const
+{
+    const Columns columns{endtimes_.data(), renew_tills_.data(), flags_.data(), handles_.data(), handles_.size()};
+    const auto current = to_timestamp(now);
+    const auto limit = to_timestamp(before);
+    const auto consumed =
+        dispatch().kernels().renewable_blocks(columns, current, limit, handles);
+    renewable_scalar(columns, consumed, current, limit, handles);
+}
+} // namespace octo::kerberos::krb5
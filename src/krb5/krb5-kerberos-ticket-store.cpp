@@ -0,0 +1,693 @@
+/**
+ * @file krb5-kerberos-ticket-store.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-ticket-store.hpp"
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-byte-buffer.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+/**
+ * Data file (big endian): "OKKS", u16 version, then records of
+ *   u32 length, u8 type, u64 expiration seconds, counted client, counted service, counted ticket
+ * Index file (host byte order): IndexHeader followed by capacity IndexSlot entries, linear probing
+ */
+constexpr const char TICKET_STORE_MAGIC[] = {'O', 'K', 'K', 'S'};
+constexpr const std::uint16_t TICKET_STORE_VERSION = 1;
+constexpr const std::uint64_t TICKET_STORE_HEADER_SIZE = sizeof(TICKET_STORE_MAGIC) + sizeof(std::uint16_t);
+constexpr const std::uint8_t TICKET_STORE_RECORD_PUT = 1;
+constexpr const std::uint8_t TICKET_STORE_RECORD_ERASE = 2;
+constexpr const std::uint64_t TICKET_STORE_DATA_MAP_MIN_SIZE = 1 << 20;
+
+constexpr const char TICKET_STORE_INDEX_MAGIC[] = {'O', 'K', 'K', 'I'};
+constexpr const std::uint32_t TICKET_STORE_INDEX_BYTE_ORDER = 0x01020304;
+constexpr const std::uint64_t TICKET_STORE_INDEX_MIN_CAPACITY = 1024;
+constexpr const std::uint64_t TICKET_STORE_EMPTY_SLOT = 0;
+constexpr const std::uint64_t TICKET_STORE_TOMBSTONE_SLOT = UINT64_MAX;
+
+constexpr const std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr const std::uint64_t FNV_PRIME = 1099511628211ULL;
+
+struct IndexHeader
+{
+    char magic[4];
+    std::uint32_t byte_order;
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t capacity;
+    std::uint64_t count;
+    std::uint64_t tombstones;
+    // The prefix of the data file already reflected in the index, anything past it is replayed on open
+    std::uint64_t data_size;
+};
+
+struct IndexSlot
+{
+    std::uint64_t hash;
+    std::uint64_t offset;
+};
+
+IndexHeader* index_header(char* index_map)
+{
+    return reinterpret_cast<IndexHeader*>(index_map);
+}
+
+IndexSlot* index_slots(char* index_map)
+{
+    return reinterpret_cast<IndexSlot*>(index_map + sizeof(IndexHeader));
+}
+
+std::uint64_t index_file_size(std::uint64_t capacity)
+{
+    return sizeof(IndexHeader) + capacity * sizeof(IndexSlot);
+}
+
+// Covers no data, so replaying the whole data file on open, whichever data file that is
+IndexHeader empty_index_header(std::uint64_t capacity)
+{
+    IndexHeader header{};
+    std::memcpy(header.magic, TICKET_STORE_INDEX_MAGIC, sizeof(header.magic));
+    header.byte_order = TICKET_STORE_INDEX_BYTE_ORDER;
+    header.version = TICKET_STORE_VERSION;
+    header.capacity = capacity;
+    header.data_size = TICKET_STORE_HEADER_SIZE;
+    return header;
+}
+
+std::uint64_t fnv1a(std::uint64_t hash, std::string_view data)
+{
+    for (const auto c : data)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// Zero is reserved so an all zero slot always reads as empty
+std::uint64_t key_hash(std::string_view client, std::string_view service)
+{
+    const auto hash = fnv1a(fnv1a(fnv1a(FNV_OFFSET_BASIS, client), std::string_view("\0", 1)), service);
+    return hash ? hash : 1;
+}
+
+// Fails on a short file as well, since pread only reads less than asked at its end
+bool read_fully(int fd, char* data, std::size_t length, off_t offset)
+{
+    while (length > 0)
+    {
+        const auto read = pread(fd, data, length, offset);
+        if (read < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (read <= 0)
+        {
+            return false;
+        }
+        data += read;
+        length -= static_cast<std::size_t>(read);
+        offset += read;
+    }
+    return true;
+}
+
+bool write_fully(int fd, const char* data, std::size_t length, off_t offset)
+{
+    while (length > 0)
+    {
+        const auto written = pwrite(fd, data, length, offset);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= written;
+        offset += written;
+    }
+    return true;
+}
+
+bool write_empty_index(const std::string& path)
+{
+    auto fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        return false;
+    }
+    const auto header = empty_index_header(TICKET_STORE_INDEX_MIN_CAPACITY);
+    const auto success = ftruncate(fd, index_file_size(header.capacity)) == 0
+                         && write_fully(fd, reinterpret_cast<const char*>(&header), sizeof(header), 0)
+                         && fsync(fd) == 0;
+    ::close(fd);
+    return success;
+}
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+KRB5KerberosTicketStore::KRB5KerberosTicketStore()
+    : data_fd_(-1),
+      index_fd_(-1),
+      data_map_(nullptr),
+      data_map_size_(0),
+      data_size_(0),
+      index_map_(nullptr),
+      index_map_size_(0),
+      logger_("KRB5KerberosTicketStore")
+{
+}
+
+KRB5KerberosTicketStore::~KRB5KerberosTicketStore()
+{
+    close();
+}
+
+bool KRB5KerberosTicketStore::open(const std::string& path)
+{
+    close();
+    path_ = path;
+    data_fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (data_fd_ < 0)
+    {
+        logger_.warning().formatted("Failed opening ticket store [{}] [{}]", path_, std::strerror(errno));
+        return false;
+    }
+    struct stat data_stat
+    {
+    };
+    if (fstat(data_fd_, &data_stat) < 0)
+    {
+        close();
+        return false;
+    }
+    data_size_ = data_stat.st_size;
+    std::string header;
+    KRB5KerberosByteWriter writer(&header);
+    writer.write_bytes(TICKET_STORE_MAGIC, sizeof(TICKET_STORE_MAGIC));
+    writer.write_u16(TICKET_STORE_VERSION);
+    if (data_size_ == 0)
+    {
+        if (!write_fully(data_fd_, header.data(), header.size(), 0))
+        {
+            close();
+            return false;
+        }
+        data_size_ = header.size();
+    }
+    else
+    {
+        std::string existing(header.size(), '\0');
+        if (data_size_ < header.size() || !read_fully(data_fd_, existing.data(), existing.size(), 0)
+            || existing != header)
+        {
+            logger_.warning().formatted("Ticket store [{}] has an unsupported header", path_);
+            close();
+            return false;
+        }
+    }
+    if (!map_data(data_size_) || !open_index())
+    {
+        logger_.warning().formatted("Failed mapping ticket store [{}] [{}]", path_, std::strerror(errno));
+        close();
+        return false;
+    }
+    return true;
+}
+
+void KRB5KerberosTicketStore::close()
+{
+    if (index_map_)
+    {
+        munmap(index_map_, index_map_size_);
+        index_map_ = nullptr;
+        index_map_size_ = 0;
+    }
+    if (data_map_)
+    {
+        munmap(data_map_, data_map_size_);
+        data_map_ = nullptr;
+        data_map_size_ = 0;
+    }
+    if (index_fd_ != -1)
+    {
+        ::close(index_fd_);
+        index_fd_ = -1;
+    }
+    if (data_fd_ != -1)
+    {
+        ::close(data_fd_);
+        data_fd_ = -1;
+    }
+    data_size_ = 0;
+}
+
+bool KRB5KerberosTicketStore::is_open() const
+{
+    return data_map_ && index_map_;
+}
+
+bool KRB5KerberosTicketStore::map_data(std::uint64_t min_size)
+{
+    if (data_map_ && data_map_size_ >= min_size)
+    {
+        return true;
+    }
+    // The mapping may extend past the end of file, only the written prefix is ever touched
+    auto size = std::max<std::uint64_t>(TICKET_STORE_DATA_MAP_MIN_SIZE, data_map_size_);
+    while (size < min_size)
+    {
+        size *= 2;
+    }
+    if (data_map_)
+    {
+        munmap(data_map_, data_map_size_);
+        data_map_ = nullptr;
+        data_map_size_ = 0;
+    }
+    auto map = mmap(nullptr, size, PROT_READ, MAP_SHARED, data_fd_, 0);
+    if (map == MAP_FAILED)
+    {
+        return false;
+    }
+    data_map_ = static_cast<char*>(map);
+    data_map_size_ = size;
+    return true;
+}
+
+bool KRB5KerberosTicketStore::map_index(std::uint64_t capacity, bool reset)
+{
+    const auto size = index_file_size(capacity);
+    if (index_map_)
+    {
+        munmap(index_map_, index_map_size_);
+        index_map_ = nullptr;
+        index_map_size_ = 0;
+    }
+    if (reset && (ftruncate(index_fd_, 0) < 0 || ftruncate(index_fd_, size) < 0))
+    {
+        return false;
+    }
+    auto map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, index_fd_, 0);
+    if (map == MAP_FAILED)
+    {
+        return false;
+    }
+    index_map_ = static_cast<char*>(map);
+    index_map_size_ = size;
+    if (reset)
+    {
+        *index_header(index_map_) = empty_index_header(capacity);
+    }
+    return true;
+}
+
+bool KRB5KerberosTicketStore::open_index()
+{
+    index_fd_ = ::open((path_ + ".idx").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (index_fd_ < 0)
+    {
+        return false;
+    }
+    struct stat index_stat
+    {
+    };
+    IndexHeader header{};
+    auto is_valid = fstat(index_fd_, &index_stat) == 0 && index_stat.st_size >= 0
+                    && static_cast<std::uint64_t>(index_stat.st_size) >= sizeof(IndexHeader)
+                    && read_fully(index_fd_, reinterpret_cast<char*>(&header), sizeof(header), 0)
+                    && std::memcmp(header.magic, TICKET_STORE_INDEX_MAGIC, sizeof(header.magic)) == 0
+                    && header.byte_order == TICKET_STORE_INDEX_BYTE_ORDER && header.version == TICKET_STORE_VERSION
+                    && header.capacity >= TICKET_STORE_INDEX_MIN_CAPACITY
+                    && (header.capacity & (header.capacity - 1)) == 0
+                    && static_cast<std::uint64_t>(index_stat.st_size) == index_file_size(header.capacity)
+                    && header.data_size >= TICKET_STORE_HEADER_SIZE && header.data_size <= data_size_;
+    if (!is_valid)
+    {
+        logger_.info().formatted("Rebuilding ticket store index for [{}]", path_);
+    }
+    if (!map_index(is_valid ? header.capacity : TICKET_STORE_INDEX_MIN_CAPACITY, !is_valid))
+    {
+        return false;
+    }
+    return replay(index_header(index_map_)->data_size);
+}
+
+bool KRB5KerberosTicketStore::grow_index()
+{
+    const auto header = index_header(index_map_);
+    const auto slots = index_slots(index_map_);
+    std::vector<IndexSlot> live;
+    live.reserve(header->count);
+    for (std::uint64_t i = 0; i < header->capacity; ++i)
+    {
+        if (slots[i].offset != TICKET_STORE_EMPTY_SLOT && slots[i].offset != TICKET_STORE_TOMBSTONE_SLOT)
+        {
+            live.push_back(slots[i]);
+        }
+    }
+    const auto data_size = header->data_size;
+    auto capacity = header->capacity;
+    while (live.size() * 2 >= capacity)
+    {
+        capacity *= 2;
+    }
+    // A crash past this point leaves an empty index covering nothing, the next open replays the whole data file
+    if (!map_index(capacity, true))
+    {
+        return false;
+    }
+    const auto new_header = index_header(index_map_);
+    const auto new_slots = index_slots(index_map_);
+    const auto mask = capacity - 1;
+    for (const auto& slot : live)
+    {
+        auto i = slot.hash & mask;
+        while (new_slots[i].offset != TICKET_STORE_EMPTY_SLOT)
+        {
+            i = (i + 1) & mask;
+        }
+        new_slots[i] = slot;
+    }
+    new_header->count = live.size();
+    new_header->data_size = data_size;
+    return true;
+}
+
+bool KRB5KerberosTicketStore::replay(std::uint64_t offset)
+{
+    while (offset < data_size_)
+    {
+        std::uint8_t type;
+        View view;
+        std::uint64_t next;
+        if (!read_record(offset, &type, &view, &next))
+        {
+            // A torn append from a crashed writer, drop it so the next append starts on a record boundary
+            logger_.warning().formatted("Truncating ticket store [{}] at [{}] out of [{}] bytes",
+                                        path_, offset, data_size_);
+            if (ftruncate(data_fd_, offset) < 0)
+            {
+                return false;
+            }
+            data_size_ = offset;
+            break;
+        }
+        const auto hash = key_hash(view.client, view.service);
+        if (type == TICKET_STORE_RECORD_PUT)
+        {
+            if (!index_insert(hash, offset, view.client, view.service))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            index_erase(hash, view.client, view.service);
+        }
+        offset = next;
+    }
+    index_header(index_map_)->data_size = data_size_;
+    return true;
+}
+
+bool KRB5KerberosTicketStore::read_record(std::uint64_t offset,
+                                          std::uint8_t* type,
+                                          KRB5KerberosTicketStore::View* view,
+                                          std::uint64_t* next) const
+{
+    if (offset >= data_size_)
+    {
+        return false;
+    }
+    KRB5KerberosByteReader reader(std::string_view(data_map_ + offset, data_size_ - offset));
+    std::uint32_t length;
+    std::string_view record_data;
+    if (!reader.read_u32(&length) || !reader.read_bytes(length, &record_data))
+    {
+        return false;
+    }
+    KRB5KerberosByteReader record(record_data);
+    std::uint64_t expiration;
+    if (!record.read_u8(type) || (*type != TICKET_STORE_RECORD_PUT && *type != TICKET_STORE_RECORD_ERASE)
+        || !record.read_u64(&expiration) || !record.read_counted(&view->client)
+        || !record.read_counted(&view->service) || !record.read_counted(&view->ticket) || record.remaining() != 0)
+    {
+        return false;
+    }
+    view->expiration = std::chrono::time_point<std::chrono::system_clock>(
+        std::chrono::seconds(static_cast<std::int64_t>(expiration)));
+    *next = offset + reader.position();
+    return true;
+}
+
+bool KRB5KerberosTicketStore::index_insert(std::uint64_t hash,
+                                           std::uint64_t offset,
+                                           std::string_view client,
+                                           std::string_view service)
+{
+    auto header = index_header(index_map_);
+    // Keep the load factor, tombstones included, under 70%
+    if ((header->count + header->tombstones + 1) * 10 > header->capacity * 7)
+    {
+        if (!grow_index())
+        {
+            return false;
+        }
+        header = index_header(index_map_);
+    }
+    const auto slots = index_slots(index_map_);
+    const auto mask = header->capacity - 1;
+    auto tombstone = header->capacity;
+    for (auto i = hash & mask;; i = (i + 1) & mask)
+    {
+        auto& slot = slots[i];
+        if (slot.offset == TICKET_STORE_EMPTY_SLOT)
+        {
+            if (tombstone != header->capacity)
+            {
+                --header->tombstones;
+                i = tombstone;
+            }
+            slots[i] = IndexSlot{hash, offset};
+            ++header->count;
+            return true;
+        }
+        if (slot.offset == TICKET_STORE_TOMBSTONE_SLOT)
+        {
+            if (tombstone == header->capacity)
+            {
+                tombstone = i;
+            }
+            continue;
+        }
+        std::uint8_t type;
+        View view;
+        std::uint64_t next;
+        if (slot.hash == hash && read_record(slot.offset, &type, &view, &next) && view.client == client
+            && view.service == service)
+        {
+            slot.offset = offset;
+            return true;
+        }
+    }
+}
+
+void KRB5KerberosTicketStore::index_erase(std::uint64_t hash, std::string_view client, std::string_view service)
+{
+    const auto header = index_header(index_map_);
+    const auto slots = index_slots(index_map_);
+    const auto mask = header->capacity - 1;
+    for (auto i = hash & mask; slots[i].offset != TICKET_STORE_EMPTY_SLOT; i = (i + 1) & mask)
+    {
+        auto& slot = slots[i];
+        std::uint8_t type;
+        View view;
+        std::uint64_t next;
+        if (slot.offset != TICKET_STORE_TOMBSTONE_SLOT && slot.hash == hash
+            && read_record(slot.offset, &type, &view, &next) && view.client == client && view.service == service)
+        {
+            slot.offset = TICKET_STORE_TOMBSTONE_SLOT;
+            --header->count;
+            ++header->tombstones;
+            return;
+        }
+    }
+}
+
+bool KRB5KerberosTicketStore::append(std::uint8_t type,
+                                     std::string_view client,
+                                     std::string_view service,
+                                     const std::chrono::time_point<std::chrono::system_clock>& expiration,
+                                     std::string_view ticket,
+                                     std::uint64_t* offset)
+{
+    std::string record;
+    record.reserve(25 + client.size() + service.size() + ticket.size());
+    KRB5KerberosByteWriter writer(&record);
+    writer.write_u32(0);
+    writer.write_u8(type);
+    writer.write_u64(std::chrono::duration_cast<std::chrono::seconds>(expiration.time_since_epoch()).count());
+    writer.write_counted(client);
+    writer.write_counted(service);
+    writer.write_counted(ticket);
+    std::string length;
+    KRB5KerberosByteWriter(&length).write_u32(record.size() - sizeof(std::uint32_t));
+    record.replace(0, length.size(), length);
+    if (!write_fully(data_fd_, record.data(), record.size(), data_size_))
+    {
+        logger_.warning().formatted("Failed appending to ticket store [{}] [{}]", path_, std::strerror(errno));
+        return false;
+    }
+    *offset = data_size_;
+    data_size_ += record.size();
+    return map_data(data_size_);
+}
+
+bool KRB5KerberosTicketStore::put(std::string_view client, std::string_view service, const KerberosTicket& ticket)
+{
+    return put(client, service, ticket.ticket_expiration_time(), ticket.serialize_binary());
+}
+
+bool KRB5KerberosTicketStore::put(std::string_view client,
+                                  std::string_view service,
+                                  const std::chrono::time_point<std::chrono::system_clock>& expiration,
+                                  std::string_view ticket)
+{
+    std::uint64_t offset;
+    if (!is_open() || !append(TICKET_STORE_RECORD_PUT, client, service, expiration, ticket, &offset)
+        || !index_insert(key_hash(client, service), offset, client, service))
+    {
+        return false;
+    }
+    index_header(index_map_)->data_size = data_size_;
+    return true;
+}
+
+bool KRB5KerberosTicketStore::find(std::string_view client,
+                                   std::string_view service,
+                                   KRB5KerberosTicketStore::View* view) const
+{
+    if (!is_open())
+    {
+        return false;
+    }
+    const auto hash = key_hash(client, service);
+    const auto header = index_header(index_map_);
+    const auto slots = index_slots(index_map_);
+    const auto mask = header->capacity - 1;
+    for (auto i = hash & mask; slots[i].offset != TICKET_STORE_EMPTY_SLOT; i = (i + 1) & mask)
+    {
+        const auto& slot = slots[i];
+        std::uint8_t type;
+        std::uint64_t next;
+        if (slot.offset != TICKET_STORE_TOMBSTONE_SLOT && slot.hash == hash
+            && read_record(slot.offset, &type, view, &next) && view->client == client && view->service == service)
+        {
+            return type == TICKET_STORE_RECORD_PUT;
+        }
+    }
+    return false;
+}
+
+bool KRB5KerberosTicketStore::erase(std::string_view client, std::string_view service)
+{
+    View view;
+    std::uint64_t offset;
+    if (!find(client, service, &view)
+        || !append(TICKET_STORE_RECORD_ERASE, client, service, view.expiration, std::string_view(), &offset))
+    {
+        return false;
+    }
+    index_erase(key_hash(client, service), client, service);
+    index_header(index_map_)->data_size = data_size_;
+    return true;
+}
+
+bool KRB5KerberosTicketStore::compact(const std::chrono::time_point<std::chrono::system_clock>& now)
+{
+    if (!is_open())
+    {
+        return false;
+    }
+    const auto compact_path = path_ + ".compact";
+    auto fd = ::open(compact_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        logger_.warning().formatted("Failed compacting ticket store [{}] [{}]", path_, std::strerror(errno));
+        return false;
+    }
+    std::string out;
+    KRB5KerberosByteWriter writer(&out);
+    writer.write_bytes(TICKET_STORE_MAGIC, sizeof(TICKET_STORE_MAGIC));
+    writer.write_u16(TICKET_STORE_VERSION);
+    off_t written = 0;
+    auto success = true;
+    const auto header = index_header(index_map_);
+    const auto slots = index_slots(index_map_);
+    for (std::uint64_t i = 0; success && i < header->capacity; ++i)
+    {
+        std::uint8_t type;
+        View view;
+        std::uint64_t next;
+        if (slots[i].offset == TICKET_STORE_EMPTY_SLOT || slots[i].offset == TICKET_STORE_TOMBSTONE_SLOT
+            || !read_record(slots[i].offset, &type, &view, &next) || view.expiration <= now)
+        {
+            continue;
+        }
+        // Records are position independent, live ones are copied as is
+        out.append(data_map_ + slots[i].offset, next - slots[i].offset);
+        if (out.size() >= TICKET_STORE_DATA_MAP_MIN_SIZE)
+        {
+            success = write_fully(fd, out.data(), out.size(), written);
+            written += out.size();
+            out.clear();
+        }
+    }
+    success = success && write_fully(fd, out.data(), out.size(), written) && fsync(fd) == 0;
+    ::close(fd);
+    // The old index points into the replaced file. It is swapped for an empty one before the data file is, which
+    // holds for both data files, so a crash at any point only costs open a replay and never leaves a stale index
+    const auto index_path = path_ + ".idx";
+    const auto index_compact_path = index_path + ".compact";
+    if (!success || !write_empty_index(index_compact_path)
+        || rename(index_compact_path.c_str(), index_path.c_str()) < 0
+        || rename(compact_path.c_str(), path_.c_str()) < 0)
+    {
+        logger_.warning().formatted("Failed compacting ticket store [{}] [{}]", path_, std::strerror(errno));
+        unlink(compact_path.c_str());
+        unlink(index_compact_path.c_str());
+        return false;
+    }
+    const auto path = path_;
+    return open(path);
+}
+
+bool KRB5KerberosTicketStore::sync()
+{
+    // Data before index, so a synced index never covers unsynced records
+    return is_open() && fdatasync(data_fd_) == 0 && msync(index_map_, index_map_size_, MS_SYNC) == 0;
+}
+
+std::size_t KRB5KerberosTicketStore::size() const
+{
+    return index_map_ ? index_header(index_map_)->count : 0;
+}
+} // namespace octo::kerberos::krb5
@@ -0,0 +1,246 @@
+/**
+ * @file krb5-kerberos-timer-wheel.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-timer-wheel.hpp"
+#include <algorithm>
+
+namespace octo::kerberos::krb5
+{
+KRB5KerberosTimerWheel::KRB5KerberosTimerWheel(KRB5KerberosTimerWheel::Callback callback,
+                                               std::chrono::milliseconds tick,
+                                               std::chrono::seconds refresh_margin)
+    : callback_(std::move(callback)),
+      tick_(std::max<std::chrono::system_clock::duration>(tick, std::chrono::milliseconds(1))),
+      refresh_margin_(refresh_margin),
+      base_(std::chrono::system_clock::now()),
+      current_tick_(0),
+      free_nodes_(NO_NODE),
+      size_(0),
+      is_running_(false)
+{
+    std::fill(std::begin(slots_), std::end(slots_), NO_NODE);
+}
+
+KRB5KerberosTimerWheel::~KRB5KerberosTimerWheel()
+{
+    stop();
+}
+
+void KRB5KerberosTimerWheel::worker_loop()
+{
+    while (is_running_)
+    {
+        advance();
+        std::chrono::time_point<std::chrono::system_clock> next_tick;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            next_tick = base_ + tick_ * (current_tick_ + 1);
+        }
+        std::unique_lock<std::mutex> lock(worker_mutex_);
+        worker_cv_.wait_for(lock, next_tick - std::chrono::system_clock::now(), [this]() { return !is_running_; });
+    }
+}
+
+void KRB5KerberosTimerWheel::link(std::uint32_t index)
+{
+    auto& node = nodes_[index];
+    // Deadlines past the last wheel are parked at its far end and placed again when their slot comes up
+    const auto expiry = std::min<std::uint64_t>(node.expiry, current_tick_ + (1ull << (SLOT_BITS * LEVELS)) - 1);
+    const auto delta = expiry - current_tick_;
+    std::size_t level = 0;
+    while (level + 1 < LEVELS && delta >= (1ull << (SLOT_BITS * (level + 1))))
+    {
+        ++level;
+    }
+    node.slot = static_cast<std::uint32_t>(level * SLOTS + ((expiry >> (SLOT_BITS * level)) & (SLOTS - 1)));
+    node.previous = NO_NODE;
+    node.next = slots_[node.slot];
+    if (node.next != NO_NODE)
+    {
+        nodes_[node.next].previous = index;
+    }
+    slots_[node.slot] = index;
+}
+
+void KRB5KerberosTimerWheel::unlink(std::uint32_t index)
+{
+    auto& node = nodes_[index];
+    if (node.previous != NO_NODE)
+    {
+        nodes_[node.previous].next = node.next;
+    }
+    else
+    {
+        slots_[node.slot] = node.next;
+    }
+    if (node.next != NO_NODE)
+    {
+        nodes_[node.next].previous = node.previous;
+    }
+}
+
+void KRB5KerberosTimerWheel::release(std::uint32_t index)
+{
+    auto& node = nodes_[index];
+    node.generation = node.generation == UINT32_MAX ? 1 : node.generation + 1;
+    node.slot = NO_NODE;
+    node.next = free_nodes_;
+    free_nodes_ = index;
+    --size_;
+}
+
+void KRB5KerberosTimerWheel::step(std::vector<Fired>* fired)
+{
+    const auto tick = ++current_tick_;
+    // Every SLOTS^level ticks the next slot of that level moves down, into the levels below or straight to firing
+    for (std::size_t level = 1; level < LEVELS; ++level)
+    {
+        if (tick & ((1ull << (SLOT_BITS * level)) - 1))
+        {
+            break;
+        }
+        const auto slot = level * SLOTS + ((tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+        auto index = slots_[slot];
+        slots_[slot] = NO_NODE;
+        while (index != NO_NODE)
+        {
+            const auto next = nodes_[index].next;
+            link(index);
+            index = next;
+        }
+    }
+    auto index = slots_[tick & (SLOTS - 1)];
+    slots_[tick & (SLOTS - 1)] = NO_NODE;
+    while (index != NO_NODE)
+    {
+        const auto& node = nodes_[index];
+        const auto next = node.next;
+        fired->push_back(Fired{(static_cast<Handle>(node.generation) << 32) | index, node.data});
+        release(index);
+        index = next;
+    }
+}
+
+void KRB5KerberosTimerWheel::start()
+{
+    if (is_running_.exchange(true))
+    {
+        return;
+    }
+    worker_thread_ = std::thread(&KRB5KerberosTimerWheel::worker_loop, this);
+}
+
+void KRB5KerberosTimerWheel::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        if (!is_running_.exchange(false))
+        {
+            return;
+        }
+    }
+    worker_cv_.notify_all();
+    if (worker_thread_.joinable())
+    {
+        worker_thread_.join();
+    }
+}
+
+bool KRB5KerberosTimerWheel::is_running() const
+{
+    return is_running_;
+}
+
+KRB5KerberosTimerWheel::Handle KRB5KerberosTimerWheel::schedule(
+    const std::chrono::time_point<std::chrono::system_clock>& deadline, std::uint64_t data)
+{
+    // Rounded up, a timer never fires before its deadline
+    std::uint64_t expiry = 0;
+    if (deadline > base_)
+    {
+        const auto delay = deadline - base_;
+        expiry = static_cast<std::uint64_t>(delay / tick_);
+        if (delay % tick_ != std::chrono::system_clock::duration::zero())
+        {
+            ++expiry;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::uint32_t index;
+    if (free_nodes_ != NO_NODE)
+    {
+        index = free_nodes_;
+        free_nodes_ = nodes_[index].next;
+    }
+    else
+    {
+        index = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.push_back(Node{0, 0, NO_NODE, NO_NODE, 1, NO_NODE});
+    }
+    auto& node = nodes_[index];
+    node.expiry = std::max(expiry, current_tick_ + 1);
+    node.data = data;
+    link(index);
+    ++size_;
+    return (static_cast<Handle>(node.generation) << 32) | index;
+}
+
+KRB5KerberosTimerWheel::Handle KRB5KerberosTimerWheel::schedule_refresh(const KerberosTicket& ticket,
+                                                                         std::uint64_t data)
+{
+    return schedule(ticket.ticket_expiration_time() - refresh_margin_, data);
+}
+
+bool KRB5KerberosTimerWheel::cancel(KRB5KerberosTimerWheel::Handle handle)
+{
+    const auto index = static_cast<std::uint32_t>(handle);
+    const auto generation = static_cast<std::uint32_t>(handle >> 32);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= nodes_.size() || nodes_[index].generation != generation || nodes_[index].slot == NO_NODE)
+    {
+        return false;
+    }
+    unlink(index);
+    release(index);
+    return true;
+}
+
+std::size_t KRB5KerberosTimerWheel::advance(const std::chrono::time_point<std::chrono::system_clock>& now)
+{
+    std::lock_guard<std::mutex> advance_lock(advance_mutex_);
+    std::vector<Fired> fired;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto target = now > base_ ? static_cast<std::uint64_t>((now - base_) / tick_) : 0;
+        while (current_tick_ < target)
+        {
+            step(&fired);
+        }
+    }
+    for (const auto& timer : fired)
+    {
+        callback_(timer.handle, timer.data);
+    }
+    return fired.size();
+}
+
+std::size_t KRB5KerberosTimerWheel::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+}
+
+std::chrono::seconds KRB5KerberosTimerWheel::refresh_margin() const
+{
+    return refresh_margin_;
+}
+} // namespace octo::kerberos::krb5
@@ -0,0 +1,414 @@
+/**
+ * @file krb5-kerberos-trace.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-kerberos-cpp/krb5/krb5-kerberos-trace.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace
+{
+bool starts_with(std::string_view str, std::string_view prefix)
+{
+    return str.size() >= prefix.size() && str.compare(0, prefix.size(), prefix) == 0;
+}
+
+template <std::size_t N>
+bool starts_with_any(std::string_view str, const std::string_view (&prefixes)[N])
+{
+    return std::any_of(std::begin(prefixes), std::end(prefixes),
+                       [str](std::string_view prefix) { return starts_with(str, prefix); });
+}
+
+bool parse_digits(std::string_view str, std::size_t* pos, std::int64_t* value)
+{
+    const auto start = *pos;
+    *value = 0;
+    for (; *pos < str.size() && str[*pos] >= '0' && str[*pos] <= '9'; ++*pos)
+    {
+        *value = *value * 10 + (str[*pos] - '0');
+    }
+    return *pos != start;
+}
+
+// libkrb5 formats every message as "[pid] sec.usec: message\n", returns the bare message and the time it carries
+std::string_view strip_trace_prefix(std::string_view message,
+                                    std::chrono::time_point<std::chrono::system_clock>* timestamp)
+{
+    while (!message.empty() && (message.back() == '\n' || message.back() == '\r'))
+    {
+        message.remove_suffix(1);
+    }
+
+    std::size_t pos = 1;
+    std::int64_t pid = 0;
+    std::int64_t seconds = 0;
+    std::int64_t microseconds = 0;
+    const auto expect = [message, &pos](std::string_view literal)
+    {
+        if (!starts_with(message.substr(std::min(pos, message.size())), literal))
+        {
+            return false;
+        }
+        pos += literal.size();
+        return true;
+    };
+    if (!starts_with(message, "[") || !parse_digits(message, &pos, &pid) || !expect("] ")
+        || !parse_digits(message, &pos, &seconds) || !expect(".") || !parse_digits(message, &pos, &microseconds)
+        || !expect(": "))
+    {
+        return message;
+    }
+
+    *timestamp = std::chrono::time_point<std::chrono::system_clock>(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::seconds(seconds)
+                                                                         + std::chrono::microseconds(microseconds)));
+    return message.substr(pos);
+}
+
+std::int64_t parse_integer_after(std::string_view str, std::string_view marker)
+{
+    auto pos = str.find(marker);
+    if (pos == std::string_view::npos)
+    {
+        return 0;
+    }
+    pos += marker.size();
+    bool negative = false;
+    if (pos < str.size() && str[pos] == '-')
+    {
+        negative = true;
+        ++pos;
+    }
+    std::int64_t value = 0;
+    for (; pos < str.size() && str[pos] >= '0' && str[pos] <= '9'; ++pos)
+    {
+        value = value * 10 + (str[pos] - '0');
+    }
+    return negative ? -value : value;
+}
+
+std::size_t round_up_power_of_two(std::size_t value)
+{
+    std::size_t result = 2;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+} // namespace
+
+namespace octo::kerberos::krb5
+{
+std::string_view KRB5KerberosTraceEvent::message_view() const
+{
+    return {message, length};
+}
+
+std::string_view KRB5KerberosTraceEvent::type_name(KRB5KerberosTraceEvent::Type type)
+{
+    switch (type)
+    {
+        case Type::Other:
+            return "Other";
+        case Type::KdcSelection:
+            return "KdcSelection";
+        case Type::KdcRequest:
+            return "KdcRequest";
+        case Type::KdcResponse:
+            return "KdcResponse";
+        case Type::KdcError:
+            return "KdcError";
+        case Type::PreauthTypes:
+            return "PreauthTypes";
+        case Type::Preauth:
+            return "Preauth";
+        case Type::Retry:
+            return "Retry";
+        case Type::EnctypeSelection:
+            return "EnctypeSelection";
+        case Type::Referral:
+            return "Referral";
+    }
+    return "Other";
+}
+
+KRB5KerberosTraceRing::KRB5KerberosTraceRing(std::size_t capacity)
+    : slots_(new Slot[round_up_power_of_two(capacity)]),
+      mask_(round_up_power_of_two(capacity) - 1),
+      head_(0),
+      tail_(0),
+      dropped_(0)
+{
+    for (std::size_t i = 0; i <= mask_; ++i)
+    {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool KRB5KerberosTraceRing::try_push(const KRB5KerberosTraceEvent& event)
+{
+    auto pos = head_.load(std::memory_order_relaxed);
+    while (true)
+    {
+        auto& slot = slots_[pos & mask_];
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                slot.event = event;
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool KRB5KerberosTraceRing::try_pop(KRB5KerberosTraceEvent* event)
+{
+    const auto pos = tail_.load(std::memory_order_relaxed);
+    auto& slot = slots_[pos & mask_];
+    const auto sequence = slot.sequence.load(std::memory_order_acquire);
+    if (static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1) < 0)
+    {
+        return false;
+    }
+    *event = slot.event;
+    slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+    tail_.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+std::size_t KRB5KerberosTraceRing::capacity() const
+{
+    return mask_ + 1;
+}
+
+std::uint64_t KRB5KerberosTraceRing::dropped() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+KRB5KerberosTracer::KRB5KerberosTracer(KRB5KerberosTracer::Sink sink,
+                                       std::size_t capacity,
+                                       std::chrono::milliseconds drain_interval)
+    : sink_(std::move(sink)), ring_(capacity), drain_interval_(drain_interval), is_running_(false), attached_(0)
+{
+}
+
+KRB5KerberosTracer::~KRB5KerberosTracer()
+{
+    stop();
+}
+
+void KRB5KerberosTracer::drain_loop()
+{
+    while (is_running_)
+    {
+        drain();
+        std::unique_lock<std::mutex> lock(drain_mutex_);
+        drain_cv_.wait_for(lock, drain_interval_, [this]() { return !is_running_; });
+    }
+    drain();
+}
+
+void KRB5KerberosTracer::start()
+{
+    if (is_running_.exchange(true))
+    {
+        return;
+    }
+    drain_thread_ = std::thread(&KRB5KerberosTracer::drain_loop, this);
+}
+
+void KRB5KerberosTracer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+        if (!is_running_.exchange(false))
+        {
+            return;
+        }
+    }
+    drain_cv_.notify_all();
+    if (drain_thread_.joinable())
+    {
+        drain_thread_.join();
+    }
+}
+
+bool KRB5KerberosTracer::is_running() const
+{
+    return is_running_;
+}
+
+void KRB5KerberosTracer::attach()
+{
+    std::lock_guard<std::mutex> lock(attach_mutex_);
+    if (attached_++ == 0)
+    {
+        start();
+    }
+}
+
+void KRB5KerberosTracer::detach()
+{
+    std::lock_guard<std::mutex> lock(attach_mutex_);
+    if (attached_ == 0)
+    {
+        return;
+    }
+    (void)flush();
+    if (--attached_ == 0)
+    {
+        // The drain thread delivers whatever is left before exiting
+        stop();
+    }
+}
+
+void KRB5KerberosTracer::trace(std::string_view message)
+{
+    // Failing to push only bumps the dropped counter, tracing must never stall the kerberos exchange
+    (void)ring_.try_push(parse_trace_message(message));
+}
+
+std::size_t KRB5KerberosTracer::drain()
+{
+    std::lock_guard<std::mutex> lock(sink_mutex_);
+    KRB5KerberosTraceEvent event;
+    std::size_t drained = 0;
+    while (ring_.try_pop(&event))
+    {
+        if (sink_)
+        {
+            sink_(event);
+        }
+        ++drained;
+    }
+    return drained;
+}
+
+std::size_t KRB5KerberosTracer::flush()
+{
+    return drain();
+}
+
+std::uint64_t KRB5KerberosTracer::dropped_events() const
+{
+    return ring_.dropped();
+}
+
+KRB5KerberosTraceEvent KRB5KerberosTracer::parse_trace_message(std::string_view message)
+{
+    using Type = KRB5KerberosTraceEvent::Type;
+    // Exact libkrb5 (k5-trace.h) message prefixes, anything else is reported as Other
+    static constexpr std::string_view KDC_SELECTION_PREFIXES[] = {
+        "Resolving hostname ",          "Initiating TCP connection to ", "Sending initial UDP request to ",
+        "Sending TCP request to ",      "Sending HTTPS request to ",     "Sending DNS SRV query for ",
+        "Sending DNS URI query for "};
+    static constexpr std::string_view ENCTYPE_SELECTION_PREFIXES[] = {
+        "Selected etype info: ", "Decrypted AS reply; session key is: ", "TGS reply is for "};
+    static constexpr std::string_view RETRY_PREFIXES[] = {"Retrying AS request with primary KDC",
+                                                          "Retrying TGS request with desired service ticket enctypes",
+                                                          "Request or response is too big for UDP; retrying with TCP",
+                                                          "Sending retry UDP request to ",
+                                                          "Preauth tryagain input types "};
+    static constexpr std::string_view REFERRAL_PREFIXES[] = {"Following referral TGT ",
+                                                             "Following referral to realm ",
+                                                             "Server has referral realm; starting with ",
+                                                             "Local realm referral failed; trying fallback realm ",
+                                                             "Received non-TGT referral response ",
+                                                             "Received TGT referral back to same realm "};
+    static constexpr std::string_view PREAUTH_PREFIXES[] = {"Preauth module ",
+                                                            "Preauthenticating using KDC method data",
+                                                            "Produced preauth for next request: ",
+                                                            "Continuing preauth mech ",
+                                                            "Sending unauthenticated request",
+                                                            "Attempting optimistic preauth"};
+
+    KRB5KerberosTraceEvent event;
+    event.timestamp = std::chrono::system_clock::now();
+    message = strip_trace_prefix(message, &event.timestamp);
+    event.length = static_cast<std::uint16_t>(std::min<std::size_t>(message.size(), KERBEROS_TRACE_MESSAGE_MAX_LENGTH));
+    std::memcpy(event.message, message.data(), event.length);
+    event.message[event.length] = '\0';
+
+    if (starts_with(message, "Sending request ("))
+    {
+        event.type = Type::KdcRequest;
+        event.value = parse_integer_after(message, "(");
+    }
+    else if (starts_with(message, "Received answer ("))
+    {
+        event.type = Type::KdcResponse;
+        event.value = parse_integer_after(message, "(");
+    }
+    else if (starts_with(message, "Received error from KDC: "))
+    {
+        event.type = Type::KdcError;
+        event.value = parse_integer_after(message, "KDC: ");
+    }
+    else if (starts_with(message, "TGS request result: "))
+    {
+        // Logged for every tgs reply, only a non zero code is an error
+        event.value = parse_integer_after(message, "result: ");
+        event.type = event.value != 0 ? Type::KdcError : Type::Other;
+    }
+    else if (starts_with_any(message, KDC_SELECTION_PREFIXES))
+    {
+        event.type = Type::KdcSelection;
+    }
+    else if (starts_with(message, "Processing preauth types: "))
+    {
+        event.type = Type::PreauthTypes;
+        event.value = 1 + std::count(message.begin(), message.end(), ',');
+    }
+    else if (starts_with_any(message, ENCTYPE_SELECTION_PREFIXES))
+    {
+        event.type = Type::EnctypeSelection;
+    }
+    else if (starts_with_any(message, RETRY_PREFIXES))
+    {
+        event.type = Type::Retry;
+    }
+    else if (starts_with_any(message, REFERRAL_PREFIXES))
+    {
+        event.type = Type::Referral;
+    }
+    else if (starts_with_any(message, PREAUTH_PREFIXES))
+    {
+        event.type = Type::Preauth;
+    }
+    return event;
+}
+
+void KRB5KerberosTracer::krb5_trace_callback(krb5_context ctx, const krb5_trace_info* info, void* cb_data)
+{
+    // libkrb5 invokes the callback with a null info when the callback is being replaced or the context is freed
+    if (!info || !info->message || !cb_data)
+    {
+        return;
+    }
+    static_cast<KRB5KerberosTracer*>(cb_data)->trace(info->message);
+}
+} // namespace octo::kerberos::krb5
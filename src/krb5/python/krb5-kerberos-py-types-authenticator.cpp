@@ -110,10 +110,10 @@ extern "C"
             return nullptr;
         }
         auto creds = reinterpret_cast<KRB5UserCredentials*>(py_creds);
-        auto tgt = self->krb5_authenticator_->generate_tgt(creds->krb5_user_creds_,
-                                                           ticket_lifetime > 0
-                                                               ? std::chrono::seconds(ticket_lifetime)
-                                                               : std::chrono::seconds(DEFAULT_TGT_LIFETIME_SECONDS));
+        auto tgt = self->krb5_authenticator_->generate_krb5_tgt(
+            creds->krb5_user_creds_,
+            ticket_lifetime > 0 ? std::chrono::seconds(ticket_lifetime)
+                                : std::chrono::seconds(DEFAULT_TGT_LIFETIME_SECONDS));
         if (!tgt)
         {
             PyErr_SetString(PyExc_RuntimeError, "Failed to generate tgt");
@@ -125,7 +125,7 @@ extern "C"
             PyErr_SetString(PyExc_RuntimeError, "Failed to allocate tgt");
             return nullptr;
         }
-        py_tgt->krb5_tgt_ticket_ = dynamic_cast<KRB5KerberosTGTTicket*>(tgt.release());
+        py_tgt->krb5_tgt_ticket_ = tgt.release();
         return reinterpret_cast<PyObject*>(py_tgt);
     }
 
@@ -143,7 +143,59 @@ extern "C"
             PyErr_SetString(PyExc_RuntimeError, "Input dict cannot be empty");
             return nullptr;
         }
-        auto tgt = self->krb5_authenticator_->deserialize_tgt(deserialize_py_json(py_dict));
+        auto tgt = self->krb5_authenticator_->deserialize_krb5_tgt(deserialize_py_json(py_dict));
+        if (!tgt)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to deserialize tgt");
+            return nullptr;
+        }
+        auto py_tgt = PyObject_New(KRB5TGTTicket, &KRB5TGTTicketType);
+        if (!py_tgt)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to allocate tgt");
+            return nullptr;
+        }
+        py_tgt->krb5_tgt_ticket_ = tgt.release();
+        return reinterpret_cast<PyObject*>(py_tgt);
+    }
+
+    static PyObject* KRB5AuthenticatorDeserializeTGTBinary(KRB5Authenticator* self, PyObject* args)
+    {
+        METHOD_LOG_TRACE_GLOBAL
+        const char* data = nullptr;
+        Py_ssize_t data_size = 0;
+
+        if (!PyArg_ParseTuple(args, "y#", &data, &data_size))
+        {
+            return nullptr;
+        }
+        auto tgt = self->krb5_authenticator_->deserialize_krb5_tgt_binary(std::string_view(data, data_size));
+        if (!tgt)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to deserialize tgt");
+            return nullptr;
+        }
+        auto py_tgt = PyObject_New(KRB5TGTTicket, &KRB5TGTTicketType);
+        if (!py_tgt)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to allocate tgt");
+            return nullptr;
+        }
+        py_tgt->krb5_tgt_ticket_ = tgt.release();
+        return reinterpret_cast<PyObject*>(py_tgt);
+    }
+
+    static PyObject* KRB5AuthenticatorDeserializeTGTText(KRB5Authenticator* self, PyObject* args)
+    {
+        METHOD_LOG_TRACE_GLOBAL
+        const char* data = nullptr;
+        Py_ssize_t data_size = 0;
+
+        if (!PyArg_ParseTuple(args, "s#", &data, &data_size))
+        {
+            return nullptr;
+        }
+        auto tgt = self->krb5_authenticator_->deserialize_krb5_tgt_text(std::string_view(data, data_size));
         if (!tgt)
         {
             PyErr_SetString(PyExc_RuntimeError, "Failed to deserialize tgt");
@@ -155,7 +207,7 @@ extern "C"
             PyErr_SetString(PyExc_RuntimeError, "Failed to allocate tgt");
             return nullptr;
         }
-        py_tgt->krb5_tgt_ticket_ = dynamic_cast<KRB5KerberosTGTTicket*>(tgt.release());
+        py_tgt->krb5_tgt_ticket_ = tgt.release();
         return reinterpret_cast<PyObject*>(py_tgt);
     }
 
@@ -192,7 +244,7 @@ extern "C"
             PyErr_SetString(PyExc_RuntimeError, "Failed to allocate service ticket");
             return nullptr;
         }
-        py_service_ticket->krb5_service_ticket_ = dynamic_cast<KRB5KerberosServiceTicket*>(service_ticket.release());
+        py_service_ticket->krb5_service_ticket_ = service_ticket.release();
         return reinterpret_cast<PyObject*>(py_service_ticket);
     }
 
@@ -210,7 +262,7 @@ extern "C"
             PyErr_SetString(PyExc_RuntimeError, "Input dict cannot be empty");
             return nullptr;
         }
-        auto service_ticket = self->krb5_authenticator_->deserialize_service_ticket(deserialize_py_json(py_dict));
+        auto service_ticket = self->krb5_authenticator_->deserialize_krb5_service_ticket(deserialize_py_json(py_dict));
         if (!service_ticket)
         {
             PyErr_SetString(PyExc_RuntimeError, "Failed to deserialize service ticket");
@@ -222,10 +274,160 @@ extern "C"
             PyErr_SetString(PyExc_RuntimeError, "Failed to allocate service ticket");
             return nullptr;
         }
-        py_service_ticket->krb5_service_ticket_ = dynamic_cast<KRB5KerberosServiceTicket*>(service_ticket.release());
+        py_service_ticket->krb5_service_ticket_ = service_ticket.release();
         return reinterpret_cast<PyObject*>(py_service_ticket);
     }
 
+    static PyObject* KRB5AuthenticatorDeserializeServiceTicketBinary(KRB5Authenticator* self, PyObject* args)
+    {
+        METHOD_LOG_TRACE_GLOBAL
+        const char* data = nullptr;
+        Py_ssize_t data_size = 0;
+
+        if (!PyArg_ParseTuple(args, "y#", &data, &data_size))
+        {
+            return nullptr;
+        }
+        auto service_ticket =
+            self->krb5_authenticator_->deserialize_krb5_service_ticket_binary(std::string_view(data, data_size));
+        if (!service_ticket)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to deserialize service ticket");
+            return nullptr;
+        }
+        auto py_service_ticket = PyObject_New(KRB5ServiceTicket, &KRB5ServiceTicketType);
+        if (!py_service_ticket)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to allocate service ticket");
+            return nullptr;
+        }
+        py_service_ticket->krb5_service_ticket_ = service_ticket.release();
+        return reinterpret_cast<PyObject*>(py_service_ticket);
+    }
+
+    static PyObject* KRB5AuthenticatorDeserializeServiceTicketText(KRB5Authenticator* self, PyObject* args)
+    {
+        METHOD_LOG_TRACE_GLOBAL
+        const char* data = nullptr;
+        Py_ssize_t data_size = 0;
+
+        if (!PyArg_ParseTuple(args, "s#", &data, &data_size))
+        {
+            return nullptr;
+        }
+        auto service_ticket =
+            self->krb5_authenticator_->deserialize_krb5_service_ticket_text(std::string_view(data, data_size));
+        if (!service_ticket)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to deserialize service ticket");
+            return nullptr;
+        }
+        auto py_service_ticket = PyObject_New(KRB5ServiceTicket, &KRB5ServiceTicketType);
+        if (!py_service_ticket)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to allocate service ticket");
+            return nullptr;
+        }
+        py_service_ticket->krb5_service_ticket_ = service_ticket.release();
+        return reinterpret_cast<PyObject*>(py_service_ticket);
+    }
+
+    static PyObject* KRB5AuthenticatorImportCCache(KRB5Authenticator* self, PyObject* args)
+    {
+        METHOD_LOG_TRACE_GLOBAL
+        const char* data = nullptr;
+        Py_ssize_t data_size = 0;
+
+        if (!PyArg_ParseTuple(args, "y#", &data, &data_size))
+        {
+            return nullptr;
+        }
+        std::vector<KerberosTicketUniquePtr> tickets;
+        if (!self->krb5_authenticator_->import_ccache(std::string_view(data, data_size), &tickets))
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to import ccache");
+            return nullptr;
+        }
+        auto py_tickets = PyList_New(0);
+        if (!py_tickets)
+        {
+            return nullptr;
+        }
+        for (auto& ticket : tickets)
+        {
+            PyObject* py_ticket = nullptr;
+            if (ticket->ticket_type() == KerberosTicket::Type::TicketGrantingTicket)
+            {
+                auto py_tgt = PyObject_New(KRB5TGTTicket, &KRB5TGTTicketType);
+                if (py_tgt)
+                {
+                    py_tgt->krb5_tgt_ticket_ = static_cast<KRB5KerberosTGTTicket*>(ticket.release());
+                }
+                py_ticket = reinterpret_cast<PyObject*>(py_tgt);
+            }
+            else
+            {
+                auto py_service_ticket = PyObject_New(KRB5ServiceTicket, &KRB5ServiceTicketType);
+                if (py_service_ticket)
+                {
+                    py_service_ticket->krb5_service_ticket_ =
+                        static_cast<KRB5KerberosServiceTicket*>(ticket.release());
+                }
+                py_ticket = reinterpret_cast<PyObject*>(py_service_ticket);
+            }
+            if (!py_ticket || PyList_Append(py_tickets, py_ticket) < 0)
+            {
+                Py_XDECREF(py_ticket);
+                Py_DECREF(py_tickets);
+                PyErr_SetString(PyExc_RuntimeError, "Failed to allocate ticket");
+                return nullptr;
+            }
+            Py_DECREF(py_ticket);
+        }
+        return py_tickets;
+    }
+
+    static PyObject* KRB5AuthenticatorExportCCache(KRB5Authenticator* self, PyObject* args)
+    {
+        METHOD_LOG_TRACE_GLOBAL
+        PyObject* py_tickets = nullptr;
+
+        if (!PyArg_ParseTuple(args, "O", &py_tickets))
+        {
+            return nullptr;
+        }
+        if (!py_tickets || !PyList_Check(py_tickets))
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Input tickets must be a list");
+            return nullptr;
+        }
+        std::vector<const KerberosTicket*> tickets;
+        for (Py_ssize_t i = 0; i < PyList_Size(py_tickets); ++i)
+        {
+            auto py_ticket = PyList_GetItem(py_tickets, i);
+            if (py_ticket->ob_type == &KRB5TGTTicketType)
+            {
+                tickets.push_back(reinterpret_cast<KRB5TGTTicket*>(py_ticket)->krb5_tgt_ticket_);
+            }
+            else if (py_ticket->ob_type == &KRB5ServiceTicketType)
+            {
+                tickets.push_back(reinterpret_cast<KRB5ServiceTicket*>(py_ticket)->krb5_service_ticket_);
+            }
+            else
+            {
+                PyErr_SetString(PyExc_RuntimeError, "Input tickets must be tgt or service tickets");
+                return nullptr;
+            }
+        }
+        std::string data;
+        if (!self->krb5_authenticator_->export_ccache(tickets, &data))
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to export ccache");
+            return nullptr;
+        }
+        return Py_BuildValue("y#", data.data(), data.size());
+    }
+
     // Definitions
     static PyMemberDef krb5_authenticator_members[] = {
         {nullptr, 0, 0, 0, nullptr}, /* Sentinel */
@@ -256,6 +458,14 @@ extern "C"
          PY_C_FUNC(KRB5AuthenticatorDeserializeTGT),
          METH_VARARGS,
          "Deserializes a TGT for given json contexted to the authenticator."},
+        {"deserialize_tgt_binary",
+         PY_C_FUNC(KRB5AuthenticatorDeserializeTGTBinary),
+         METH_VARARGS,
+         "Deserializes a TGT for given binary bytes contexted to the authenticator."},
+        {"deserialize_tgt_text",
+         PY_C_FUNC(KRB5AuthenticatorDeserializeTGTText),
+         METH_VARARGS,
+         "Deserializes a TGT for given json text contexted to the authenticator."},
         {"generate_service_ticket",
          PY_C_FUNC(KRB5AuthenticatorGenerateServiceTicket),
          METH_VARARGS,
@@ -264,6 +474,22 @@ extern "C"
          PY_C_FUNC(KRB5AuthenticatorDeserializeServiceTicket),
          METH_VARARGS,
          "Deserializes a service ticket for given json contexted to the authenticator."},
+        {"deserialize_service_ticket_binary",
+         PY_C_FUNC(KRB5AuthenticatorDeserializeServiceTicketBinary),
+         METH_VARARGS,
+         "Deserializes a service ticket for given binary bytes contexted to the authenticator."},
+        {"deserialize_service_ticket_text",
+         PY_C_FUNC(KRB5AuthenticatorDeserializeServiceTicketText),
+         METH_VARARGS,
+         "Deserializes a service ticket for given json text contexted to the authenticator."},
+        {"import_ccache",
+         PY_C_FUNC(KRB5AuthenticatorImportCCache),
+         METH_VARARGS,
+         "Imports the tickets of a MIT ccache (FILE:) file contents contexted to the authenticator."},
+        {"export_ccache",
+         PY_C_FUNC(KRB5AuthenticatorExportCCache),
+         METH_VARARGS,
+         "Exports the given tickets as MIT ccache (FILE:) file contents."},
         {nullptr, nullptr, 0, nullptr}, /* Sentinel */
     };
 
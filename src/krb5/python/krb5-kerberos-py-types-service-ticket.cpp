@@ -54,14 +54,15 @@ extern "C"
     static PyObject* KRB5ServiceTicketTicket(KRB5ServiceTicket* self)
     {
         // METHOD_LOG_TRACE_GLOBAL //
-        auto ticket = self->krb5_service_ticket_->ticket();
-        return Py_BuildValue("s#", ticket.get().data(), ticket.get().size());
+        const auto ticket = self->krb5_service_ticket_->ticket_view();
+        return Py_BuildValue("y#", ticket.data(), ticket.size());
     }
 
     static PyObject* KRB5ServiceTicketEncodedTicket(KRB5ServiceTicket* self)
     {
         // METHOD_LOG_TRACE_GLOBAL //
-        return Py_BuildValue("s", self->krb5_service_ticket_->encoded_ticket().get().data());
+        const auto encoded_ticket = self->krb5_service_ticket_->encoded_ticket_view();
+        return Py_BuildValue("s#", encoded_ticket.data(), encoded_ticket.size());
     }
 
     static PyObject* KRB5ServiceTicketTicketPurpose(KRB5ServiceTicket* self)
@@ -114,6 +115,40 @@ extern "C"
         return self->krb5_service_ticket_->deserialize(deserialize_py_json(py_dict)) ? Py_True : Py_False;
     }
 
+    static PyObject* KRB5ServiceTicketSerializeBinary(KRB5ServiceTicket* self)
+    {
+        METHOD_LOG_TRACE_GLOBAL
+        const auto serialized = self->krb5_service_ticket_->serialize_binary();
+        return Py_BuildValue("y#", serialized.data(), serialized.size());
+    }
+
+    static PyObject* KRB5ServiceTicketDeserializeBinary(KRB5ServiceTicket* self, PyObject* args)
+    {
+        METHOD_LOG_TRACE_GLOBAL
+        const char* data = nullptr;
+        Py_ssize_t data_size = 0;
+
+        if (!PyArg_ParseTuple(args, "y#", &data, &data_size))
+        {
+            return nullptr;
+        }
+        return self->krb5_service_ticket_->deserialize_binary(std::string_view(data, data_size)) ? Py_True : Py_False;
+    }
+
+    static PyObject* KRB5ServiceTicketCopy(KRB5ServiceTicket* self)
+    {
+        METHOD_LOG_TRACE_GLOBAL
+        auto py_ticket = PyObject_New(KRB5ServiceTicket, &KRB5ServiceTicketType);
+        if (!py_ticket)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to allocate service ticket");
+            return nullptr;
+        }
+        // Shares the creds of the copied ticket instead of duplicating them
+        py_ticket->krb5_service_ticket_ = new KRB5KerberosServiceTicket(*self->krb5_service_ticket_);
+        return reinterpret_cast<PyObject*>(py_ticket);
+    }
+
     // Definitions
     static PyMemberDef krb5_service_ticket_members[] = {
         {nullptr, 0, 0, 0, nullptr}, /* Sentinel */
@@ -140,6 +175,18 @@ extern "C"
          PY_C_FUNC(KRB5ServiceTicketDeserialize),
          METH_VARARGS,
          "Deserializes the service ticket object from dict."},
+        {"serialize_binary",
+         PY_C_FUNC(KRB5ServiceTicketSerializeBinary),
+         METH_NOARGS,
+         "Serializes the service ticket object to compact binary bytes."},
+        {"deserialize_binary",
+         PY_C_FUNC(KRB5ServiceTicketDeserializeBinary),
+         METH_VARARGS,
+         "Deserializes the service ticket object from compact binary bytes."},
+        {"__copy__",
+         PY_C_FUNC(KRB5ServiceTicketCopy),
+         METH_NOARGS,
+         "Copies the service ticket object, sharing its creds."},
         {nullptr, nullptr, 0, nullptr}, /* Sentinel */
     };
 
@@ -55,14 +55,15 @@ extern "C"
     static PyObject* KRB5TGTTicketTicket(KRB5TGTTicket* self)
     {
         // METHOD_LOG_TRACE_GLOBAL //
-        auto ticket = self->krb5_tgt_ticket_->ticket();
-        return Py_BuildValue("s#", ticket.get().data(), ticket.get().size());
+        const auto ticket = self->krb5_tgt_ticket_->ticket_view();
+        return Py_BuildValue("y#", ticket.data(), ticket.size());
     }
 
     static PyObject* KRB5TGTTicketEncodedTicket(KRB5TGTTicket* self)
     {
         // METHOD_LOG_TRACE_GLOBAL //
-        return Py_BuildValue("s", self->krb5_tgt_ticket_->encoded_ticket().get().data());
+        const auto encoded_ticket = self->krb5_tgt_ticket_->encoded_ticket_view();
+        return Py_BuildValue("s#", encoded_ticket.data(), encoded_ticket.size());
     }
 
     static PyObject* KRB5TGTTicketTicketPurpose(KRB5TGTTicket* self)
@@ -115,6 +116,40 @@ extern "C"
         return self->krb5_tgt_ticket_->deserialize(deserialize_py_json(py_dict)) ? Py_True : Py_False;
     }
 
+    static PyObject* KRB5TGTTicketSerializeBinary(KRB5TGTTicket* self)
+    {
+        METHOD_LOG_TRACE_GLOBAL
+        const auto serialized = self->krb5_tgt_ticket_->serialize_binary();
+        return Py_BuildValue("y#", serialized.data(), serialized.size());
+    }
+
+    static PyObject* KRB5TGTTicketDeserializeBinary(KRB5TGTTicket* self, PyObject* args)
+    {
+        METHOD_LOG_TRACE_GLOBAL
+        const char* data = nullptr;
+        Py_ssize_t data_size = 0;
+
+        if (!PyArg_ParseTuple(args, "y#", &data, &data_size))
+        {
+            return nullptr;
+        }
+        return self->krb5_tgt_ticket_->deserialize_binary(std::string_view(data, data_size)) ? Py_True : Py_False;
+    }
+
+    static PyObject* KRB5TGTTicketCopy(KRB5TGTTicket* self)
+    {
+        METHOD_LOG_TRACE_GLOBAL
+        auto py_ticket = PyObject_New(KRB5TGTTicket, &KRB5TGTTicketType);
+        if (!py_ticket)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to allocate tgt");
+            return nullptr;
+        }
+        // Shares the creds of the copied ticket instead of duplicating them
+        py_ticket->krb5_tgt_ticket_ = new KRB5KerberosTGTTicket(*self->krb5_tgt_ticket_);
+        return reinterpret_cast<PyObject*>(py_ticket);
+    }
+
     // Definitions
     static PyMemberDef krb5_tgt_ticket_members[] = {
         {nullptr, 0, 0, 0, nullptr}, /* Sentinel */
@@ -135,6 +170,15 @@ extern "C"
         {"tgt_user", PY_C_FUNC(KRB5TGTTicketTgtUser), METH_NOARGS, "Getter for the tgt user."},
         {"serialize", PY_C_FUNC(KRB5TGTTicketSerialize), METH_NOARGS, "Serializes the tgt object to dict."},
         {"deserialize", PY_C_FUNC(KRB5TGTTicketDeserialize), METH_VARARGS, "Deserializes the tgt object from dict."},
+        {"serialize_binary",
+         PY_C_FUNC(KRB5TGTTicketSerializeBinary),
+         METH_NOARGS,
+         "Serializes the tgt object to compact binary bytes."},
+        {"deserialize_binary",
+         PY_C_FUNC(KRB5TGTTicketDeserializeBinary),
+         METH_VARARGS,
+         "Deserializes the tgt object from compact binary bytes."},
+        {"__copy__", PY_C_FUNC(KRB5TGTTicketCopy), METH_NOARGS, "Copies the tgt object, sharing its creds."},
         {nullptr, nullptr, 0, nullptr}, /* Sentinel */
     };
 